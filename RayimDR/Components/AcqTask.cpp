@@ -7,16 +7,25 @@
 #include <qdatetime.h>
 #include <qelapsedtimer.h>
 #include <qrandom.h>
+#include <qthreadpool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 #include "AcqTaskManager.h"
+#include "XTileExecutor.h"
 #include "ImageRender/XImageHelper.h"
+#include "ImageRender/XFlatFieldCorrector.h"
+#include "ImageRender/XFramePool.h"
 
 #include "IRayDetector/NDT1717MA.h"
 #include "IRayDetector/TiffHelper.h"
+#include "VJXRAY/IXS120BP120P366.h"
 
 AcqTask::AcqTask(AcqCondition acqCond, QObject* parent) : QThread(parent), acqCondition(acqCond)
 {
-    qDebug() << "[构造] 创建采集任务对象 - 采集模式:" << (acqCond.acqType == AcqType::DR ? "DR" : "其他")
+    qDebug() << "[构造] 创建采集任务对象 - 采集模式:" << (acqCond.acqType == AcqType::DR ? "DR" : "CT")
              << ", 帧数:" << acqCond.frame << ", 帧率:" << acqCond.frameRate << "fps";
 }
 
@@ -25,6 +34,12 @@ AcqTask::~AcqTask()
     qDebug() << "[析构] 采集任务清理开始...";
     // 只断开与 AcqTask 相关的连接，避免影响其他组件（如 CommonConfigUI）的信号连接
     disconnect(&DET, nullptr, this, nullptr);
+    // 未叠加的配准任务仍引用本对象
+    registrationReference.waitForFinished();
+    for (auto& future : registeredFrames)
+        future.waitForFinished();
+    for (auto& future : hdrStacks)
+        future.waitForFinished();
     AcqTaskManager::Instance().stackedImageList.clear();
 }
 
@@ -44,41 +59,10 @@ QImage AcqTask::applyImageTransform(const QImage& image)
              << ", 垂直翻转：" << (xGlobal.getBool("SYSTEM", "FLIP_VERTICAL") ? "是" : "否") << ", 旋转角度："
              << xGlobal.getInt("SYSTEM", "IMG_ROTATE") << ", 图象格式：" << originalFormat;
 
-    QImage rotatedImage = image;
-    if (xGlobal.getInt("SYSTEM", "IMG_ROTATE"))
-    {
-        QTransform transform;
-        transform.rotate(xGlobal.getInt("SYSTEM", "IMG_ROTATE"));
-        rotatedImage = image.transformed(transform, Qt::SmoothTransformation);
-
-        // 保持原始图像格式
-        if (rotatedImage.format() != originalFormat)
-        {
-            qDebug() << "[图像变换] 格式转换: " << rotatedImage.format() << " -> " << originalFormat;
-            rotatedImage = rotatedImage.convertToFormat(originalFormat);
-        }
-    }
-
-    QImage transformedImage;
-    if (xGlobal.getBool("SYSTEM", "FLIP_HORIZONTAL") && xGlobal.getBool("SYSTEM", "FLIP_VERTICAL"))
-    {
-        transformedImage = rotatedImage.flipped(Qt::Horizontal | Qt::Vertical);
-        qDebug() << "[图像变换] 执行: 水平+垂直翻转 (旋转180度)";
-    }
-    else if (xGlobal.getBool("SYSTEM", "FLIP_HORIZONTAL"))
-    {
-        transformedImage = rotatedImage.flipped(Qt::Horizontal);
-        qDebug() << "[图像变换] 执行: 水平翻转（左右镜像）";
-    }
-    else if (xGlobal.getBool("SYSTEM", "FLIP_VERTICAL"))
-    {
-        transformedImage = rotatedImage.flipped(Qt::Vertical);
-        qDebug() << "[图像变换] 执行: 垂直翻转（上下翻转）";
-    }
-    else
-    {
-        transformedImage = rotatedImage;
-    }
+    // 90 度整数倍旋转与翻转合并为一次遍历，结果写入帧池缓冲
+    QImage transformedImage = XImageHelper::transformImage(image, xGlobal.getInt("SYSTEM", "IMG_ROTATE"),
+                                                           xGlobal.getBool("SYSTEM", "FLIP_HORIZONTAL"),
+                                                           xGlobal.getBool("SYSTEM", "FLIP_VERTICAL"));
 
     qint64 transformTime = QDateTime::currentMSecsSinceEpoch() - transformStartTime;
     qDebug() << "[图像变换] 完成, 耗时:" << transformTime << "ms, 结果尺寸:" << transformedImage.width() << "x"
@@ -87,12 +71,34 @@ QImage AcqTask::applyImageTransform(const QImage& image)
     return transformedImage;
 }
 
+// Apply host-side flat-field/defect correction in place; templates are in detector orientation
+void AcqTask::applySoftCorrection(QImage& image)
+{
+    if (bSoftCorrection.load())
+    {
+        if (!XFlatFieldCorrector::Instance().apply(image))
+        {
+            qWarning() << "[软件校正] 校正失败, 已关闭本次采集的软件校正";
+            bSoftCorrection.store(false);
+        }
+    }
+    else if (bDefectCorrection.load())
+    {
+        // 仅修复坏点，避免坏点影响自动窗宽窗位与导出
+        if (!XFlatFieldCorrector::Instance().applyDefects(image))
+        {
+            qWarning() << "[软件校正] 坏点修复失败, 已关闭本次采集的坏点修复";
+            bDefectCorrection.store(false);
+        }
+    }
+}
+
 // Save stacked image to file based on acquisition conditions
-void AcqTask::saveStackedImage(const QImage& stackedImage, int frameIndex)
+QString AcqTask::saveStackedImage(const QImage& stackedImage, int frameIndex)
 {
     if (!acqCondition.saveToFiles || acqCondition.frame == INT_MAX)
     {
-        return;
+        return QString();
     }
 
     qint64 saveStartTime = QDateTime::currentMSecsSinceEpoch();
@@ -110,6 +116,7 @@ void AcqTask::saveStackedImage(const QImage& stackedImage, int frameIndex)
             XImageHelper::Instance().saveImageU16Raw(stackedImage, fileName);
             qint64 saveTime = QDateTime::currentMSecsSinceEpoch() - saveStartTime;
             qDebug() << "[文件保存] RAW文件保存成功, 文件:" << fileName << ", 耗时:" << saveTime << "ms";
+            return fileName;
         }
         else if (acqCondition.saveType == ".TIFF")
         {
@@ -117,6 +124,7 @@ void AcqTask::saveStackedImage(const QImage& stackedImage, int frameIndex)
             TiffHelper::SaveImage(stackedImage, fileName.toStdString());
             qint64 saveTime = QDateTime::currentMSecsSinceEpoch() - saveStartTime;
             qDebug() << "[文件保存] TIFF文件保存成功, 文件:" << fileName << ", 耗时:" << saveTime << "ms";
+            return fileName;
         }
         else if (acqCondition.saveType == ".PNG")
         {
@@ -134,6 +142,7 @@ void AcqTask::saveStackedImage(const QImage& stackedImage, int frameIndex)
             {
                 qint64 saveTime = QDateTime::currentMSecsSinceEpoch() - saveStartTime;
                 qDebug() << "[文件保存] PNG文件保存成功, 文件:" << fileName << ", 耗时:" << saveTime << "ms";
+                return fileName;
             }
             else
             {
@@ -155,6 +164,7 @@ void AcqTask::saveStackedImage(const QImage& stackedImage, int frameIndex)
             {
                 qint64 saveTime = QDateTime::currentMSecsSinceEpoch() - saveStartTime;
                 qDebug() << "[文件保存] JPG文件保存成功, 文件:" << fileName << ", 耗时:" << saveTime << "ms";
+                return fileName;
             }
             else
             {
@@ -171,10 +181,244 @@ void AcqTask::saveStackedImage(const QImage& stackedImage, int frameIndex)
     {
         qCritical() << "[文件保存] 文件保存异常:" << e.what();
     }
+    return QString();
+}
+
+// Write the per-frame metadata sidecar once, next to the saved images
+void AcqTask::writeFrameMeta()
+{
+    if (!bRecordMeta || bMetaWritten.exchange(true))
+    {
+        return;
+    }
+
+    QVector<XFrameMeta> rows;
+    {
+        QMutexLocker locker(&metaMutex);
+        rows = frameMetaLog;
+    }
+    if (!rows.isEmpty())
+    {
+        XFrameMetaLog::writeCsv(acqCondition.savePath + "/FrameMeta.csv", QString::fromStdString(acqCondition.mode),
+                                rows);
+    }
+}
+
+// Registration: correct and align one sub-frame in the thread pool, overlapping with the arrival of the next frames
+void AcqTask::submitRegistration(const QImage& image)
+{
+    if (registeredFrames.isEmpty())
+    {
+        // 组内首帧作为参考，校正后原样参与叠加
+        QFuture<XFrameRegistration::Result> first = QtConcurrent::run(
+            [this, image]()
+            {
+                XFrameRegistration::Result result;
+                result.image = image;
+                if (!bPreviewBinning)
+                {
+                    applySoftCorrection(result.image);
+                }
+                result.valid = true;
+                return result;
+            });
+
+        // 参考以续延生成，随后提交在此之前到达的子帧
+        const std::shared_ptr<RegistrationGroup> group = std::make_shared<RegistrationGroup>();
+        const XFrameRegistration::Options options = registrationOptions;
+        registrationGroup = group;
+        registrationReference = first.then(
+            QtFuture::Launch::Async,
+            [this, group, options](const XFrameRegistration::Result& result)
+            {
+                const std::shared_ptr<const XFrameRegistration::Reference> reference =
+                    XFrameRegistration::makeReference(result.image, options);
+                QVector<PendingAlignment> pending;
+                {
+                    QMutexLocker locker(&group->mutex);
+                    group->reference = reference;
+                    group->ready = true;
+                    pending.swap(group->pending);
+                }
+                for (const PendingAlignment& item : pending)
+                    startAlignment(reference, item.image, item.promise);
+            });
+        registeredFrames.append(first);
+        return;
+    }
+
+    // 先置为运行状态，叠加任务等待结果时不会因尚未提交而直接返回
+    auto promise = std::make_shared<QPromise<XFrameRegistration::Result>>();
+    promise->start();
+    registeredFrames.append(promise->future());
+
+    std::shared_ptr<const XFrameRegistration::Reference> reference;
+    {
+        QMutexLocker locker(&registrationGroup->mutex);
+        if (!registrationGroup->ready)
+        {
+            registrationGroup->pending.append({image, promise});
+            return;
+        }
+        reference = registrationGroup->reference;
+    }
+    startAlignment(reference, image, promise);
+}
+
+void AcqTask::startAlignment(std::shared_ptr<const XFrameRegistration::Reference> reference, const QImage& image,
+                             std::shared_ptr<QPromise<XFrameRegistration::Result>> promise)
+{
+    QThreadPool::globalInstance()->start(
+        [this, reference, image, promise]()
+        {
+            QImage frame = image;
+            if (!bPreviewBinning)
+            {
+                applySoftCorrection(frame);
+            }
+            XFrameRegistration::Result result;
+            if (reference)
+            {
+                result = XFrameRegistration::align(*reference, frame);
+            }
+            else
+            {
+                result.image = frame;
+            }
+            promise->addResult(result);
+            promise->finish();
+        });
+}
+
+// HDR: step through the exposure bracket while the detector keeps running, then fuse the per-step stacks
+void AcqTask::acquireHdrBracket()
+{
+    qint64 acqStartTime = QDateTime::currentMSecsSinceEpoch();
+    const int steps = hdrOptions.bracket.size();
+    auto queuedSteps = [this]()
+    {
+        QMutexLocker locker(&hdrMutex);
+        return hdrStacks.size();
+    };
+
+    for (int step = 0; step < steps && !bStopRequested.load(); ++step)
+    {
+        const XHdrFusion::Exposure exposure = hdrOptions.bracket[step];
+        qDebug() << "[HDR] 第" << (step + 1) << "/" << steps << "档, 开启射线:" << exposure.voltage << "kV,"
+                 << exposure.current << "uA";
+        this->onProgressChanged(QString("HDR 第 %1/%2 档 %3kV / %4uA, 等待射线稳定")
+                                    .arg(step + 1)
+                                    .arg(steps)
+                                    .arg(exposure.voltage)
+                                    .arg(exposure.current));
+        QString errMsg;
+        if (!exposureOrchestrator.beamOn(exposure.voltage, exposure.current,
+                                         [this]() { return bStopRequested.load(); }, errMsg))
+        {
+            DET.StopAcq();
+            if (!errMsg.isEmpty())
+            {
+                this->onErrorOccurred(errMsg);
+            }
+            return;
+        }
+        qDebug() << "[HDR] 射线已稳定, 耗时:" << exposureOrchestrator.rampMs() << "ms";
+
+        // 首档在射线稳定后才启动探测器；之后探测器不停，切换后的前几帧可能跨越爬升过程
+        nHdrSkip.store(step == 0 ? 0 : hdrOptions.skipFrames);
+        bHdrCollecting.store(true);
+        if (step == 0)
+        {
+            frameRateMonitor.reset(acqCondition.frameRate);
+            frameRateReportTimer.invalidate();
+            acqClock.start();
+            if (!DET.StartAcq())
+            {
+                qCritical() << "[硬件采集] 启动失败";
+                exposureOrchestrator.beamOff();
+                this->onErrorOccurred("采集失败, 请重试");
+                return;
+            }
+        }
+
+        while (!bStopRequested.load() && queuedSteps() <= step)
+            QThread::msleep(10);
+    }
+
+    exposureOrchestrator.beamOff();
+    DET.StopAcq();
+    if (bStopRequested.load() || queuedSteps() < steps)
+    {
+        qWarning() << "[HDR] 采集已停止, 完成" << queuedSteps() << "/" << steps << "档, 不进行融合";
+        return;
+    }
+
+    this->onProgressChanged("HDR 融合");
+    QVector<QFuture<QImage>> stacks;
+    {
+        QMutexLocker locker(&hdrMutex);
+        stacks = hdrStacks;
+    }
+    QVector<QImage> exposures;
+    for (const auto& future : stacks)
+        exposures.append(future.result());
+    const XHdrFusion::Result fused = XHdrFusion::fuse(exposures, hdrOptions);
+    if (fused.image.isNull())
+    {
+        this->onErrorOccurred("HDR 融合失败, 各档叠加结果不一致");
+        return;
+    }
+
+    const QImage image = applyImageTransform(fused.image);
+    const QImage displayImage = filterChain.isEmpty() ? image : filterChain.apply(image);
+    const bool filtered = bFilterOnSave && !filterChain.isEmpty();
+    const QString fileName = saveStackedImage(filtered ? displayImage : image, 0);
+    AcqTaskManager::Instance().publishStackedFrame(acqCondition, 0, filtered ? displayImage : image, filtered);
+    if (bRecordMeta)
+    {
+        QMutexLocker locker(&metaMutex);
+        for (XFrameMeta meta : hdrMetas)
+        {
+            meta.fileName = fileName;
+            frameMetaLog.append(meta);
+        }
+    }
+
+    emit AcqTaskManager::Instance().acqTaskFrameStacked(acqCondition, 0, displayImage);
+    nProcessedStacekd.store(1);
+    writeFrameMeta();
+    this->onProgressChanged(fused.summary());
+
+    qDebug() << "[HDR] 完成, 档位:" << XHdrFusion::formatBracket(hdrOptions.bracket)
+             << ", 总耗时:" << (QDateTime::currentMSecsSinceEpoch() - acqStartTime) << "ms, 接收:"
+             << nReceivedIdx.load() << "帧";
+    const QString frameRateSummary = frameRateMonitor.summary();
+    qInfo() << "[帧率监控]" << frameRateSummary;
+    emit AcqTaskManager::Instance().signalFrameRateChanged(frameRateSummary);
+}
+
+// HDR: stack and correct one bracket step in the thread pool while the next step ramps
+void AcqTask::queueHdrStack(const QVector<QImage>& imagesToStack, const QVector<XFrameMeta>& metas)
+{
+    QFuture<QImage> future = QtConcurrent::run(
+        [this, imagesToStack]()
+        {
+            QImage stackedImage = stackImages(imagesToStack);
+            if (!stackedImage.isNull())
+            {
+                applySoftCorrection(stackedImage);
+            }
+            return stackedImage;
+        });
+
+    QMutexLocker locker(&hdrMutex);
+    hdrMetas += metas;
+    hdrStacks.append(future);
 }
 
 // Helper function to process stacked frames and save results
-void AcqTask::processStackedFrames(const QVector<QImage>& imagesToStack)
+void AcqTask::processStackedFrames(const QVector<QImage>& imagesToStack, const QVector<XFrameMeta>& metas,
+                                   const QVector<QFuture<XFrameRegistration::Result>>& registered)
 {
     int vecIdx = nProcessedStacekd.load() % xGlobal.getInt("SYSTEM", "IMAGE_BUFFER_SIZE");
     qint64 processStartTime = QDateTime::currentMSecsSinceEpoch();
@@ -183,35 +427,111 @@ void AcqTask::processStackedFrames(const QVector<QImage>& imagesToStack)
              << ", 帧数:" << imagesToStack.size();
 
     // Execute stacking in background thread
+    nStacksInFlight.fetch_add(1);
     auto future = QtConcurrent::run(
-        [this, imagesToStack, vecIdx, processStartTime]()
+        [this, imagesToStack, metas, registered, vecIdx, processStartTime]()
         {
-            QImage stackedImage = stackImages(imagesToStack);
+            // 配准任务在帧到达时已提交，这里只等待尚未完成的帧；配准帧已逐帧校正
+            QVector<QImage> frames = imagesToStack;
+            if (!registered.isEmpty())
+            {
+                QElapsedTimer waitTimer;
+                waitTimer.start();
+                frames.clear();
+                int applied = 0;
+                int rejected = 0;
+                double maxShift = 0.0;
+                for (const auto& future : registered)
+                {
+                    const XFrameRegistration::Result result = future.result();
+                    frames.append(result.image);
+                    applied += result.applied ? 1 : 0;
+                    rejected += result.valid ? 0 : 1;
+                    if (result.valid)
+                        maxShift = std::max(maxShift, std::hypot(result.dx, result.dy));
+                }
+                qDebug() << "[配准] 第" << (nProcessedStacekd.load() + 1) << "组: 重采样" << applied << "帧, 未对齐"
+                         << rejected << "帧, 最大位移" << maxShift << "px, 等待" << waitTimer.elapsed() << "ms";
+            }
+
+            QImage stackedImage = stackImages(frames);
 
             if (stackedImage.isNull())
             {
                 qCritical() << "[异步处理] 叠加结果为空";
+                nStacksInFlight.fetch_sub(1);
                 return;
             }
 
+            // 平场校正是线性运算，对叠加结果校正一次即可；预览合并或配准时已逐帧校正
+            if (!bPreviewBinning && registered.isEmpty())
+            {
+                applySoftCorrection(stackedImage);
+            }
+
             // Apply image transformation if enabled
             stackedImage = applyImageTransform(stackedImage);
 
             qDebug() << "[异步处理] 叠加完成, 结果尺寸:" << stackedImage.width() << "x" << stackedImage.height()
                      << ", 缓冲索引:" << vecIdx;
 
-            if (acqCondition.stackedFrame > 0)
+            if (bAdaptiveStack)
+                onProgressChanged(QString("数据叠加完成, 实际使用 %1 帧").arg(imagesToStack.size()));
+            else if (acqCondition.stackedFrame > 0)
                 onProgressChanged("数据叠加完成");
 
-            // Save files if specified
-            saveStackedImage(stackedImage, nProcessedStacekd.load());
+            // 显示增强滤波，默认只作用于显示，FILTER_APPLY_ON_SAVE 时保存滤波结果
+            QImage displayImage = stackedImage;
+            if (!filterChain.isEmpty())
+            {
+                QList<XImageFilterChain::Timing> timings;
+                displayImage = filterChain.apply(stackedImage, &timings);
+
+                double filterMs = 0.0;
+                for (const auto& timing : timings)
+                    filterMs += timing.ms;
+                const double budgetMs = 1000.0 * imagesToStack.size() / std::max(1, acqCondition.frameRate);
+                if (filterMs > budgetMs)
+                {
+                    qWarning() << "[图像处理] 滤波耗时超出帧预算" << budgetMs << "ms:"
+                               << XImageFilterChain::formatTimings(timings);
+                }
+                else
+                {
+                    qDebug() << "[图像处理]" << XImageFilterChain::formatTimings(timings);
+                }
+            }
+
+            // Save files if specified，共享内存发布与保存相同的数据
+            const bool filtered = bFilterOnSave && !filterChain.isEmpty();
+            const QImage savedImage = filtered ? displayImage : stackedImage;
+            const QString fileName = saveStackedImage(savedImage, nProcessedStacekd.load());
+            AcqTaskManager::Instance().publishStackedFrame(acqCondition, nProcessedStacekd.load(), savedImage,
+                                                           filtered);
+
+            const XFrameMeta avg = XFrameMetaLog::average(metas);
+            qDebug() << "[元数据] 第" << (nProcessedStacekd.load() + 1) << "组: 平均" << avg.xray.voltage << "kV,"
+                     << avg.xray.current * 1000.0 << "uA, 灰度" << avg.grayValue;
+            if (bRecordMeta)
+            {
+                QMutexLocker locker(&metaMutex);
+                for (XFrameMeta meta : metas)
+                {
+                    meta.fileName = fileName;
+                    frameMetaLog.append(meta);
+                }
+            }
 
             qint64 totalProcessTime = QDateTime::currentMSecsSinceEpoch() - processStartTime;
             qDebug() << "[异步处理] 第" << (nProcessedStacekd.load() + 1) << "组数据处理完成, 耗时:" << totalProcessTime
                      << "ms";
 
-            emit AcqTaskManager::Instance().acqTaskFrameStacked(acqCondition, nProcessedStacekd.load(), stackedImage);
-            nProcessedStacekd.fetch_add(1);
+            emit AcqTaskManager::Instance().acqTaskFrameStacked(acqCondition, nProcessedStacekd.load(), displayImage);
+            if (nProcessedStacekd.fetch_add(1) + 1 >= acqCondition.frame)
+            {
+                writeFrameMeta();
+            }
+            nStacksInFlight.fetch_sub(1);
         });
 
     auto* watcher = new QFutureWatcher<void>(this);
@@ -225,6 +545,91 @@ void AcqTask::processStackedFrames(const QVector<QImage>& imagesToStack)
     //watcher->waitForFinished();
 }
 
+// CT: stack and correct one projection off the receiving thread, then hand it to the ordered stack writer
+void AcqTask::processProjection(const QVector<QImage>& imagesToStack, const QVector<XFrameMeta>& metas,
+                                int projectionIdx)
+{
+    nProjectionsInFlight.fetch_add(1);
+    QThreadPool::globalInstance()->start(
+        [this, imagesToStack, metas, projectionIdx]()
+        {
+            QImage projection = stackImages(imagesToStack);
+            if (projection.isNull())
+            {
+                qCritical() << "[CT] 投影" << projectionIdx << "叠加结果为空, 跳过";
+                projectionWriter.skip(projectionIdx);
+            }
+            else
+            {
+                // 投影按探测器方向写入，翻转 / 旋转只用于预览
+                applySoftCorrection(projection);
+
+                const double angle = acqCondition.startAngle + projectionIdx * acqCondition.angleStep;
+                const XFrameMeta avg = XFrameMetaLog::average(metas);
+                if (!projectionWriter.append(projectionIdx, projection, angle, avg) && !bStopRequested.load())
+                {
+                    this->onErrorOccurred("CT 投影写入失败: " + projectionWriter.errorString());
+                }
+                AcqTaskManager::Instance().publishStackedFrame(acqCondition, projectionIdx, projection, false);
+
+                if (bRecordMeta)
+                {
+                    QMutexLocker locker(&metaMutex);
+                    for (XFrameMeta meta : metas)
+                    {
+                        meta.fileName = projectionWriter.filePath();
+                        frameMetaLog.append(meta);
+                    }
+                }
+
+                // 预览按时间间隔抽样，避免高帧率下界面刷新拖慢扫描
+                const qint64 now = QDateTime::currentMSecsSinceEpoch();
+                qint64 last = lastProjectionPreviewMs.load();
+                if (now - last >= xGlobal.getInt("CT", "CT_PREVIEW_INTERVAL_MS", 500) &&
+                    lastProjectionPreviewMs.compare_exchange_strong(last, now))
+                {
+                    emit AcqTaskManager::Instance().acqTaskFrameStacked(acqCondition, projectionIdx,
+                                                                        applyImageTransform(projection));
+                }
+            }
+
+            nProcessedStacekd.fetch_add(1);
+            nProjectionsInFlight.fetch_sub(1);
+        });
+}
+
+// CT: wait for projections still being processed, then close the stack file and report throughput
+void AcqTask::finishProjectionStack()
+{
+    while (nProjectionsInFlight.load() > 0)
+    {
+        QThread::msleep(10);
+    }
+
+    if (projectionWriter.isOpen())
+    {
+        const bool ok = projectionWriter.close();
+        const XProjectionStackWriter::Stats stats = projectionWriter.stats();
+        const QString summary = QString("CT扫描结束: 投影 %1/%2, 平均 %3 投影/s, 写盘 %4 MB/s, 共 %5 MB")
+                                    .arg(stats.written)
+                                    .arg(acqCondition.frame)
+                                    .arg(stats.projectionsPerSec, 0, 'f', 1)
+                                    .arg(stats.mbPerSec, 0, 'f', 1)
+                                    .arg(stats.bytes / 1024.0 / 1024.0, 0, 'f', 0);
+        qInfo() << "[CT]" << summary << ", 文件:" << projectionWriter.filePath();
+        if (ok)
+        {
+            emit AcqTaskManager::Instance().signalAcqProgressChanged(summary);
+        }
+        else
+        {
+            this->onErrorOccurred("CT 投影文件写入失败: " + projectionWriter.errorString());
+        }
+    }
+
+    writeFrameMeta();
+}
+
 void AcqTask::onErrorOccurred(const QString& msg)
 {
     qCritical() << "[错误] 采集失败 - 消息:" << msg
@@ -234,6 +639,7 @@ void AcqTask::onErrorOccurred(const QString& msg)
                 << ", 缓冲大小:" << AcqTaskManager::Instance().stackedImageList.size();
 
     bStopRequested.store(true);
+    exposureOrchestrator.beamOff();
     emit AcqTaskManager::Instance().signalAcqErr(msg);
 }
 
@@ -250,11 +656,11 @@ void AcqTask::onProgressChanged(const QString& msg)
 
 void AcqTask::startAcq()
 {
-    qDebug() << "[采集参数] 模式:" << (acqCondition.acqType == AcqType::DR ? "DR" : "其他")
+    qDebug() << "[采集参数] 模式:" << (acqCondition.acqType == AcqType::DR ? "DR" : "CT")
              << ", 工作模式:" << acqCondition.mode.c_str() << ", 帧数:" << acqCondition.frame
              << (acqCondition.frame == INT_MAX ? " (连续)" : "") << ", 帧率:" << acqCondition.frameRate
              << "fps, 叠加:" << acqCondition.stackedFrame << ", 电压:" << acqCondition.voltage
-             << "kV, 电流:" << acqCondition.current << "mA, 保存:" << (acqCondition.saveToFiles ? "是" : "否")
+             << "kV, 电流:" << acqCondition.current << "uA, 保存:" << (acqCondition.saveToFiles ? "是" : "否")
              << ", 水平翻转:" << (xGlobal.getBool("SYSTEM", "FLIP_HORIZONTAL") ? "是" : "否")
              << ", 垂直翻转:" << (xGlobal.getBool("SYSTEM", "FLIP_VERTICAL") ? "是" : "否");
 
@@ -263,10 +669,104 @@ void AcqTask::startAcq()
         qDebug() << "[保存配置] 路径:" << acqCondition.savePath << ", 格式:" << acqCondition.saveType;
     }
 
+    if (acqCondition.acqType == AcqType::CT && acqCondition.savePath.isEmpty())
+    {
+        this->onErrorOccurred("CT 扫描需要指定投影文件的保存位置");
+        return;
+    }
+
     AcqTaskManager::Instance().stackedImageList.clear();
     nReceivedIdx.store(0);
     nProcessedStacekd.store(0);
     bStopRequested.store(false);
+    nProjectionsInFlight.store(0);
+    nStacksInFlight.store(0);
+    lastProjectionPreviewMs.store(0);
+    nStackGroups.store(0);
+    nAdaptiveFrames.store(0);
+
+    bRecordMeta = acqCondition.saveToFiles && acqCondition.frame != INT_MAX &&
+                  xGlobal.getBool("SYSTEM", "SAVE_FRAME_META", true);
+    pendingMeta.clear();
+    frameMetaLog.clear();
+    bMetaWritten.store(false);
+    if (bRecordMeta)
+    {
+        frameMetaLog.reserve(acqCondition.frame * (acqCondition.stackedFrame + 1));
+    }
+
+    bool softCorrection = xGlobal.getBool("CORRECTION", "SOFT_CORRECTION_ENABLE");
+    bool defectCorrection = !softCorrection && xGlobal.getBool("CORRECTION", "DEFECT_CORRECTION_ENABLE");
+    if ((softCorrection || defectCorrection) && !XFlatFieldCorrector::Instance().hasOffset() &&
+        !XFlatFieldCorrector::Instance().loadTemplates(XFlatFieldCorrector::templateDir()))
+    {
+        qWarning() << "[软件校正] 未找到可用的校正模板, 本次采集不进行软件校正";
+        softCorrection = false;
+        defectCorrection = false;
+    }
+    defectCorrection = defectCorrection && XFlatFieldCorrector::Instance().defectMap() != nullptr;
+    bSoftCorrection.store(softCorrection);
+    bDefectCorrection.store(defectCorrection);
+    qDebug() << "[软件校正] 实时校正:" << (softCorrection ? "开启" : "关闭")
+             << ", 坏点修复:" << (softCorrection || defectCorrection ? "开启" : "关闭") << ","
+             << XFlatFieldCorrector::Instance().defectSummary();
+
+    filterChain = XImageFilterChain::fromConfig();
+    bFilterOnSave = xGlobal.getBool("FILTER", "FILTER_APPLY_ON_SAVE", false);
+
+    // 仅实时采集使用预览合并，保存到文件的多帧采集保持全分辨率
+    previewOptions = XImageBinning::Options::fromConfig();
+    bPreviewBinning = acqCondition.frame == INT_MAX && previewOptions.enabled();
+    if (bPreviewBinning)
+    {
+        qDebug() << "[预览] 软件合并:" << previewOptions.factor << "x" << previewOptions.factor
+                 << (previewOptions.decimate ? "(抽点)" : "(平均)") << ", ROI:" << previewOptions.roi;
+    }
+
+    stackOptions = XImageStacker::Options::fromConfig();
+    qDebug() << "[叠加] 方式:" << XImageStacker::methodName(stackOptions.method) << ", kappa:" << stackOptions.kappa;
+
+    // HDR 只用于 DR 单幅采集，射线由采集流程逐档开启
+    bHdr = acqCondition.acqType == AcqType::DR && acqCondition.hdr;
+    hdrStacks.clear();
+    hdrMetas.clear();
+    bHdrCollecting.store(false);
+    if (bHdr)
+    {
+        hdrOptions = XHdrFusion::Options::fromConfig();
+        if (hdrOptions.bracket.size() < 2)
+        {
+            this->onErrorOccurred("HDR 采集需要在 [HDR] HDR_BRACKET 中配置至少两档 kV:uA");
+            return;
+        }
+        acqCondition.frame = 1;
+        acqCondition.autoXRay = true;
+        qDebug() << "[HDR] 档位:" << XHdrFusion::formatBracket(hdrOptions.bracket) << ", 每档叠加"
+                 << (acqCondition.stackedFrame + 1) << "帧, 切换后丢弃" << hdrOptions.skipFrames << "帧";
+    }
+
+    // 自适应叠加只用于 DR，界面选择的叠加帧数不再生效
+    bAdaptiveStack = !bHdr && acqCondition.acqType == AcqType::DR && acqCondition.stackedFrame > 0 &&
+                     xGlobal.getBool("SYSTEM", "STACK_ADAPTIVE", false);
+    if (bAdaptiveStack)
+    {
+        const XStackSnrMonitor::Options snrOptions = XStackSnrMonitor::Options::fromConfig();
+        snrMonitor.reset(snrOptions);
+        qDebug() << "[叠加] 自适应叠加 - 目标SNR:" << snrOptions.targetSnr << ", 帧数范围:" << snrOptions.minFrames
+                 << "-" << snrOptions.maxFrames << ", 参考ROI:" << snrOptions.roi << ", 抽点:" << snrOptions.sampleStep;
+    }
+
+    // 配准只用于 DR 多帧叠加，首帧为参考
+    bRegistration = !bHdr && acqCondition.acqType == AcqType::DR && acqCondition.stackedFrame > 0 &&
+                    xGlobal.getBool("SYSTEM", "STACK_REGISTRATION", false);
+    registeredFrames.clear();
+    if (bRegistration)
+    {
+        registrationOptions = XFrameRegistration::Options::fromConfig();
+        qDebug() << "[配准] 叠加前配准 - 合并:" << registrationOptions.downsample
+                 << ", 响应下限:" << registrationOptions.minResponse << ", 位移范围:" << registrationOptions.minShift
+                 << "-" << registrationOptions.maxShift << "px, ROI:" << registrationOptions.roi;
+    }
 
     int totalStackFrames = (acqCondition.stackedFrame == 0) ? 1 : (1 + acqCondition.stackedFrame);
     qDebug() << "[初始化] 堆栈配置: 需要采集" << totalStackFrames << "帧进行叠加";
@@ -294,13 +794,42 @@ void AcqTask::startAcq()
         qDebug() << "[硬件采集] 探测器信号连接成功";
     }
 
+    if (bHdr)
+    {
+        acquireHdrBracket();
+        return;
+    }
+
     qint64 acqStartTime = QDateTime::currentMSecsSinceEpoch();
+
+    // 射线读数稳定后再启动探测器，避免爬升阶段的帧进入结果
+    if (acqCondition.autoXRay)
+    {
+        qDebug() << "[出束] 开启射线源:" << acqCondition.voltage << "kV," << acqCondition.current << "uA";
+        this->onProgressChanged("等待射线源电压 / 电流稳定");
+        QString errMsg;
+        if (!exposureOrchestrator.beamOn(acqCondition.voltage, acqCondition.current,
+                                         [this]() { return bStopRequested.load(); }, errMsg))
+        {
+            if (!errMsg.isEmpty())
+            {
+                this->onErrorOccurred(errMsg);
+            }
+            return;
+        }
+        qDebug() << "[出束] 射线已稳定, 耗时:" << exposureOrchestrator.rampMs() << "ms";
+    }
+
     qDebug() << "[硬件采集] 启动采集...";
 
+    frameRateMonitor.reset(acqCondition.frameRate);
+    frameRateReportTimer.invalidate();
+    acqClock.start();
     if (!DET.StartAcq())
     {
         QString errMsg = "采集失败, 请重试";
         qCritical() << "[硬件采集] 启动失败:" << errMsg;
+        exposureOrchestrator.beamOff();
         this->onErrorOccurred(errMsg);
         bStopRequested.store(true);
         return;
@@ -316,13 +845,48 @@ void AcqTask::startAcq()
             qDebug() << "[硬件采集] 进度 - 已接收:" << nReceivedIdx.load() << "帧, 已处理:" << nProcessedStacekd.load()
                      << "帧";
         }
+        if (acqCondition.acqType == AcqType::CT && projectionWriter.isOpen())
+        {
+            this->onProgressChanged(QString("CT扫描 %1/%2 | %3")
+                                        .arg(nReceivedIdx.load() / (acqCondition.stackedFrame + 1))
+                                        .arg(acqCondition.frame)
+                                        .arg(projectionWriter.statusText()));
+        }
         QThread::msleep(500);
     } while (!bStopRequested.load());
 
+    exposureOrchestrator.beamOff();
+
+    if (acqCondition.acqType == AcqType::CT)
+    {
+        finishProjectionStack();
+    }
+
+    // 提前停止时保存已完成部分的元数据，先等已提交的叠加组保存完并登记元数据
+    if (nProcessedStacekd.load() < acqCondition.frame)
+    {
+        while (nStacksInFlight.load() > 0)
+        {
+            QThread::msleep(10);
+        }
+        writeFrameMeta();
+    }
+
     qint64 acqEndTime = QDateTime::currentMSecsSinceEpoch();
     qDebug() << "[硬件采集] 完成, 耗时:" << (acqEndTime - acqStartTime) << "ms, 接收:" << nReceivedIdx.load()
              << "帧, 处理:" << nProcessedStacekd.load() << "帧";
 
+    if (bAdaptiveStack && nStackGroups.load() > 0)
+    {
+        qInfo() << "[叠加] 自适应叠加:" << nStackGroups.load() << "组, 共" << nAdaptiveFrames.load() << "帧, 平均"
+                 << static_cast<double>(nAdaptiveFrames.load()) / nStackGroups.load() << "帧/组";
+    }
+
+    const QString frameRateSummary = frameRateMonitor.summary();
+    qInfo() << "[帧率监控]" << frameRateSummary;
+    emit AcqTaskManager::Instance().signalFrameRateChanged(frameRateSummary);
+    qDebug() << "[帧池]" << XFramePool::Instance().statistics();
+
     return;
 }
 
@@ -334,6 +898,7 @@ void AcqTask::stopAcq()
 
     bStopRequested.store(true);
 
+    exposureOrchestrator.beamOff();
     DET.StopAcq();
     qDebug() << "[停止采集] 硬件采集已停止";
 }
@@ -354,10 +919,18 @@ void AcqTask::onImageReceived(QImage image, int idx, int grayValue)
         return;
     }
 
+    frameRateMonitor.onFrame(idx, acqClock.nsecsElapsed() / 1000);
+    if (!frameRateReportTimer.isValid() || frameRateReportTimer.elapsed() >= 500)
+    {
+        frameRateReportTimer.start();
+        emit AcqTaskManager::Instance().signalFrameRateChanged(frameRateMonitor.statusText());
+    }
+
     if (nProcessedStacekd.load() >= acqCondition.frame)
     {
         qDebug() << "[接收] idx=" << idx << ", 已采集足够数据, 处理数:" << nProcessedStacekd.load() << ", 停止采集";
         bStopRequested.store(true);
+        exposureOrchestrator.beamOff();
         DET.StopAcq();
         return;
     }
@@ -374,20 +947,72 @@ void AcqTask::onImageReceived(QImage image, int idx, int grayValue)
         return;
     }
 
+    // HDR：档位切换期间及切换后尚未稳定的帧不参与叠加
+    if (bHdr && (!bHdrCollecting.load() || (nHdrSkip.load() > 0 && nHdrSkip.fetch_sub(1) > 0)))
+    {
+        qDebug() << "[HDR] idx=" << idx << ", 档位切换中, 丢弃此帧";
+        return;
+    }
+
+    if (bPreviewBinning)
+    {
+        applySoftCorrection(image);
+        QImage binned = XImageBinning::bin(image, previewOptions);
+        if (binned.isNull())
+        {
+            // 该帧已做过校正，丢弃后其余帧按全分辨率处理
+            qWarning() << "[预览] 合并失败, 关闭本次采集的预览合并, 丢弃 idx=" << idx;
+            bPreviewBinning = false;
+            return;
+        }
+        image = binned;
+    }
+
+    const int expectedStackCount = acqCondition.stackedFrame + 1;
+
+    XFrameMeta meta;
+    meta.timestampUs = acqClock.nsecsElapsed() / 1000;
+    meta.detIdx = idx;
+    meta.stackIdx = nStackGroups.load();
+    meta.subFrameIdx = AcqTaskManager::Instance().stackedImageList.size();
+    meta.grayValue = grayValue;
+    meta.xray = IXS120BP120P366::Instance().getCurrentStatus();
+
     AcqTaskManager::Instance().stackedImageList.append(image);
+    pendingMeta.append(meta);
     nReceivedIdx.fetch_add(1);
+    if (bRegistration)
+    {
+        submitRegistration(image);
+    }
+
+    int currentBufferSize = AcqTaskManager::Instance().stackedImageList.size();
+    if (bAdaptiveStack)
+    {
+        snrMonitor.addFrame(image);
+    }
+    const bool groupComplete = bAdaptiveStack ? snrMonitor.done() : currentBufferSize == expectedStackCount;
+
+    // 所需的最后一帧已到达，叠加与保存不再需要射线
+    const int groupsNeeded = bHdr ? hdrOptions.bracket.size() : acqCondition.frame;
+    if (groupComplete && acqCondition.frame != INT_MAX && nStackGroups.load() + 1 >= groupsNeeded)
+    {
+        exposureOrchestrator.beamOff();
+    }
 
     if (acqCondition.stackedFrame > 0 && xGlobal.getBool("SYSTEM", "SEND_SUBFRAME_ON_ACQ"))
     {
         // Apply image transformation for display/emission
-        QImage processedImage = applyImageTransform(image);
+        QImage processedImage = image;
+        if (!bPreviewBinning)
+        {
+            applySoftCorrection(processedImage);
+        }
+        processedImage = applyImageTransform(processedImage);
         emit AcqTaskManager::Instance().acqTaskFrameReceived(
             acqCondition, nProcessedStacekd.load(), nReceivedIdx % (acqCondition.stackedFrame + 1), processedImage);
     }
 
-    int currentBufferSize = AcqTaskManager::Instance().stackedImageList.size();
-    int expectedStackCount = acqCondition.stackedFrame + 1;
-
     // 定期输出接收进度
     if (true || nReceivedIdx.load() % 10 == 0 || currentBufferSize == 1)
     {
@@ -396,7 +1021,12 @@ void AcqTask::onImageReceived(QImage image, int idx, int grayValue)
                  << ", 累计:" << nReceivedIdx.load() << "帧";
     }
 
-    if (acqCondition.stackedFrame > 0)
+    if (bAdaptiveStack)
+    {
+        this->onProgressChanged(
+            QString("第 %1 帧 自适应叠加 %2").arg(nProcessedStacekd.load() + 1).arg(snrMonitor.statusText()));
+    }
+    else if (acqCondition.stackedFrame > 0)
     {
         this->onProgressChanged(QString("第 %1 帧 叠加数据 %2/%3 已接收")
                                     .arg(nProcessedStacekd.load() + 1)
@@ -405,12 +1035,58 @@ void AcqTask::onImageReceived(QImage image, int idx, int grayValue)
     }
 
     // 当缓冲区满足叠加要求时处理
-    if (currentBufferSize == expectedStackCount)
+    if (groupComplete)
     {
         qDebug() << "[缓冲区满] 达到叠加要求, 准备处理" << currentBufferSize << "帧数据";
+        if (bAdaptiveStack)
+        {
+            qInfo() << "[叠加] 自适应叠加第" << (nStackGroups.load() + 1) << "组:" << snrMonitor.statusText()
+                    << (snrMonitor.frames() >= snrMonitor.options().maxFrames ? "(达到叠加上限)" : "(达到目标)");
+            nAdaptiveFrames.fetch_add(currentBufferSize);
+            snrMonitor.restart();
+        }
+        bHdrCollecting.store(false);
+        nStackGroups.fetch_add(1);
 
         QVector<QImage> imagesToStack = AcqTaskManager::Instance().stackedImageList;
         AcqTaskManager::Instance().stackedImageList.clear();
+        QVector<XFrameMeta> metas = pendingMeta;
+        pendingMeta.clear();
+        QVector<QFuture<XFrameRegistration::Result>> registered;
+        registered.swap(registeredFrames);
+
+        if (bHdr)
+        {
+            this->queueHdrStack(imagesToStack, metas);
+            return;
+        }
+
+        if (acqCondition.acqType == AcqType::CT)
+        {
+            const int projectionIdx = (nReceivedIdx.load() - 1) / expectedStackCount;
+            if (!projectionWriter.isOpen())
+            {
+                const QString filePath = QString("%1/Projections_%2.xprj")
+                                             .arg(acqCondition.savePath)
+                                             .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+                if (!projectionWriter.open(filePath, image.width(), image.height(), acqCondition.startAngle,
+                                           acqCondition.angleStep, xGlobal.getInt("CT", "CT_WRITE_QUEUE", 8)))
+                {
+                    this->onErrorOccurred(QString("无法创建投影文件 %1").arg(filePath));
+                    DET.StopAcq();
+                    return;
+                }
+            }
+            this->processProjection(imagesToStack, metas, projectionIdx);
+
+            // 最后一个投影已提交，处理完成后由采集线程关闭投影文件
+            if (projectionIdx + 1 >= acqCondition.frame)
+            {
+                bStopRequested.store(true);
+                DET.StopAcq();
+            }
+            return;
+        }
 
         if (acqCondition.stackedFrame > 0)
         {
@@ -418,7 +1094,7 @@ void AcqTask::onImageReceived(QImage image, int idx, int grayValue)
             this->onProgressChanged("开始进行数据叠加");
         }
 
-        this->processStackedFrames(imagesToStack);
+        this->processStackedFrames(imagesToStack, metas, registered);
     }
 }
 
@@ -444,19 +1120,12 @@ QImage AcqTask::stackImages(const QVector<QImage>& images)
     QImage::Format format = images[0].format();
     int count = images.size();
     int totalPixels = width * height;
-    qint64 totalMemory = totalPixels * sizeof(float) + totalPixels * sizeof(quint16) * count;
+    qint64 totalMemory = totalPixels * sizeof(quint16) * count;
 
     qDebug() << "[叠加] 开始处理, 帧数:" << count << ", 分辨率:" << width << "x" << height << " (" << totalPixels
              << "像素), 格式:" << (int)format << ", 内存:" << (totalMemory / 1024.0 / 1024.0) << "MB";
 
-    qint64 accumulateStartTime = QDateTime::currentMSecsSinceEpoch();
-
-    QVector<float> accumulateBuffer(totalPixels, 0.0f);
-    qDebug() << "[叠加] 缓冲区分配成功";
-
-    QVector<const quint16*> pixelDataList;
-    int validFrames = 0;
-
+    QVector<const QImage*> validImages;
     for (int i = 0; i < images.size(); ++i)
     {
         const QImage& img = images[i];
@@ -466,77 +1135,25 @@ QImage AcqTask::stackImages(const QVector<QImage>& images)
                        << " (格式:" << (int)img.format() << "), 跳过";
             continue;
         }
-        pixelDataList.append(reinterpret_cast<const quint16*>(img.constBits()));
-        validFrames++;
+        validImages.append(&img);
     }
+    const int validFrames = validImages.size();
     qDebug() << "[叠加] 有效帧数:" << validFrames << "/" << count;
-
-    const int BLOCK_SIZE = 65536;
-    int blockCount = (totalPixels + BLOCK_SIZE - 1) / BLOCK_SIZE;
-    qDebug() << "[叠加] 并行配置 - 块大小:" << BLOCK_SIZE << "像素, 块数:" << blockCount << ", 开始累加...";
-
-    qint64 accumulatePhaseStart = QDateTime::currentMSecsSinceEpoch();
-
-    QVector<QFuture<void>> accumulateFutures;
-    for (int blockIdx = 0; blockIdx < blockCount; ++blockIdx)
+    if (validFrames == 0)
     {
-        auto future = QtConcurrent::run(
-            [&, blockIdx]()
-            {
-                int startIdx = blockIdx * BLOCK_SIZE;
-                int endIdx = qMin(startIdx + BLOCK_SIZE, totalPixels);
-
-                for (const quint16* pixelData : pixelDataList)
-                {
-                    for (int i = startIdx; i < endIdx; ++i)
-                    {
-                        accumulateBuffer[i] += static_cast<float>(pixelData[i]);
-                    }
-                }
-            });
-        accumulateFutures.append(future);
+        return QImage();
     }
 
-    for (auto& future : accumulateFutures)
-        future.waitForFinished();
-
-    qint64 accumulateTime = QDateTime::currentMSecsSinceEpoch() - accumulatePhaseStart;
-    qDebug() << "[叠加] 累加完成, 耗时:" << accumulateTime << "ms";
-
-    qint64 averageStartTime = QDateTime::currentMSecsSinceEpoch();
-
-    QImage result(width, height, format);
-    quint16* dstData = reinterpret_cast<quint16*>(result.bits());
-    float invCount = 1.0f / static_cast<float>(validFrames);
-
-    QVector<QFuture<void>> averageFutures;
-    for (int blockIdx = 0; blockIdx < blockCount; ++blockIdx)
+    QImage result = XImageStacker::stack(validImages, stackOptions);
+    if (result.isNull())
     {
-        auto future = QtConcurrent::run(
-            [&, blockIdx, invCount]()
-            {
-                int startIdx = blockIdx * BLOCK_SIZE;
-                int endIdx = qMin(startIdx + BLOCK_SIZE, totalPixels);
-
-                for (int i = startIdx; i < endIdx; ++i)
-                {
-                    dstData[i] = static_cast<quint16>(accumulateBuffer[i] * invCount);
-                }
-            });
-        averageFutures.append(future);
+        return QImage();
     }
 
-    for (auto& future : averageFutures)
-        future.waitForFinished();
-
-    qint64 averageTime = QDateTime::currentMSecsSinceEpoch() - averageStartTime;
     qint64 totalTime = QDateTime::currentMSecsSinceEpoch() - startTime;
-
-    qDebug() << "[叠加] 完成 - 总耗时:" << totalTime << "ms, 累加:" << accumulateTime << "ms ("
-             << (100.0 * accumulateTime / totalTime) << "%), 平均:" << averageTime << "ms ("
-             << (100.0 * averageTime / totalTime) << "%), 并行度:" << blockCount
-             << "块, 吞吐量:" << (totalPixels / (totalTime / 1000.0) / 1e6)
-             << "MPixels/s, 每像素:" << (double(totalTime) * 1000.0 / totalPixels) << "us";
+    qDebug() << "[叠加] 完成 - 方式:" << XImageStacker::methodName(stackOptions.method) << ", 总耗时:" << totalTime
+             << "ms, 线程:" << (XTileExecutor::Instance().workerCount() + 1)
+             << ", 吞吐量:" << (totalPixels / (std::max<qint64>(1, totalTime) / 1000.0) / 1e6) << "MPixels/s";
 
     return result;
 }
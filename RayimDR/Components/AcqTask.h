@@ -2,8 +2,24 @@
 
 #include <QThread>
 #include <QPointer>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QPromise>
+
+#include <memory>
 
 #include "XGlobal.h"
+#include "XExposureOrchestrator.h"
+#include "XFrameMeta.h"
+#include "XFrameRateMonitor.h"
+#include "XProjectionStack.h"
+#include "XStackSnrMonitor.h"
+#include "ImageRender/XFrameRegistration.h"
+#include "ImageRender/XHdrFusion.h"
+#include "ImageRender/XImageBinning.h"
+#include "ImageRender/XImageFilterChain.h"
+#include "ImageRender/XImageStacker.h"
 
 class AcqTask : public QThread
 {
@@ -22,16 +38,91 @@ protected:
 private:
     void onImageReceived(QImage image, int idx, int grayValue);
     QImage stackImages(const QVector<QImage>& images);
-    void processStackedFrames(const QVector<QImage>& imagesToStack);
+    void processStackedFrames(const QVector<QImage>& imagesToStack, const QVector<XFrameMeta>& metas,
+                              const QVector<QFuture<XFrameRegistration::Result>>& registered = {});
+    void submitRegistration(const QImage& image);
+    void startAlignment(std::shared_ptr<const XFrameRegistration::Reference> reference, const QImage& image,
+                        std::shared_ptr<QPromise<XFrameRegistration::Result>> promise);
+    void acquireHdrBracket();
+    void queueHdrStack(const QVector<QImage>& imagesToStack, const QVector<XFrameMeta>& metas);
+    void processProjection(const QVector<QImage>& imagesToStack, const QVector<XFrameMeta>& metas, int projectionIdx);
+    void finishProjectionStack();
     void onErrorOccurred(const QString& msg);
     void onProgressChanged(const QString& msg);
 
     // Helper methods for code reusability
     QImage applyImageTransform(const QImage& image);
-    void saveStackedImage(const QImage& stackedImage, int frameIndex);
+    void applySoftCorrection(QImage& image);
+    QString saveStackedImage(const QImage& stackedImage, int frameIndex);
+    void writeFrameMeta();
 
     AcqCondition acqCondition;
     std::atomic_bool bStopRequested{false};
     std::atomic_int nReceivedIdx{0};
     std::atomic_int nProcessedStacekd{0};
+    std::atomic_bool bSoftCorrection{false};
+    std::atomic_bool bDefectCorrection{false};
+
+    XExposureOrchestrator exposureOrchestrator;
+
+    // 逐帧元数据：pendingMeta 与 stackedImageList 一一对应，叠加保存后并入 frameMetaLog
+    bool bRecordMeta{false};
+    QElapsedTimer acqClock;
+    QVector<XFrameMeta> pendingMeta;
+    QMutex metaMutex;
+    QVector<XFrameMeta> frameMetaLog;
+    std::atomic_bool bMetaWritten{false};
+
+    // 实时预览时在叠加前做软件合并 / ROI 裁剪，此时软件校正在合并前逐帧进行
+    bool bPreviewBinning{false};
+    XImageBinning::Options previewOptions;
+
+    XImageStacker::Options stackOptions;
+    XImageFilterChain filterChain;
+    bool bFilterOnSave{false};
+
+    // 自适应叠加：组内帧数由在线信噪比决定，达到目标或 MAX_STACKED_NUM 即结束该组
+    bool bAdaptiveStack{false};
+    XStackSnrMonitor snrMonitor;
+    std::atomic_int nStackGroups{0};
+    std::atomic_int nAdaptiveFrames{0};
+    // 尚在后台叠加 / 保存的组数，提前停止时等它们写完元数据再输出 CSV
+    std::atomic_int nStacksInFlight{0};
+
+    // 叠加前配准：子帧到达时即在线程池中校正并对齐到组内首帧，组满时只需等待尚未完成的帧
+    // 参考未生成时到达的子帧挂在本组的 pending 中，由生成参考的任务统一提交，线程池任务之间不互相阻塞等待
+    struct PendingAlignment
+    {
+        QImage image;
+        std::shared_ptr<QPromise<XFrameRegistration::Result>> promise;
+    };
+    struct RegistrationGroup
+    {
+        QMutex mutex;
+        bool ready{false};
+        std::shared_ptr<const XFrameRegistration::Reference> reference;
+        QVector<PendingAlignment> pending;
+    };
+    bool bRegistration{false};
+    XFrameRegistration::Options registrationOptions;
+    std::shared_ptr<RegistrationGroup> registrationGroup;
+    QFuture<void> registrationReference;
+    QVector<QFuture<XFrameRegistration::Result>> registeredFrames;
+
+    // HDR：探测器持续采集，采集线程逐档切换射线，每档叠加一组；切换期间与切换后 skipFrames 帧丢弃
+    bool bHdr{false};
+    XHdrFusion::Options hdrOptions;
+    std::atomic_bool bHdrCollecting{false};
+    std::atomic_int nHdrSkip{0};
+    QMutex hdrMutex;
+    QVector<QFuture<QImage>> hdrStacks;
+    QVector<XFrameMeta> hdrMetas;
+
+    XFrameRateMonitor frameRateMonitor;
+    QElapsedTimer frameRateReportTimer;
+
+    // CT：投影按序号流式写入投影文件，不在内存中保留整个序列
+    XProjectionStackWriter projectionWriter;
+    std::atomic_int nProjectionsInFlight{0};
+    std::atomic<qint64> lastProjectionPreviewMs{0};
 };
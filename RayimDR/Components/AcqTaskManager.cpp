@@ -37,6 +37,16 @@ void AcqTaskManager::startAcq()
         return;
     }
 
+    const XSharedFramePublisher::Options shmOptions = XSharedFramePublisher::Options::fromConfig();
+    if (!shmOptions.enabled)
+    {
+        framePublisher.close();
+    }
+    else if (!framePublisher.open(shmOptions))
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("共享内存帧发布开启失败，本次采集不发布，详见日志");
+    }
+
     acquiring.store(true);
     acqTask = new AcqTask(*acqCondition);
 
@@ -45,6 +55,10 @@ void AcqTaskManager::startAcq()
             [this]()
             {
                 acquiring.store(false);
+                if (framePublisher.isOpen())
+                {
+                    qInfo() << "[共享内存]" << framePublisher.statusText();
+                }
                 delete acqTask;
                 acqTask = nullptr;
                 emit AcqTaskManager::Instance().signalAcqTaskStopped();
@@ -69,6 +83,15 @@ bool AcqTaskManager::isAcquiring() const
     return acquiring.load();
 }
 
+void AcqTaskManager::publishStackedFrame(const AcqCondition& condition, int frameIdx, const QImage& image,
+                                         bool filtered)
+{
+    if (framePublisher.isOpen())
+    {
+        framePublisher.publish(image, condition, frameIdx, filtered);
+    }
+}
+
 void AcqTaskManager::updateAcqCond(const AcqCondition& acqCond)
 {
     *acqCondition = acqCond;
@@ -4,6 +4,7 @@
 #include <QImage>
 
 #include "XGlobal.h"
+#include "XSharedFramePublisher.h"
 
 class QThread;
 class AcqTask;
@@ -33,12 +34,17 @@ public:
     void updateAcqStackedFrame(int stackedFrame);
     void updateAcqDetMode(std::string mode);
 
+    // 由采集线程在保存叠加结果时调用，发布与写入文件相同的数据
+    void publishStackedFrame(const AcqCondition& condition, int frameIdx, const QImage& image, bool filtered);
+
 signals:
     void acqTaskFrameReceived(AcqCondition condition, int frameIdx, int subFrameIdx, QImage image);
     void acqTaskFrameStacked(AcqCondition condition, int frameIdx, QImage stackedImage);
     void signalAcqTaskStopped();
     void signalAcqErr(const QString& msg);
     void signalAcqProgressChanged(const QString& msg);
+    // 实际出帧帧率 / 抖动 / 丢帧，采集中定期发出，结束时发出汇总
+    void signalFrameRateChanged(const QString& msg);
 
 private:
     std::atomic_bool acquiring{false};
@@ -47,5 +53,8 @@ private:
 
     QVector<QImage> stackedImageList;
 
+    // 叠加完成的帧写入共享内存环形缓冲，映射跨采集保持
+    XSharedFramePublisher framePublisher;
+
     friend class AcqTask;
 };
@@ -0,0 +1,104 @@
+#include "XExposureController.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "XGlobal.h"
+
+XExposureController::Config XExposureController::Config::fromConfig()
+{
+    Config config;
+    config.minCurrent = xGlobal.getInt("XRAY", "XRAY_MIN_CURRENT", config.minCurrent);
+    config.maxCurrent = xGlobal.getInt("XRAY", "XRAY_MAX_CURRENT", config.maxCurrent);
+    config.currentStep = std::max(1, xGlobal.getInt("EXPOSURE", "EXPOSURE_CURRENT_STEP", config.currentStep));
+    config.tolerance = xGlobal.getDouble("EXPOSURE", "EXPOSURE_GRAY_TOLERANCE", config.tolerance);
+    config.maxIterations = xGlobal.getInt("EXPOSURE", "EXPOSURE_MAX_ITERATIONS", config.maxIterations);
+    config.darkGray = xGlobal.getInt("EXPOSURE", "EXPOSURE_DARK_GRAY", config.darkGray);
+    return config;
+}
+
+XExposureController::XExposureController(const Config& config) : cfg(config) {}
+
+int XExposureController::clampCurrent(double uA) const
+{
+    const int rounded = static_cast<int>(std::lround(uA / cfg.currentStep)) * cfg.currentStep;
+    return std::clamp(rounded, cfg.minCurrent, cfg.maxCurrent);
+}
+
+bool XExposureController::inBand(int gray, int targetGray) const
+{
+    return std::abs(gray - targetGray) <= cfg.tolerance * targetGray;
+}
+
+XExposureController::Result XExposureController::search(int startCurrent, int targetGray,
+                                                        const SetCurrentFn& setCurrent,
+                                                        const MeasureFn& measure) const
+{
+    Result result;
+    result.current = clampCurrent(startCurrent);
+
+    if (!setCurrent(result.current))
+    {
+        qWarning() << "[Exposure] Failed to set initial current:" << result.current << "uA";
+        return result;
+    }
+
+    // 最近两次测量点 (I, gray)，用于割线修正
+    double prevCurrent = 0.0;
+    double prevGray = 0.0;
+    bool hasPrev = false;
+
+    while (true)
+    {
+        const int gray = measure();
+        ++result.iterations;
+        if (gray < 0)
+        {
+            qWarning() << "[Exposure] Measurement aborted at" << result.current << "uA";
+            result.aborted = true;
+            return result;
+        }
+        result.gray = gray;
+
+        qDebug() << "[Exposure] Iteration" << result.iterations << "- Current:" << result.current
+                 << "uA, Gray:" << gray << ", Target:" << targetGray;
+
+        if (inBand(gray, targetGray))
+        {
+            result.converged = true;
+            return result;
+        }
+
+        // 斜率：有两点时用割线，否则假设过 (0, darkGray) 的正比模型
+        double slope = 0.0;
+        if (hasPrev && std::abs(result.current - prevCurrent) > 0.5)
+            slope = (gray - prevGray) / (result.current - prevCurrent);
+        if (slope <= 0.0)
+            slope = std::max(1.0, static_cast<double>(gray - cfg.darkGray)) / result.current;
+
+        const int next = clampCurrent(result.current + (targetGray - gray) / slope);
+        if (next == result.current)
+        {
+            // 已到电流上下限或分辨率不足，无法继续逼近
+            qWarning() << "[Exposure] Current saturated at" << next << "uA, gray" << gray << "target" << targetGray;
+            return result;
+        }
+
+        if (result.iterations >= cfg.maxIterations)
+            break;
+
+        prevCurrent = result.current;
+        prevGray = gray;
+        hasPrev = true;
+
+        if (!setCurrent(next))
+        {
+            qWarning() << "[Exposure] Failed to set current:" << next << "uA";
+            return result;
+        }
+        result.current = next;
+    }
+
+    qWarning() << "[Exposure] Not converged after" << result.iterations << "iterations";
+    return result;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <functional>
+
+#include <qdebug.h>
+
+/**
+ * @brief 基于模型的管电流闭环搜索
+ *
+ * 固定电压下探测器灰度与管电流近似线性：gray = a * I + b。
+ * 先用一次测量结合暗场灰度按比例预测，再用最近两次测量做割线修正，通常 2~3 步即可进入容差带，
+ * 替代逐级 +100uA 并长时间等待的爬坡方式。
+ *
+ * 设电流与测量通过回调注入，控制器本身不依赖射线源或探测器，可在任意线程调用。
+ */
+class XExposureController
+{
+public:
+    struct Config
+    {
+        int minCurrent{200};     // uA
+        int maxCurrent{1000};    // uA
+        int currentStep{10};     // 电流分辨率，预测值按此取整
+        double tolerance{0.05};  // 目标灰度的相对容差
+        int maxIterations{6};
+        int darkGray{0};  // 无射线时的灰度，作为单点预测的截距
+
+        static Config fromConfig();
+    };
+
+    struct Result
+    {
+        bool converged{false};
+        bool aborted{false};
+        int current{0};
+        int gray{-1};
+        int iterations{0};
+    };
+
+    // 设置电流，失败返回 false
+    using SetCurrentFn = std::function<bool(int uA)>;
+    // 在新电流下等待稳定后返回灰度，中止或超时返回负值
+    using MeasureFn = std::function<int()>;
+
+    explicit XExposureController(const Config& config = Config::fromConfig());
+
+    Result search(int startCurrent, int targetGray, const SetCurrentFn& setCurrent, const MeasureFn& measure) const;
+
+private:
+    int clampCurrent(double uA) const;
+    bool inBand(int gray, int targetGray) const;
+
+    Config cfg;
+};
+
+inline QDebug operator<<(QDebug debug, const XExposureController::Result& result)
+{
+    QDebugStateSaver saver(debug);
+    debug.nospace() << "ExposureResult(converged=" << result.converged << ", aborted=" << result.aborted
+                    << ", current=" << result.current << "uA, gray=" << result.gray
+                    << ", iterations=" << result.iterations << ")";
+    return debug;
+}
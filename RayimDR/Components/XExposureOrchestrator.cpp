@@ -0,0 +1,122 @@
+#include "XExposureOrchestrator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "XGlobal.h"
+#include "VJXRAY/IXS120BP120P366.h"
+
+XExposureOrchestrator::Config XExposureOrchestrator::Config::fromConfig()
+{
+    Config config;
+    config.voltageTolerance = xGlobal.getDouble("EXPOSURE", "EXPOSURE_VOLTAGE_TOLERANCE", config.voltageTolerance);
+    config.currentTolerance = xGlobal.getDouble("EXPOSURE", "EXPOSURE_CURRENT_TOLERANCE", config.currentTolerance);
+    config.settledSamples = std::max(1, xGlobal.getInt("EXPOSURE", "EXPOSURE_SETTLED_SAMPLES", config.settledSamples));
+    config.rampTimeoutMs = xGlobal.getInt("EXPOSURE", "EXPOSURE_RAMP_TIMEOUT_MS", config.rampTimeoutMs);
+    return config;
+}
+
+XExposureOrchestrator::XExposureOrchestrator(const Config& config) : cfg(config) {}
+
+bool XExposureOrchestrator::beamOn(int voltage, int current, const AbortFn& aborted, QString& errMsg)
+{
+    auto& source = IXS120BP120P366::Instance();
+    rampElapsedMs = -1;
+
+    // 只统计开启之后的轮询结果，避免使用关闭状态下的旧读数
+    auto connection =
+        QObject::connect(&source, &IXS120BP120P366::statusPolled, [this]() { pollCount.fetch_add(1); });
+
+    QElapsedTimer timer;
+    timer.start();
+
+    auto voltageFuture = source.setVoltageAsync(voltage);
+    auto currentFuture = source.setCurrentAsync(current);
+    auto startFuture = source.startXRayAsync();
+    beamOwned.store(true);
+
+    bool ok = voltageFuture.result() && currentFuture.result() && startFuture.result();
+    if (!ok)
+    {
+        errMsg = "开启射线源失败";
+    }
+
+    const int firstPoll = pollCount.load();
+    int lastSeen = firstPoll;
+    int settledCount = 0;
+    while (ok)
+    {
+        if (aborted && aborted())
+        {
+            ok = false;
+            break;
+        }
+
+        if (!source.isConnected())
+        {
+            errMsg = "射线源连接断开";
+            ok = false;
+            break;
+        }
+
+        if (timer.elapsed() > cfg.rampTimeoutMs)
+        {
+            const XRaySourceStatus status = source.getCurrentStatus();
+            errMsg = QString("射线源电压 / 电流未能稳定 (目标 %1kV / %2uA，实际 %3kV / %4uA)")
+                         .arg(voltage)
+                         .arg(current)
+                         .arg(status.voltage, 0, 'f', 1)
+                         .arg(status.current * 1000.0, 0, 'f', 0);
+            ok = false;
+            break;
+        }
+
+        const int seen = pollCount.load();
+        if (seen == lastSeen)
+        {
+            QThread::msleep(5);
+            continue;
+        }
+        lastSeen = seen;
+
+        const XRaySourceStatus status = source.getCurrentStatus();
+        if (std::any_of(status.faultBits.begin(), status.faultBits.end(), [](int bit) { return bit != 0; }))
+        {
+            errMsg = "射线源报告故障";
+            ok = false;
+            break;
+        }
+
+        const bool inBand = std::abs(status.voltage - voltage) <= cfg.voltageTolerance &&
+                            std::abs(status.current * 1000.0 - current) <= cfg.currentTolerance;
+        settledCount = inBand ? settledCount + 1 : 0;
+        if (settledCount >= cfg.settledSamples)
+        {
+            rampElapsedMs = timer.elapsed();
+            qDebug() << "[Exposure] Beam settled at" << status.voltage << "kV," << status.current * 1000.0 << "uA after"
+                     << rampElapsedMs << "ms," << (seen - firstPoll) << "polls";
+            break;
+        }
+    }
+
+    QObject::disconnect(connection);
+    if (!ok)
+    {
+        qWarning() << "[Exposure] Beam on failed:" << (errMsg.isEmpty() ? QString("aborted") : errMsg);
+        beamOff();
+    }
+    return ok;
+}
+
+void XExposureOrchestrator::beamOff()
+{
+    if (beamOwned.exchange(false))
+    {
+        qDebug() << "[Exposure] Beam off";
+        IXS120BP120P366::Instance().stopXRayAsync();
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include <QString>
+
+/**
+ * @brief 采集与出束同步
+ *
+ * 由采集流程开启射线时使用：下发电压 / 电流并开启射线后，持续观察 MON 轮询读数，
+ * 直到 kV / uA 进入容差后才允许探测器开始采集，替代按 PTST 固定等待；
+ * 最后一帧到达后立即关闭射线，缩短出束时间。
+ *
+ * beamOn() 会阻塞等待，只能在采集线程调用；beamOff() 不等待应答，可在任意线程重复调用。
+ */
+class XExposureOrchestrator
+{
+public:
+    struct Config
+    {
+        double voltageTolerance{1.0};  // kV
+        double currentTolerance{10.0};  // uA
+        int settledSamples{2};          // 连续满足容差的轮询次数
+        int rampTimeoutMs{30000};
+
+        static Config fromConfig();
+    };
+
+    // 返回 true 表示采集已被取消
+    using AbortFn = std::function<bool()>;
+
+    explicit XExposureOrchestrator(const Config& config = Config::fromConfig());
+
+    // 开启射线并等待读数稳定，失败或取消时射线已关闭，失败原因写入 errMsg
+    bool beamOn(int voltage, int current, const AbortFn& aborted, QString& errMsg);
+    void beamOff();
+
+    bool ownsBeam() const { return beamOwned.load(); }
+    // 从下发开启到读数稳定的耗时，未成功时为 -1
+    qint64 rampMs() const { return rampElapsedMs; }
+
+private:
+    Config cfg;
+    std::atomic_bool beamOwned{false};
+    std::atomic_int pollCount{0};
+    qint64 rampElapsedMs{-1};
+};
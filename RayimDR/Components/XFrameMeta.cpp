@@ -0,0 +1,73 @@
+#include "XFrameMeta.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QDebug>
+
+XFrameMeta XFrameMetaLog::average(const QVector<XFrameMeta>& group)
+{
+    XFrameMeta result;
+    if (group.isEmpty())
+    {
+        return result;
+    }
+
+    result = group.first();
+    double voltage = 0.0;
+    double current = 0.0;
+    double gray = 0.0;
+    for (const XFrameMeta& meta : group)
+    {
+        voltage += meta.xray.voltage;
+        current += meta.xray.current;
+        gray += meta.grayValue;
+    }
+    result.xray.voltage = voltage / group.size();
+    result.xray.current = current / group.size();
+    result.grayValue = static_cast<int>(gray / group.size() + 0.5);
+    return result;
+}
+
+bool XFrameMetaLog::writeCsv(const QString& path, const QString& mode, const QVector<XFrameMeta>& rows)
+{
+    // 先在内存中拼好，整体一次写入
+    QByteArray text;
+    text.reserve(64 + rows.size() * 128);
+    text.append("stack,sub,det_idx,t_us,mode,gray,kv,ua,temp_c,filament_a,vdc,interlock,faults,file\n");
+
+    const QByteArray modeUtf8 = mode.toUtf8();
+    for (const XFrameMeta& meta : rows)
+    {
+        QByteArray faults;
+        for (int bit : meta.xray.faultBits)
+        {
+            faults.append(bit ? '1' : '0');
+        }
+
+        text.append(QByteArray::number(meta.stackIdx)).append(',');
+        text.append(QByteArray::number(meta.subFrameIdx)).append(',');
+        text.append(QByteArray::number(meta.detIdx)).append(',');
+        text.append(QByteArray::number(meta.timestampUs)).append(',');
+        text.append(modeUtf8).append(',');
+        text.append(QByteArray::number(meta.grayValue)).append(',');
+        text.append(QByteArray::number(meta.xray.voltage, 'f', 2)).append(',');
+        text.append(QByteArray::number(meta.xray.current * 1000.0, 'f', 1)).append(',');
+        text.append(QByteArray::number(meta.xray.temperature, 'f', 1)).append(',');
+        text.append(QByteArray::number(meta.xray.filamentCurrent, 'f', 3)).append(',');
+        text.append(QByteArray::number(meta.xray.vdc, 'f', 2)).append(',');
+        text.append(QByteArray::number(meta.xray.interlock)).append(',');
+        text.append(faults).append(',');
+        text.append(meta.fileName.toUtf8()).append('\n');
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "[元数据] 无法写入:" << path << file.errorString();
+        return false;
+    }
+    const bool ok = file.write(text) == text.size();
+    file.close();
+    qDebug() << "[元数据] 写入" << rows.size() << "行:" << path << (ok ? "成功" : "失败");
+    return ok;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+#include "VJXRAY/IXS120BP120P366.h"
+
+/**
+ * @brief 单帧采集元数据
+ *
+ * 在接收原始帧时记录：采集开始后的单调时间戳、所属叠加组与组内序号、探测器模式、
+ * 当时的射线源状态快照（无锁读取）以及探测器给出的灰度。
+ * 采集过程中只追加到内存，采集结束后与保存的图像一起一次性写成 CSV 旁路文件，
+ * 不产生逐帧文件 I/O。
+ */
+struct XFrameMeta
+{
+    qint64 timestampUs{0};  // 相对采集开始
+    int detIdx{-1};         // 探测器帧序号
+    int stackIdx{0};        // 所属叠加结果序号
+    int subFrameIdx{0};     // 叠加组内序号
+    int grayValue{0};
+    XRaySourceStatus xray;
+    QString fileName;  // 叠加结果保存后的文件名，未保存时为空
+};
+
+namespace XFrameMetaLog
+{
+// 叠加组的平均电压 / 电流 / 灰度，用于日志输出
+XFrameMeta average(const QVector<XFrameMeta>& group);
+
+// 写入 CSV（覆盖），mode 为本次采集的探测器模式
+bool writeCsv(const QString& path, const QString& mode, const QVector<XFrameMeta>& rows);
+}  // namespace XFrameMetaLog
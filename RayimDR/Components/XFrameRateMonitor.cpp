@@ -0,0 +1,120 @@
+#include "XFrameRateMonitor.h"
+
+#include <algorithm>
+#include <cmath>
+
+XFrameRateMonitor::XFrameRateMonitor(int windowSize) : intervals(std::max(2, windowSize), 0) {}
+
+void XFrameRateMonitor::reset(double targetFps)
+{
+    QMutexLocker locker(&mutex);
+    std::fill(intervals.begin(), intervals.end(), 0);
+    head = 0;
+    filled = 0;
+    sum = 0.0;
+    sumSq = 0.0;
+    current = Stats();
+    current.targetFps = targetFps;
+    lastIdx = -1;
+    lastTimestampUs = -1;
+    firstTimestampUs = -1;
+}
+
+void XFrameRateMonitor::onFrame(int idx, qint64 timestampUs)
+{
+    QMutexLocker locker(&mutex);
+    ++current.received;
+
+    if (lastIdx >= 0)
+    {
+        if (idx == lastIdx)
+        {
+            ++current.duplicated;
+        }
+        else if (idx < lastIdx)
+        {
+            ++current.outOfOrder;
+        }
+        else if (idx > lastIdx + 1)
+        {
+            current.dropped += idx - lastIdx - 1;
+        }
+    }
+    lastIdx = std::max(lastIdx, idx);
+
+    if (firstTimestampUs < 0)
+    {
+        firstTimestampUs = timestampUs;
+    }
+
+    if (lastTimestampUs >= 0)
+    {
+        const qint64 interval = timestampUs - lastTimestampUs;
+        const int size = static_cast<int>(intervals.size());
+
+        // 窗口已满时先移除最旧的间隔
+        if (filled == size)
+        {
+            const double old = static_cast<double>(intervals[head]);
+            sum -= old;
+            sumSq -= old * old;
+        }
+        else
+        {
+            ++filled;
+        }
+        intervals[head] = interval;
+        head = (head + 1) % size;
+        sum += interval;
+        sumSq += static_cast<double>(interval) * interval;
+
+        const double mean = sum / filled;
+        current.meanIntervalMs = mean / 1000.0;
+        current.fps = mean > 0.0 ? 1e6 / mean : 0.0;
+        current.jitterMs = std::sqrt(std::max(0.0, sumSq / filled - mean * mean)) / 1000.0;
+        current.maxIntervalMs = std::max(current.maxIntervalMs, interval / 1000.0);
+    }
+    lastTimestampUs = timestampUs;
+}
+
+XFrameRateMonitor::Stats XFrameRateMonitor::stats() const
+{
+    QMutexLocker locker(&mutex);
+    return current;
+}
+
+QString XFrameRateMonitor::statusText() const
+{
+    const Stats s = stats();
+    return QString("帧率 %1/%2 fps, 抖动 %3 ms, 丢帧 %4")
+        .arg(s.fps, 0, 'f', 1)
+        .arg(s.targetFps, 0, 'f', 0)
+        .arg(s.jitterMs, 0, 'f', 1)
+        .arg(s.dropped);
+}
+
+QString XFrameRateMonitor::summary() const
+{
+    Stats s;
+    double overallFps = 0.0;
+    {
+        QMutexLocker locker(&mutex);
+        s = current;
+        if (s.received > 1 && lastTimestampUs > firstTimestampUs)
+        {
+            overallFps = (s.received - 1) * 1e6 / (lastTimestampUs - firstTimestampUs);
+        }
+    }
+
+    return QString("接收 %1 帧, 平均帧率 %2 fps (设定 %3), 最近帧率 %4 fps, 抖动 %5 ms, 最大间隔 %6 ms, "
+                   "丢帧 %7, 重复 %8, 乱序 %9")
+        .arg(s.received)
+        .arg(overallFps, 0, 'f', 2)
+        .arg(s.targetFps, 0, 'f', 0)
+        .arg(s.fps, 0, 'f', 2)
+        .arg(s.jitterMs, 0, 'f', 2)
+        .arg(s.maxIntervalMs, 0, 'f', 1)
+        .arg(s.dropped)
+        .arg(s.duplicated)
+        .arg(s.outOfOrder);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief 探测器实际出帧监控
+ *
+ * 每收到一帧调用 onFrame()，记录到达间隔并检查探测器帧序号：
+ * 序号跳变计为丢帧，重复序号计为重复帧，回退计为乱序。
+ * 帧率与抖动（间隔标准差）按最近 windowSize 个间隔的滑动窗口增量计算，每帧 O(1)。
+ *
+ * 到达时间取自接收槽函数，包含事件队列延迟，反映的是上位机实际拿到帧的节奏。
+ * 内部加锁，可在接收线程更新、其它线程读取。
+ */
+class XFrameRateMonitor
+{
+public:
+    struct Stats
+    {
+        int received{0};
+        int dropped{0};
+        int duplicated{0};
+        int outOfOrder{0};
+        double targetFps{0.0};
+        double fps{0.0};            // 窗口内平均帧率
+        double meanIntervalMs{0.0};
+        double jitterMs{0.0};       // 窗口内间隔标准差
+        double maxIntervalMs{0.0};  // 整次采集的最大间隔
+    };
+
+    explicit XFrameRateMonitor(int windowSize = 32);
+
+    void reset(double targetFps);
+    void onFrame(int idx, qint64 timestampUs);
+
+    Stats stats() const;
+    // 状态栏用的简短文本
+    QString statusText() const;
+    // 采集结束时的汇总
+    QString summary() const;
+
+private:
+    mutable QMutex mutex;
+
+    std::vector<qint64> intervals;  // 环形缓冲，单位 us
+    int head{0};
+    int filled{0};
+    double sum{0.0};
+    double sumSq{0.0};
+
+    Stats current;
+    int lastIdx{-1};
+    qint64 lastTimestampUs{-1};
+    qint64 firstTimestampUs{-1};
+};
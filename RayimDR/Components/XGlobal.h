@@ -12,11 +12,15 @@ struct AcqCondition
 {
     AcqType acqType{AcqType::DR};
     int voltage{40};   // kV
-    int current{100};  // mA
+    int current{100};  // uA
     int frameRate{10};
     int frame{10};              // 帧数
     int stackedFrame{0};        // 叠加帧数
     std::string mode{"Mode5"};  // 1x1 2x2 3x3 4x4
+    bool autoXRay{false};       // 由采集流程开启射线，读数稳定后再采集，最后一帧到达后关闭
+    double startAngle{0.0};     // CT：第一个投影的角度（度）
+    double angleStep{0.0};      // CT：相邻投影的角度步进（度）
+    bool hdr{false};            // DR：按 [HDR] HDR_BRACKET 逐档出束叠加后融合为一幅
 
     bool saveToFiles{false};
     QString savePath;
@@ -45,10 +49,19 @@ inline QDebug operator<<(QDebug debug, const AcqCondition& cond)
     QDebugStateSaver saver(debug);  // 保存debug状态，确保自动恢复格式
     debug.nospace() << "AcqCondition("
                     << "Type=" << acqTypeStr << ", Voltage=" << cond.voltage << "kV"
-                    << ", Current=" << cond.current << "mA"
+                    << ", Current=" << cond.current << "uA"
                     << ", FrameRate=" << cond.frameRate << "fps"
                     << ", Frames=" << cond.frame << ", StackedFrames=" << cond.stackedFrame
-                    << ", DetMode=" << cond.mode.c_str() << ")";
+                    << ", DetMode=" << cond.mode.c_str() << ", AutoXRay=" << cond.autoXRay;
+    if (cond.acqType == AcqType::CT)
+    {
+        debug << ", StartAngle=" << cond.startAngle << ", AngleStep=" << cond.angleStep;
+    }
+    if (cond.hdr)
+    {
+        debug << ", HDR=true";
+    }
+    debug << ")";
 
     return debug;
 }
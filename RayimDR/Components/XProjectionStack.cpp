@@ -0,0 +1,338 @@
+#include "XProjectionStack.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include <QDebug>
+
+namespace
+{
+constexpr quint32 FILE_VERSION = 1;
+}  // namespace
+
+XProjectionStackWriter::~XProjectionStackWriter()
+{
+    if (writer.joinable())
+    {
+        close();
+    }
+}
+
+bool XProjectionStackWriter::open(const QString& filePath, int width, int height, double startAngle, double angleStep,
+                                  int queueDepth)
+{
+    if (writer.joinable())
+    {
+        qWarning() << "[CT] 投影文件已打开:" << path;
+        return false;
+    }
+    if (width <= 0 || height <= 0)
+    {
+        qWarning() << "[CT] 投影尺寸无效:" << width << "x" << height;
+        return false;
+    }
+
+    path = filePath;
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "[CT] 无法创建投影文件:" << filePath << file.errorString();
+        return false;
+    }
+
+    std::memcpy(header.magic, "XPRJ", 4);
+    header.version = FILE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.count = 0;
+    header.reserved = 0;
+    header.startAngle = startAngle;
+    header.angleStep = angleStep;
+    if (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header))
+    {
+        qWarning() << "[CT] 写入文件头失败:" << filePath << file.errorString();
+        file.close();
+        return false;
+    }
+
+    depth = std::max(1, queueDepth);
+    pending.clear();
+    nextIndex = 0;
+    closing = false;
+    failed = false;
+    error.clear();
+    current = Stats();
+    clock.start();
+    running = true;
+
+    writer = std::thread([this]() { writerLoop(); });
+    qDebug() << "[CT] 投影文件已创建:" << filePath << ", 尺寸:" << width << "x" << height << ", 起始角度:" << startAngle
+             << ", 步进:" << angleStep << ", 队列深度:" << depth;
+    return true;
+}
+
+bool XProjectionStackWriter::isOpen() const
+{
+    QMutexLocker locker(&mutex);
+    return running;
+}
+
+bool XProjectionStackWriter::append(int index, const QImage& image, double angle, const XFrameMeta& meta)
+{
+    if (image.format() != QImage::Format_Grayscale16 || image.width() != header.width ||
+        image.height() != header.height)
+    {
+        qWarning() << "[CT] 投影" << index << "格式或尺寸" << image.format() << image.size() << "与文件"
+                   << header.width << "x" << header.height << "不一致, 跳过";
+        skip(index);
+        return true;
+    }
+
+    Entry entry;
+    entry.image = image;
+    entry.record.index = index;
+    entry.record.grayValue = meta.grayValue;
+    entry.record.timestampUs = meta.timestampUs;
+    entry.record.angle = angle;
+    entry.record.voltage = meta.xray.voltage;
+    entry.record.current = meta.xray.current * 1000.0;  // 状态读数为 mA
+
+    QMutexLocker locker(&mutex);
+    while (!failed && !closing && index >= nextIndex + depth)
+    {
+        spaceAvailable.wait(&mutex);
+    }
+    if (failed || closing)
+    {
+        return false;
+    }
+    if (index < nextIndex || pending.count(index))
+    {
+        qWarning() << "[CT] 重复的投影序号:" << index << ", 忽略";
+        return true;
+    }
+
+    pending.emplace(index, std::move(entry));
+    entryAdded.wakeAll();
+    return true;
+}
+
+void XProjectionStackWriter::skip(int index)
+{
+    QMutexLocker locker(&mutex);
+    if (index < nextIndex || pending.count(index))
+    {
+        return;
+    }
+    Entry entry;
+    entry.skipped = true;
+    entry.record.index = index;
+    pending.emplace(index, std::move(entry));
+    entryAdded.wakeAll();
+}
+
+void XProjectionStackWriter::writerLoop()
+{
+    QMutexLocker locker(&mutex);
+    while (true)
+    {
+        // 按序号顺序写入；关闭时把剩余投影按序写完，缺失的序号不再等待
+        while (!failed && !closing && (pending.empty() || pending.begin()->first != nextIndex))
+        {
+            entryAdded.wait(&mutex);
+        }
+        if (failed || pending.empty())
+        {
+            return;
+        }
+
+        auto it = pending.begin();
+        Entry entry = std::move(it->second);
+        nextIndex = it->first + 1;
+        pending.erase(it);
+        spaceAvailable.wakeAll();
+        locker.unlock();
+
+        const bool ok = entry.skipped || writeEntry(entry);
+        entry.image = QImage();
+
+        locker.relock();
+        if (!ok)
+        {
+            failed = true;
+            error = QString("写入投影 %1 失败: %2").arg(entry.record.index).arg(file.errorString());
+            qCritical() << "[CT]" << error;
+            spaceAvailable.wakeAll();
+            return;
+        }
+        if (entry.skipped)
+        {
+            ++current.skipped;
+        }
+        else
+        {
+            ++current.written;
+            current.bytes += sizeof(XProjectionRecord) + static_cast<qint64>(header.width) * header.height * 2;
+        }
+    }
+}
+
+bool XProjectionStackWriter::writeEntry(const Entry& entry)
+{
+    if (file.write(reinterpret_cast<const char*>(&entry.record), sizeof(entry.record)) != sizeof(entry.record))
+    {
+        return false;
+    }
+
+    const qint64 rowBytes = static_cast<qint64>(header.width) * 2;
+    if (entry.image.bytesPerLine() == rowBytes)
+    {
+        const qint64 total = rowBytes * header.height;
+        return file.write(reinterpret_cast<const char*>(entry.image.constBits()), total) == total;
+    }
+
+    for (int y = 0; y < header.height; ++y)
+    {
+        if (file.write(reinterpret_cast<const char*>(entry.image.constScanLine(y)), rowBytes) != rowBytes)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool XProjectionStackWriter::close()
+{
+    if (!writer.joinable())
+    {
+        return !failed;
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        closing = true;
+        entryAdded.wakeAll();
+        spaceAvailable.wakeAll();
+    }
+    writer.join();
+
+    QMutexLocker locker(&mutex);
+    running = false;
+    current.elapsedSec = clock.nsecsElapsed() / 1e9;
+    header.count = current.written;
+    if (!failed)
+    {
+        if (!file.seek(offsetof(XProjectionFileHeader, count)) ||
+            file.write(reinterpret_cast<const char*>(&header.count), sizeof(header.count)) != sizeof(header.count))
+        {
+            failed = true;
+            error = QString("回写文件头失败: %1").arg(file.errorString());
+            qCritical() << "[CT]" << error;
+        }
+    }
+    file.close();
+    pending.clear();
+
+    qInfo() << "[CT] 投影文件已关闭:" << path << ", 写入:" << current.written << ", 跳过:" << current.skipped
+            << ", 数据量:" << current.bytes / 1024.0 / 1024.0 << "MB";
+    return !failed;
+}
+
+QString XProjectionStackWriter::errorString() const
+{
+    QMutexLocker locker(&mutex);
+    return error;
+}
+
+XProjectionStackWriter::Stats XProjectionStackWriter::stats() const
+{
+    QMutexLocker locker(&mutex);
+    Stats s = current;
+    if (running)
+    {
+        s.elapsedSec = clock.nsecsElapsed() / 1e9;
+    }
+    if (s.elapsedSec > 0.0)
+    {
+        s.projectionsPerSec = s.written / s.elapsedSec;
+        s.mbPerSec = s.bytes / 1024.0 / 1024.0 / s.elapsedSec;
+    }
+    return s;
+}
+
+QString XProjectionStackWriter::statusText() const
+{
+    const Stats s = stats();
+    return QString("投影 %1 | %2 投影/s | 写盘 %3 MB/s")
+        .arg(s.written)
+        .arg(s.projectionsPerSec, 0, 'f', 1)
+        .arg(s.mbPerSec, 0, 'f', 1);
+}
+
+bool XProjectionStackReader::open(const QString& filePath)
+{
+    close();
+    file.setFileName(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = QString("无法打开投影文件 %1: %2").arg(filePath).arg(file.errorString());
+        return false;
+    }
+
+    if (file.read(reinterpret_cast<char*>(&hdr), sizeof(hdr)) != sizeof(hdr) ||
+        std::memcmp(hdr.magic, "XPRJ", 4) != 0 || hdr.version != FILE_VERSION || hdr.width <= 0 || hdr.height <= 0)
+    {
+        error = QString("不是有效的投影文件: %1").arg(filePath);
+        close();
+        return false;
+    }
+
+    // 采集异常中断时文件头中的数量未回写，按文件长度恢复
+    const qint64 entryBytes = sizeof(XProjectionRecord) + static_cast<qint64>(hdr.width) * hdr.height * 2;
+    const int available = static_cast<int>((file.size() - static_cast<qint64>(sizeof(hdr))) / entryBytes);
+    if (hdr.count <= 0 || hdr.count > available)
+    {
+        qWarning() << "[CT] 投影文件头记录数量" << hdr.count << "与文件长度不符, 按" << available << "个投影读取";
+        hdr.count = available;
+    }
+    error.clear();
+    return true;
+}
+
+void XProjectionStackReader::close()
+{
+    if (file.isOpen())
+    {
+        file.close();
+    }
+    hdr = XProjectionFileHeader{};
+}
+
+bool XProjectionStackReader::read(int index, XProjectionRecord& record, quint16* dst, int rowBegin, int rowEnd)
+{
+    if (index < 0 || index >= hdr.count || rowBegin < 0 || rowEnd > hdr.height || rowBegin > rowEnd)
+    {
+        error = QString("投影 %1 行 [%2, %3) 超出范围").arg(index).arg(rowBegin).arg(rowEnd);
+        return false;
+    }
+
+    const qint64 rowBytes = static_cast<qint64>(hdr.width) * 2;
+    const qint64 entryBytes = sizeof(XProjectionRecord) + rowBytes * hdr.height;
+    const qint64 entryOffset = sizeof(XProjectionFileHeader) + entryBytes * index;
+    if (!file.seek(entryOffset) ||
+        file.read(reinterpret_cast<char*>(&record), sizeof(record)) != static_cast<qint64>(sizeof(record)))
+    {
+        error = QString("读取投影 %1 记录失败: %2").arg(index).arg(file.errorString());
+        return false;
+    }
+
+    const qint64 bytes = rowBytes * (rowEnd - rowBegin);
+    if (bytes > 0 && (!file.seek(entryOffset + sizeof(record) + rowBytes * rowBegin) ||
+                      file.read(reinterpret_cast<char*>(dst), bytes) != bytes))
+    {
+        error = QString("读取投影 %1 像素失败: %2").arg(index).arg(file.errorString());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <map>
+#include <thread>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+#include "XFrameMeta.h"
+
+/**
+ * @brief CT 投影序列文件 (.xprj)
+ *
+ * 文件头之后依次是每个投影的记录头与 16 位像素数据（行连续、无填充）：
+ *   XProjectionFileHeader | { XProjectionRecord | width*height*2 字节 } * count
+ * 记录头保存投影序号、角度与采集时的射线源读数，读取时无需额外的索引文件。
+ * 采集结束时回写文件头中的 count，中途异常退出时 count 为 0，可按文件长度恢复。
+ */
+struct XProjectionFileHeader
+{
+    char magic[4];  // "XPRJ"
+    quint32 version;
+    qint32 width;
+    qint32 height;
+    qint32 count;
+    quint32 reserved;
+    double startAngle;  // 度
+    double angleStep;   // 度
+};
+
+struct XProjectionRecord
+{
+    qint32 index;
+    qint32 grayValue;
+    qint64 timestampUs;  // 相对采集开始
+    double angle;        // 度
+    double voltage;      // kV
+    double current;      // uA
+};
+
+/**
+ * @brief 投影序列流式写入
+ *
+ * append() 只把投影放入队列，由独立线程按序号顺序写盘，采集过程中内存里只保留队列中的少量投影。
+ * 投影可能由多个线程乱序提交，写线程按序号重新排序；序号不小于 nextIndex + queueDepth 的提交方会阻塞，
+ * 保证下一个待写的投影总能入队。某个序号处理失败时调用 skip() 让后续投影继续写入。
+ */
+class XProjectionStackWriter
+{
+public:
+    struct Stats
+    {
+        int written{0};
+        int skipped{0};
+        qint64 bytes{0};
+        double elapsedSec{0.0};
+        double projectionsPerSec{0.0};
+        double mbPerSec{0.0};
+    };
+
+    XProjectionStackWriter() = default;
+    ~XProjectionStackWriter();
+
+    XProjectionStackWriter(const XProjectionStackWriter&) = delete;
+    XProjectionStackWriter& operator=(const XProjectionStackWriter&) = delete;
+
+    bool open(const QString& filePath, int width, int height, double startAngle, double angleStep,
+              int queueDepth = 8);
+    bool isOpen() const;
+
+    // 仅接受与文件尺寸一致的 16 位灰度图像；写入已失败时返回 false
+    bool append(int index, const QImage& image, double angle, const XFrameMeta& meta);
+    void skip(int index);
+
+    // 写完队列中的投影并回写文件头
+    bool close();
+
+    QString filePath() const { return path; }
+    QString errorString() const;
+    Stats stats() const;
+    // 进度栏用的简短文本
+    QString statusText() const;
+
+private:
+    struct Entry
+    {
+        bool skipped{false};
+        QImage image;
+        XProjectionRecord record{};
+    };
+
+    void writerLoop();
+    bool writeEntry(const Entry& entry);
+    void fail(const QString& msg);
+
+    QString path;
+    QFile file;
+    XProjectionFileHeader header{};
+    int depth{8};
+
+    mutable QMutex mutex;
+    QWaitCondition entryAdded;
+    QWaitCondition spaceAvailable;
+    std::map<int, Entry> pending;
+    int nextIndex{0};
+    bool running{false};
+    bool closing{false};
+    bool failed{false};
+    QString error;
+
+    std::thread writer;
+    QElapsedTimer clock;
+    Stats current;
+};
+
+/**
+ * @brief 投影序列读取，可按投影及行范围随机访问
+ *
+ * 不加锁，每个线程使用各自的读取对象。
+ */
+class XProjectionStackReader
+{
+public:
+    bool open(const QString& filePath);
+    void close();
+
+    const XProjectionFileHeader& header() const { return hdr; }
+    int count() const { return hdr.count; }
+    int width() const { return hdr.width; }
+    int height() const { return hdr.height; }
+
+    // 读取第 index 个投影的记录头以及 [rowBegin, rowEnd) 行像素，dst 至少 (rowEnd - rowBegin) * width 个元素
+    bool read(int index, XProjectionRecord& record, quint16* dst, int rowBegin, int rowEnd);
+    bool read(int index, XProjectionRecord& record, quint16* dst) { return read(index, record, dst, 0, hdr.height); }
+
+    QString errorString() const { return error; }
+
+private:
+    QFile file;
+    XProjectionFileHeader hdr{};
+    QString error;
+};
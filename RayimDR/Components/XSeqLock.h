@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#include <QThread>
+
+/**
+ * @brief 单写多读的顺序锁快照
+ *
+ * 写端递增序号后写入数据，读端在序号为偶数且前后一致时才接受拷贝，否则重试。
+ * 读写均不加锁，适合由单一线程高频发布、多个线程偶尔读取的小型状态结构。
+ * T 必须可平凡拷贝。
+ */
+template <typename T>
+class XSeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "XSeqLock requires a trivially copyable type");
+
+public:
+    XSeqLock() = default;
+    explicit XSeqLock(const T& value) : m_data(value) {}
+
+    // 只能由单一写线程调用
+    void store(const T& value)
+    {
+        const unsigned seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&m_data, &value, sizeof(T));
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const
+    {
+        T value;
+        unsigned before = 0;
+        unsigned after = 0;
+        do
+        {
+            before = m_seq.load(std::memory_order_acquire);
+            if (before & 1u)
+            {
+                QThread::yieldCurrentThread();
+                continue;
+            }
+            std::memcpy(&value, &m_data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_seq.load(std::memory_order_relaxed);
+        } while ((before & 1u) || before != after);
+        return value;
+    }
+
+    XSeqLock(const XSeqLock&) = delete;
+    XSeqLock& operator=(const XSeqLock&) = delete;
+
+private:
+    std::atomic<unsigned> m_seq{0};
+    T m_data{};
+};
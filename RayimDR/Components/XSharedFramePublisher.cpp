@@ -0,0 +1,273 @@
+#include "XSharedFramePublisher.h"
+
+#include <qcoreapplication.h>
+#include <qdebug.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "XSharedFrameRing.h"
+#include "XTileExecutor.h"
+
+#ifdef Q_OS_WIN
+#include <Windows.h>
+#endif
+
+namespace
+{
+qint64 alignUp(qint64 value, qint64 alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+struct RingGeometry
+{
+    qint64 firstSlotOffset{0};
+    qint64 payloadCapacity{0};
+    qint64 slotStride{0};
+    qint64 totalBytes{0};
+};
+
+RingGeometry geometryFor(const XSharedFramePublisher::Options& options)
+{
+    RingGeometry g;
+    g.firstSlotOffset = alignUp(sizeof(XSharedFrame::RingHeader), XSharedFrame::PAGE_SIZE);
+    g.payloadCapacity = alignUp(options.slotBytes, XSharedFrame::PAGE_SIZE);
+    g.slotStride = XSharedFrame::PAYLOAD_OFFSET + g.payloadCapacity;
+    g.totalBytes = g.firstSlotOffset + g.slotStride * options.slotCount;
+    return g;
+}
+}  // namespace
+
+XSharedFramePublisher::Options XSharedFramePublisher::Options::fromConfig()
+{
+    Options options;
+    options.enabled = xGlobal.getBool("SHM", "SHM_ENABLE", false);
+    const QString name = xGlobal.getString("SHM", "SHM_NAME", options.name).trimmed();
+    if (!name.isEmpty())
+    {
+        options.name = name;
+    }
+    options.slotCount = std::clamp(xGlobal.getInt("SHM", "SHM_SLOTS", options.slotCount), 2, 64);
+
+    const int slotMB = xGlobal.getInt("SHM", "SHM_SLOT_MB", 0);
+    options.slotBytes = slotMB > 0 ? static_cast<qint64>(slotMB) * 1024 * 1024
+                                   : static_cast<qint64>(xGlobal.getInt("DET", "DET_WIDTH_1X1")) *
+                                         xGlobal.getInt("DET", "DET_HEIGHT_1X1") * sizeof(quint16);
+    return options;
+}
+
+XSharedFramePublisher::XSharedFramePublisher() {}
+
+XSharedFramePublisher::~XSharedFramePublisher()
+{
+    close();
+}
+
+bool XSharedFramePublisher::open(const Options& options)
+{
+    QMutexLocker locker(&mutex);
+    if (options.slotBytes <= 0 || options.slotCount < 2)
+    {
+        qWarning() << "[共享内存] 槽位参数无效:" << options.slotCount << "×" << options.slotBytes << "字节";
+        return false;
+    }
+
+    const RingGeometry g = geometryFor(options);
+    if (memory.isAttached() && opts.name == options.name && opts.slotCount == options.slotCount &&
+        capacity == g.payloadCapacity)
+    {
+        opts = options;
+        return true;
+    }
+
+    closeEvents();
+    if (memory.isAttached())
+    {
+        memory.detach();
+    }
+
+    memory.setNativeKey(options.name);
+    if (!memory.create(g.totalBytes))
+    {
+        // 读端仍持有上次的映射时复用，容量不足则只能等读端释放
+        if (memory.error() != QSharedMemory::AlreadyExists || !memory.attach() || memory.size() < g.totalBytes)
+        {
+            qWarning() << "[共享内存] 创建" << options.name << "失败:" << memory.errorString()
+                       << ", 需要" << g.totalBytes / 1048576.0 << "MB";
+            if (memory.isAttached())
+            {
+                memory.detach();
+            }
+            return false;
+        }
+        qInfo() << "[共享内存] 复用已存在的映射" << options.name;
+    }
+
+    auto* ring = static_cast<XSharedFrame::RingHeader*>(memory.data());
+    ring->magic = 0;
+    ring->version = XSharedFrame::VERSION;
+    ring->slotCount = static_cast<uint32_t>(options.slotCount);
+    ring->writerPid = static_cast<uint32_t>(QCoreApplication::applicationPid());
+    ring->slotStride = static_cast<uint64_t>(g.slotStride);
+    ring->payloadCapacity = static_cast<uint64_t>(g.payloadCapacity);
+    ring->firstSlotOffset = static_cast<uint64_t>(g.firstSlotOffset);
+    ring->published.store(0, std::memory_order_relaxed);
+    // 新建的映射内容为 0，复用时在上次的基础上递增，读端据此发现序号已重新开始
+    const uint64_t generation = ring->generation.fetch_add(1, std::memory_order_release) + 1;
+    std::atomic_thread_fence(std::memory_order_release);
+    ring->magic = XSharedFrame::MAGIC;
+
+#ifdef Q_OS_WIN
+    for (int i = 0; i < 2; ++i)
+    {
+        const QString eventName = QString("%1.Ready%2").arg(options.name).arg(i);
+        readyEvents[i] = CreateEventW(nullptr, TRUE, FALSE, reinterpret_cast<LPCWSTR>(eventName.utf16()));
+        if (readyEvents[i] == nullptr)
+        {
+            qWarning() << "[共享内存] 创建通知事件失败:" << eventName << ", 读端只能轮询 published";
+        }
+    }
+#endif
+
+    opts = options;
+    capacity = g.payloadCapacity;
+    sequence.store(0);
+    dropped.store(0);
+    warnedOversize = false;
+    qInfo() << "[共享内存] 已开启" << options.name << ":" << options.slotCount << "个槽位, 每槽"
+            << g.payloadCapacity / 1048576.0 << "MB, 共" << g.totalBytes / 1048576.0 << "MB, 代次" << generation;
+    return true;
+}
+
+void XSharedFramePublisher::close()
+{
+    QMutexLocker locker(&mutex);
+    closeEvents();
+    if (memory.isAttached())
+    {
+        qInfo() << "[共享内存] 关闭" << opts.name << ", 已发布" << sequence.load() << "帧";
+        memory.detach();
+    }
+}
+
+bool XSharedFramePublisher::isOpen() const
+{
+    QMutexLocker locker(&mutex);
+    return memory.isAttached();
+}
+
+void XSharedFramePublisher::closeEvents()
+{
+#ifdef Q_OS_WIN
+    for (void*& event : readyEvents)
+    {
+        if (event != nullptr)
+        {
+            CloseHandle(event);
+            event = nullptr;
+        }
+    }
+#endif
+}
+
+bool XSharedFramePublisher::publish(const QImage& image, const AcqCondition& condition, int frameIdx, bool filtered)
+{
+    if (image.isNull())
+    {
+        return false;
+    }
+
+    QImage frame = image;
+    if (frame.format() != QImage::Format_Grayscale16 && frame.format() != QImage::Format_Grayscale8)
+    {
+        frame = frame.convertToFormat(QImage::Format_Grayscale16);
+    }
+    const bool gray16 = frame.format() == QImage::Format_Grayscale16;
+    const qsizetype rowBytes = static_cast<qsizetype>(frame.width()) * (gray16 ? 2 : 1);
+    const qint64 frameBytes = static_cast<qint64>(rowBytes) * frame.height();
+
+    QMutexLocker locker(&mutex);
+    if (!memory.isAttached())
+    {
+        return false;
+    }
+    if (frameBytes > capacity)
+    {
+        dropped.fetch_add(1);
+        if (!warnedOversize)
+        {
+            qWarning() << "[共享内存] 帧" << frame.size() << "超出槽位容量" << capacity / 1048576.0
+                       << "MB, 丢弃, 请调大 SHM_SLOT_MB";
+            warnedOversize = true;
+        }
+        return false;
+    }
+
+    uchar* base = static_cast<uchar*>(memory.data());
+    auto* ring = reinterpret_cast<XSharedFrame::RingHeader*>(base);
+    const quint64 n = sequence.load() + 1;
+    auto* slot = reinterpret_cast<XSharedFrame::SlotHeader*>(base + ring->firstSlotOffset +
+                                                             ((n - 1) % ring->slotCount) * ring->slotStride);
+
+    // 与 XSeqLock::store 相同的写序：先置奇数，再写数据，最后以 release 置回偶数
+    const uint32_t lock = slot->lock.load(std::memory_order_relaxed);
+    slot->lock.store(lock + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->format = gray16 ? XSharedFrame::Gray16 : XSharedFrame::Gray8;
+    slot->sequence = n;
+    slot->timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count();
+    slot->width = frame.width();
+    slot->height = frame.height();
+    slot->bytesPerLine = static_cast<int32_t>(rowBytes);
+    slot->frameIdx = frameIdx;
+    slot->acqType = static_cast<int32_t>(condition.acqType);
+    slot->voltage = condition.voltage;
+    slot->current = condition.current;
+    slot->stackedFrames = condition.stackedFrame + 1;
+    slot->flags = (condition.hdr ? XSharedFrame::FLAG_HDR : 0u) | (filtered ? XSharedFrame::FLAG_FILTERED : 0u);
+
+    uchar* payload = reinterpret_cast<uchar*>(slot) + XSharedFrame::PAYLOAD_OFFSET;
+    xTiles.parallelForTiles(frame.height(), rowBytes,
+                            [&](int y0, int y1)
+                            {
+                                for (int y = y0; y < y1; ++y)
+                                    std::memcpy(payload + y * rowBytes, frame.constScanLine(y), rowBytes);
+                            });
+
+    slot->lock.store(lock + 2, std::memory_order_release);
+    ring->published.store(n, std::memory_order_release);
+    sequence.store(n);
+
+#ifdef Q_OS_WIN
+    // 等待第 n + 2 帧的读端与等待第 n 帧的共用一个事件，先复位再置位当前帧的事件
+    if (readyEvents[(n + 1) & 1] != nullptr)
+    {
+        ResetEvent(readyEvents[(n + 1) & 1]);
+    }
+    if (readyEvents[n & 1] != nullptr)
+    {
+        SetEvent(readyEvents[n & 1]);
+    }
+#endif
+    return true;
+}
+
+QString XSharedFramePublisher::statusText() const
+{
+    QMutexLocker locker(&mutex);
+    if (!memory.isAttached())
+    {
+        return "共享内存发布未开启";
+    }
+    return QString("共享内存 %1: 已发布 %2 帧, 丢弃 %3 帧, %4 个槽位 × %5 MB")
+        .arg(opts.name)
+        .arg(sequence.load())
+        .arg(dropped.load())
+        .arg(opts.slotCount)
+        .arg(capacity / 1048576.0, 0, 'f', 1);
+}
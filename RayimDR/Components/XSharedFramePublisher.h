@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+
+#include <QImage>
+#include <QMutex>
+#include <QSharedMemory>
+#include <QString>
+
+#include "XGlobal.h"
+
+/**
+ * @brief 把叠加完成的帧发布到命名共享内存环形缓冲，供本机下游检测程序零拷贝读取
+ *
+ * 布局与读端协议见 XSharedFrameRing.h。共享内存在首次开启时创建，采集之间保持映射，
+ * 下游程序无需随每次采集重新连接；已有同名映射（例如读端仍持有）且容量足够时直接复用并重置环头，
+ * 同时递增 generation 供读端重新同步。
+ *
+ * publish() 可在任意线程调用，内部串行化：按序号选择槽位，以顺序锁写入（行块并行拷贝），
+ * 更新 published 后通过命名事件通知读端。帧超过槽位容量时丢弃并告警一次。
+ */
+class XSharedFramePublisher
+{
+public:
+    struct Options
+    {
+        bool enabled{false};
+        QString name{"RayimDR.Frames"};
+        int slotCount{4};
+        qint64 slotBytes{0};  // 0 表示按 [DET] DET_WIDTH_1X1 × DET_HEIGHT_1X1 的 16 位整帧
+
+        // [SHM] SHM_ENABLE / SHM_NAME / SHM_SLOTS / SHM_SLOT_MB
+        static Options fromConfig();
+    };
+
+    XSharedFramePublisher();
+    ~XSharedFramePublisher();
+
+    // 名称与容量不变时保持现有映射
+    bool open(const Options& options);
+    void close();
+    bool isOpen() const;
+
+    // image 应为保存到文件的同一幅图像，filtered 表示其已应用显示增强滤波
+    bool publish(const QImage& image, const AcqCondition& condition, int frameIdx, bool filtered = false);
+
+    quint64 published() const { return sequence.load(); }
+    QString statusText() const;
+
+    XSharedFramePublisher(const XSharedFramePublisher&) = delete;
+    XSharedFramePublisher& operator=(const XSharedFramePublisher&) = delete;
+
+private:
+    void closeEvents();
+
+    mutable QMutex mutex;
+    QSharedMemory memory;
+    Options opts;
+    qint64 capacity{0};
+    std::atomic<quint64> sequence{0};
+    std::atomic<quint64> dropped{0};
+    bool warnedOversize{false};
+    void* readyEvents[2]{nullptr, nullptr};
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief 共享内存帧环形缓冲的布局，发布端与下游检测程序共用
+ *
+ * 本头文件只依赖标准库，下游程序可直接包含。共享内存以 [SHM] SHM_NAME 为原生名称（Windows 文件映射名），
+ * 由 RingHeader、按页对齐的 slotCount 个槽位组成；每个槽位是 SlotHeader 加一帧行连续的像素数据：
+ *
+ *   [RingHeader][pad][SlotHeader 0][pad][payload 0][SlotHeader 1][pad][payload 1]...
+ *   槽位 i 的起始偏移为 firstSlotOffset + i * slotStride，像素数据位于槽位起始 + PAYLOAD_OFFSET。
+ *
+ * 帧序号从 1 开始，第 n 帧写入槽位 (n - 1) % slotCount。写端只有一个：
+ * 1. 槽位 lock 加 1 变为奇数，写像素与帧信息，lock 再加 1 变回偶数；
+ * 2. RingHeader::published 更新为 n；
+ * 3. 置位通知事件 <SHM_NAME>.Ready<n % 2>，同时复位 <SHM_NAME>.Ready<(n + 1) % 2>（Windows 命名手动复位事件）。
+ *
+ * 读端零拷贝读取第 n 帧：
+ * - 等待：published >= n 时直接读取，否则带短超时等待事件 Ready<n % 2> 后重新检查 published。
+ *   事件只用于减少轮询，落后两帧以上时可能错过一次置位，超时保证不会一直阻塞；
+ * - 读取：beginRead() 取得槽位的 lock 快照并确认 sequence == n，直接在共享内存上处理像素，
+ *   处理完成后 endRead() 确认 lock 未变；失败说明该帧在读取期间已被覆盖（读端落后超过 slotCount - 1 帧），
+ *   应丢弃结果并跳到 published 指向的最新帧。
+ * - 重新同步：写端每次开启映射（含复用读端仍持有的映射）都会把 generation 加 1，并把 published 与帧序号从 0 重新开始。
+ *   读端记下开始读取时的 generation，每次等待返回或超时后先检查它；变化时放弃等待中的序号，从 published + 1 继续。
+ */
+namespace XSharedFrame
+{
+constexpr uint32_t MAGIC = 0x52465358;  // "XSFR"
+constexpr uint32_t VERSION = 2;
+constexpr uint64_t PAGE_SIZE = 4096;
+constexpr uint64_t PAYLOAD_OFFSET = PAGE_SIZE;  // 槽位内像素数据的偏移
+
+// SlotHeader::flags
+constexpr uint32_t FLAG_HDR = 1u << 0;       // HDR 融合结果
+constexpr uint32_t FLAG_FILTERED = 1u << 1;  // 已应用显示增强滤波（FILTER_APPLY_ON_SAVE），否则为原始叠加数据
+
+enum PixelFormat : uint32_t
+{
+    Gray16 = 1,  // 小端无符号 16 位
+    Gray8 = 2
+};
+
+struct alignas(64) RingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t writerPid;
+    uint64_t slotStride;       // 相邻槽位起始的间隔
+    uint64_t payloadCapacity;  // 单个槽位可容纳的像素字节数
+    uint64_t firstSlotOffset;
+    std::atomic<uint64_t> published;   // 最新完整帧的序号，0 表示尚无帧
+    std::atomic<uint64_t> generation;  // 写端每次开启映射加 1，变化表示帧序号已重新开始
+};
+
+struct alignas(64) SlotHeader
+{
+    std::atomic<uint32_t> lock;  // 顺序锁，奇数表示正在写入
+    uint32_t format;             // PixelFormat
+    uint64_t sequence;
+    int64_t timestampUs;  // 发布时刻，自 1970-01-01 UTC 起的微秒数
+    int32_t width;
+    int32_t height;
+    int32_t bytesPerLine;
+    int32_t frameIdx;  // 本次采集中的序号：DR 为叠加组序号，CT 为投影序号
+    int32_t acqType;   // AcqType
+    int32_t voltage;   // kV
+    int32_t current;   // uA
+    int32_t stackedFrames;
+    uint32_t flags;  // FLAG_HDR | FLAG_FILTERED
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "shared-memory atomics must be lock-free");
+static_assert(sizeof(SlotHeader) <= PAYLOAD_OFFSET, "slot header must fit before the payload");
+
+inline const SlotHeader* slotAt(const void* base, uint32_t index)
+{
+    const auto* ring = static_cast<const RingHeader*>(base);
+    return reinterpret_cast<const SlotHeader*>(static_cast<const uint8_t*>(base) + ring->firstSlotOffset +
+                                               index * ring->slotStride);
+}
+
+inline const uint8_t* payloadOf(const SlotHeader* slot)
+{
+    return reinterpret_cast<const uint8_t*>(slot) + PAYLOAD_OFFSET;
+}
+
+// 槽位正在写入或不是第 sequence 帧时返回 false
+inline bool beginRead(const SlotHeader* slot, uint64_t sequence, uint32_t& token)
+{
+    token = slot->lock.load(std::memory_order_acquire);
+    return (token & 1u) == 0 && slot->sequence == sequence;
+}
+
+// 读取期间槽位未被改写时返回 true
+inline bool endRead(const SlotHeader* slot, uint32_t token)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->lock.load(std::memory_order_relaxed) == token;
+}
+}  // namespace XSharedFrame
@@ -0,0 +1,118 @@
+#include "XStackSnrMonitor.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QDebug>
+
+#include "XGlobal.h"
+
+XStackSnrMonitor::Options XStackSnrMonitor::Options::fromConfig()
+{
+    Options options;
+    options.targetSnr = xGlobal.getDouble("SYSTEM", "STACK_TARGET_SNR", options.targetSnr);
+    options.maxFrames = std::max(1, xGlobal.getInt("SYSTEM", "MAX_STACKED_NUM", options.maxFrames));
+    options.minFrames = std::clamp(xGlobal.getInt("SYSTEM", "STACK_MIN_FRAMES", options.minFrames), 2,
+                                   std::max(2, options.maxFrames));
+    options.sampleStep = std::clamp(xGlobal.getInt("SYSTEM", "STACK_SNR_SAMPLE_STEP", options.sampleStep), 1, 64);
+    options.darkLevel = xGlobal.getDouble("SYSTEM", "STACK_SNR_DARK_LEVEL", options.darkLevel);
+
+    const QStringList parts = xGlobal.getString("SYSTEM", "STACK_SNR_ROI").split(',', Qt::SkipEmptyParts);
+    if (parts.size() == 4)
+    {
+        bool ok[4] = {false, false, false, false};
+        const QRect roi(parts[0].trimmed().toInt(&ok[0]), parts[1].trimmed().toInt(&ok[1]),
+                        parts[2].trimmed().toInt(&ok[2]), parts[3].trimmed().toInt(&ok[3]));
+        if (ok[0] && ok[1] && ok[2] && ok[3] && roi.isValid())
+        {
+            options.roi = roi;
+        }
+        else
+        {
+            qWarning() << "[叠加] STACK_SNR_ROI 格式错误, 应为 x,y,w,h";
+        }
+    }
+    return options;
+}
+
+void XStackSnrMonitor::reset(const Options& options)
+{
+    opts = options;
+    region = QRect();
+    restart();
+}
+
+void XStackSnrMonitor::restart()
+{
+    count = 0;
+    currentSnr = 0.0;
+    std::fill(mean.begin(), mean.end(), 0.0);
+    std::fill(m2.begin(), m2.end(), 0.0);
+}
+
+void XStackSnrMonitor::addFrame(const QImage& image)
+{
+    if (image.format() != QImage::Format_Grayscale16)
+    {
+        ++count;
+        return;
+    }
+
+    // 首帧或尺寸变化（如切换预览合并）时确定采样区域
+    const QRect imageRect = image.rect();
+    if (count == 0 || !imageRect.contains(region))
+    {
+        const QRect wanted = opts.roi.isNull()
+                                 ? QRect(image.width() / 4, image.height() / 4, image.width() / 2, image.height() / 2)
+                                 : opts.roi;
+        const QRect next = wanted.intersected(imageRect);
+        if (next != region)
+        {
+            region = next;
+            const size_t samples = static_cast<size_t>((region.width() + opts.sampleStep - 1) / opts.sampleStep) *
+                                   ((region.height() + opts.sampleStep - 1) / opts.sampleStep);
+            mean.assign(samples, 0.0);
+            m2.assign(samples, 0.0);
+            count = 0;
+        }
+    }
+
+    ++count;
+    const double n = count;
+    double sumMean = 0.0;
+    double sumVar = 0.0;
+    size_t i = 0;
+    for (int y = region.top(); y <= region.bottom(); y += opts.sampleStep)
+    {
+        const quint16* row = reinterpret_cast<const quint16*>(image.constScanLine(y));
+        for (int x = region.left(); x <= region.right(); x += opts.sampleStep, ++i)
+        {
+            const double value = row[x];
+            const double delta = value - mean[i];
+            mean[i] += delta / n;
+            m2[i] += delta * (value - mean[i]);
+            sumMean += mean[i];
+            sumVar += m2[i];
+        }
+    }
+
+    if (count < 2 || i == 0)
+    {
+        currentSnr = 0.0;
+        return;
+    }
+
+    const double signal = sumMean / i - opts.darkLevel;
+    const double variance = sumVar / i / (n - 1.0);
+    currentSnr = variance > 0.0 ? signal / std::sqrt(variance / n) : 0.0;
+}
+
+bool XStackSnrMonitor::done() const
+{
+    return count >= opts.maxFrames || (count >= opts.minFrames && currentSnr >= opts.targetSnr);
+}
+
+QString XStackSnrMonitor::statusText() const
+{
+    return QString("%1 帧, SNR %2 / 目标 %3").arg(count).arg(currentSnr, 0, 'f', 1).arg(opts.targetSnr, 0, 'f', 1);
+}
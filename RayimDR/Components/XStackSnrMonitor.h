@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include <QImage>
+#include <QRect>
+#include <QString>
+
+/**
+ * @brief 自适应叠加的在线信噪比估计
+ *
+ * 叠加组内每到一帧调用 addFrame()，在参考 ROI 内按 sampleStep 抽点，
+ * 用 Welford 算法逐点更新时间均值与方差（单遍、数值稳定，不保留历史帧）。
+ * n 帧平均后的信噪比估计为
+ *     SNR(n) = mean(μ - dark) / sqrt(mean(σ²) / n)
+ * μ、σ² 为各采样点的时间均值与无偏方差，dark 为探测器本底灰度。
+ * 参考 ROI 应落在被检物体的平坦区域，默认取图像中心 1/4 区域。
+ *
+ * 只在接收线程中使用，不加锁。
+ */
+class XStackSnrMonitor
+{
+public:
+    struct Options
+    {
+        double targetSnr{100.0};
+        int minFrames{2};    // 方差至少需要两帧
+        int maxFrames{100};  // 达不到目标时的叠加上限
+        QRect roi;           // 图像坐标，空表示中心 1/4 区域
+        int sampleStep{4};
+        double darkLevel{0.0};
+
+        // [SYSTEM] STACK_TARGET_SNR / STACK_MIN_FRAMES / MAX_STACKED_NUM / STACK_SNR_ROI ("x,y,w,h") /
+        //          STACK_SNR_SAMPLE_STEP / STACK_SNR_DARK_LEVEL
+        static Options fromConfig();
+    };
+
+    void reset(const Options& options);
+    // 开始新的叠加组
+    void restart();
+    void addFrame(const QImage& image);
+
+    const Options& options() const { return opts; }
+    int frames() const { return count; }
+    double snr() const { return currentSnr; }
+    // 已达到目标信噪比或叠加上限
+    bool done() const;
+    QString statusText() const;
+
+private:
+    Options opts;
+    QRect region;
+    int count{0};
+    double currentSnr{0.0};
+    std::vector<double> mean;
+    std::vector<double> m2;
+};
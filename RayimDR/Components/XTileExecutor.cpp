@@ -0,0 +1,158 @@
+#include "XTileExecutor.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include <QDebug>
+#include <QThread>
+
+#include "XGlobal.h"
+
+struct XTileExecutor::Job
+{
+    const TileFn* fn{nullptr};
+    int rows{0};
+    int tileRows{1};
+    int tileCount{0};
+    std::atomic_int nextTile{0};
+    std::atomic_int finishedTiles{0};
+    int activeWorkers{0};  // 受 mutex 保护
+};
+
+XTileExecutor& XTileExecutor::Instance()
+{
+    static XTileExecutor instance;
+    return instance;
+}
+
+XTileExecutor::XTileExecutor()
+{
+    tileBytes = std::max<qsizetype>(4096, xGlobal.getInt("SYSTEM", "TILE_BYTES", static_cast<int>(tileBytes)));
+
+    // 调用线程也参与计算，因此工作线程比核数少一个
+    const int count = std::max(0, QThread::idealThreadCount() - 1);
+    workers.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+    qDebug() << "[并行计算] 已启动" << count << "个工作线程, 分块" << tileBytes << "字节";
+}
+
+XTileExecutor::~XTileExecutor()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        workAvailable.wakeAll();
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+int XTileExecutor::tileRowsFor(int rows, qsizetype bytesPerRow) const
+{
+    if (rows <= 0)
+    {
+        return 1;
+    }
+
+    int tileRows = static_cast<int>(std::max<qsizetype>(1, tileBytes / std::max<qsizetype>(1, bytesPerRow)));
+    // 保证每个线程平均至少能分到 4 块，避免大行宽时负载不均
+    const int minTiles = 4 * (workerCount() + 1);
+    tileRows = std::min(tileRows, std::max(1, (rows + minTiles - 1) / minTiles));
+    return tileRows;
+}
+
+bool XTileExecutor::runNextTile(Job& job)
+{
+    const int tile = job.nextTile.fetch_add(1);
+    if (tile >= job.tileCount)
+    {
+        return false;
+    }
+
+    const int rowBegin = tile * job.tileRows;
+    (*job.fn)(rowBegin, std::min(rowBegin + job.tileRows, job.rows));
+    job.finishedTiles.fetch_add(1);
+    return true;
+}
+
+void XTileExecutor::parallelForTiles(int rows, qsizetype bytesPerRow, const TileFn& fn, int tileRows)
+{
+    if (rows <= 0)
+    {
+        return;
+    }
+
+    Job job;
+    job.fn = &fn;
+    job.rows = rows;
+    job.tileRows = tileRows > 0 ? tileRows : tileRowsFor(rows, bytesPerRow);
+    job.tileCount = (rows + job.tileRows - 1) / job.tileRows;
+
+    if (job.tileCount == 1 || workers.empty())
+    {
+        while (runNextTile(job))
+        {
+        }
+        return;
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        jobs.push_back(&job);
+        workAvailable.wakeAll();
+    }
+
+    while (runNextTile(job))
+    {
+    }
+
+    // 等待其它线程做完已领取的块并放开对 job 的引用
+    QMutexLocker locker(&mutex);
+    auto it = std::find(jobs.begin(), jobs.end(), &job);
+    if (it != jobs.end())
+    {
+        jobs.erase(it);
+    }
+    while (job.finishedTiles.load() < job.tileCount || job.activeWorkers > 0)
+    {
+        jobFinished.wait(&mutex);
+    }
+}
+
+void XTileExecutor::workerLoop()
+{
+    QMutexLocker locker(&mutex);
+    while (true)
+    {
+        while (!stopping && jobs.empty())
+        {
+            workAvailable.wait(&mutex);
+        }
+        if (stopping)
+        {
+            return;
+        }
+
+        Job* job = jobs.front();
+        ++job->activeWorkers;
+        locker.unlock();
+
+        while (runNextTile(*job))
+        {
+        }
+
+        locker.relock();
+        // 块已全部领取，不再让其它线程进入
+        if (!jobs.empty() && jobs.front() == job)
+        {
+            jobs.pop_front();
+        }
+        --job->activeWorkers;
+        jobFinished.wakeAll();
+    }
+}
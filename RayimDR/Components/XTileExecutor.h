@@ -0,0 +1,57 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <QMutex>
+#include <QWaitCondition>
+
+/**
+ * @brief 图像处理共用的行分块并行执行器
+ *
+ * 固定数量的工作线程常驻，parallelForTiles() 把 [0, rows) 切成连续的行块，
+ * 调用线程与空闲工作线程通过原子计数动态领取行块，先做完的线程自动多做，
+ * 不再为每个块单独分配 QtConcurrent 任务。调用线程自己也参与计算，嵌套调用不会死锁。
+ *
+ * 行块大小默认按每行字节数取约 TILE_BYTES（缓存大小）并保证块数足以均衡负载。
+ * fn 不能抛出异常。
+ */
+class XTileExecutor
+{
+public:
+    // fn(rowBegin, rowEnd)，半开区间
+    using TileFn = std::function<void(int rowBegin, int rowEnd)>;
+
+    static XTileExecutor& Instance();
+
+    // tileRows <= 0 时按 bytesPerRow 自动选择
+    void parallelForTiles(int rows, qsizetype bytesPerRow, const TileFn& fn, int tileRows = 0);
+
+    int tileRowsFor(int rows, qsizetype bytesPerRow) const;
+    int workerCount() const { return static_cast<int>(workers.size()); }
+
+    XTileExecutor(const XTileExecutor&) = delete;
+    XTileExecutor& operator=(const XTileExecutor&) = delete;
+
+private:
+    XTileExecutor();
+    ~XTileExecutor();
+
+    struct Job;
+
+    void workerLoop();
+    static bool runNextTile(Job& job);
+
+    std::vector<std::thread> workers;
+    qsizetype tileBytes{256 * 1024};
+
+    QMutex mutex;
+    QWaitCondition workAvailable;
+    QWaitCondition jobFinished;
+    std::deque<Job*> jobs;
+    bool stopping{false};
+};
+
+#define xTiles XTileExecutor::Instance()
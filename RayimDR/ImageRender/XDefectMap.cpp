@@ -0,0 +1,386 @@
+#include "XDefectMap.h"
+
+#include <qdebug.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qalgorithms.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <opencv2/imgproc.hpp>
+
+#include "Components/XGlobal.h"
+#include "Components/XTileExecutor.h"
+
+namespace
+{
+constexpr int STENCIL_CHUNK = 4096;
+constexpr quint32 FILE_VERSION = 1;
+
+struct FileHeader
+{
+    char magic[4];
+    quint32 version;
+    qint32 width;
+    qint32 height;
+    qint32 lineMinLength;
+    qint32 searchRadius;
+};
+
+// 抽样估计中值与稳健标准差（1.4826 * MAD），避免对整幅图像排序
+void robustStats(const std::vector<float>& data, float& median, float& sigma)
+{
+    const size_t step = std::max<size_t>(1, data.size() / 262144);
+    std::vector<float> sample;
+    sample.reserve(data.size() / step + 1);
+    for (size_t i = 0; i < data.size(); i += step)
+        sample.push_back(data[i]);
+
+    auto mid = sample.begin() + sample.size() / 2;
+    std::nth_element(sample.begin(), mid, sample.end());
+    median = *mid;
+
+    for (float& v : sample)
+        v = std::fabs(v - median);
+    std::nth_element(sample.begin(), mid, sample.end());
+    sigma = std::max(1.4826f * *mid, 1.0f);
+}
+}  // namespace
+
+XDefectMap::Params XDefectMap::Params::fromConfig()
+{
+    Params params;
+    params.hotSigma = xGlobal.getDouble("CORRECTION", "DEFECT_HOT_SIGMA", params.hotSigma);
+    params.responseTolerance =
+        xGlobal.getDouble("CORRECTION", "SOFT_CORRECTION_DEFECT_TOLERANCE", params.responseTolerance);
+    params.localWindow = xGlobal.getInt("CORRECTION", "DEFECT_LOCAL_WINDOW", params.localWindow) | 1;
+    params.lineMinLength = xGlobal.getInt("CORRECTION", "DEFECT_LINE_MIN_LENGTH", params.lineMinLength);
+    params.searchRadius = xGlobal.getInt("CORRECTION", "DEFECT_SEARCH_RADIUS", params.searchRadius);
+    return params;
+}
+
+XDefectMap::XDefectMap(int w, int h) : w(w), h(h), mask((static_cast<size_t>(w) * h + 63) / 64, 0) {}
+
+void XDefectMap::setDefect(int x, int y)
+{
+    const size_t idx = static_cast<size_t>(y) * w + x;
+    mask[idx >> 6] |= (quint64(1) << (idx & 63));
+}
+
+bool XDefectMap::isDefect(int x, int y) const
+{
+    const size_t idx = static_cast<size_t>(y) * w + x;
+    return (mask[idx >> 6] >> (idx & 63)) & 1;
+}
+
+std::shared_ptr<XDefectMap> XDefectMap::generate(const std::vector<float>& darkMean,
+                                                 const std::vector<float>& flatSignal, int w, int h,
+                                                 const Params& params)
+{
+    const size_t total = static_cast<size_t>(w) * h;
+    if (w <= 0 || h <= 0 || darkMean.size() != total || (!flatSignal.empty() && flatSignal.size() != total))
+    {
+        qWarning() << "[坏点表] 输入数据尺寸错误:" << w << "x" << h;
+        return nullptr;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    auto map = std::make_shared<XDefectMap>(w, h);
+
+    // 热点：暗场显著高于整体分布
+    float darkMedian = 0.0f;
+    float darkSigma = 1.0f;
+    robustStats(darkMean, darkMedian, darkSigma);
+    const float hotThreshold = darkMedian + static_cast<float>(params.hotSigma) * darkSigma;
+    int nHot = 0;
+    for (size_t i = 0; i < total; ++i)
+    {
+        if (darkMean[i] > hotThreshold)
+        {
+            map->mask[i >> 6] |= (quint64(1) << (i & 63));
+            ++nHot;
+        }
+    }
+
+    // 死点 / 响应异常：与局部均值比较，避免把射线场的缓慢不均匀误判为坏点
+    int nDead = 0;
+    if (!flatSignal.empty())
+    {
+        const cv::Mat signal(h, w, CV_32FC1, const_cast<float*>(flatSignal.data()));
+        cv::Mat localMean;
+        cv::blur(signal, localMean, cv::Size(params.localWindow, params.localWindow), cv::Point(-1, -1),
+                 cv::BORDER_REFLECT);
+
+        const float lower = static_cast<float>(1.0 - params.responseTolerance);
+        const float upper = static_cast<float>(1.0 + params.responseTolerance);
+        for (int y = 0; y < h; ++y)
+        {
+            const float* s = signal.ptr<float>(y);
+            const float* m = localMean.ptr<float>(y);
+            for (int x = 0; x < w; ++x)
+            {
+                const bool dead = s[x] <= 1.0f || m[x] <= 1.0f;
+                const float ratio = dead ? 0.0f : s[x] / m[x];
+                if (dead || ratio < lower || ratio > upper)
+                {
+                    if (!map->isDefect(x, y))
+                        ++nDead;
+                    map->setDefect(x, y);
+                }
+            }
+        }
+    }
+
+    map->buildStencils(params.lineMinLength, params.searchRadius);
+
+    qDebug() << "[坏点表] 生成完成, 热点阈值:" << hotThreshold << ", 热点:" << nHot << ", 响应异常:" << nDead << ","
+             << map->summary() << ", 耗时:" << timer.elapsed() << "ms";
+    return map;
+}
+
+void XDefectMap::buildStencils(int lineMinLength, int searchRadius)
+{
+    this->lineMinLength = lineMinLength;
+    this->searchRadius = searchRadius;
+    stencils.clear();
+    nIsolated = nLine = nCluster = 0;
+
+    std::vector<quint64> visited(mask.size(), 0);
+    std::vector<int> component;
+    std::vector<int> queue;
+
+    for (size_t word = 0; word < mask.size(); ++word)
+    {
+        quint64 pending = mask[word] & ~visited[word];
+        while (pending)
+        {
+            const int bit = qCountTrailingZeroBits(pending);
+            pending &= pending - 1;
+            const size_t seed = word * 64 + bit;
+            if (visited[word] >> bit & 1)
+                continue;
+
+            // 8 连通域广度优先搜索
+            component.clear();
+            queue.assign(1, static_cast<int>(seed));
+            visited[word] |= quint64(1) << bit;
+            int minX = w, maxX = -1, minY = h, maxY = -1;
+            while (!queue.empty())
+            {
+                const int idx = queue.back();
+                queue.pop_back();
+                component.push_back(idx);
+                const int cx = idx % w;
+                const int cy = idx / w;
+                minX = std::min(minX, cx);
+                maxX = std::max(maxX, cx);
+                minY = std::min(minY, cy);
+                maxY = std::max(maxY, cy);
+
+                for (int dy = -1; dy <= 1; ++dy)
+                {
+                    for (int dx = -1; dx <= 1; ++dx)
+                    {
+                        const int nx = cx + dx;
+                        const int ny = cy + dy;
+                        if (nx < 0 || ny < 0 || nx >= w || ny >= h || !isDefect(nx, ny))
+                            continue;
+                        const size_t n = static_cast<size_t>(ny) * w + nx;
+                        if (visited[n >> 6] >> (n & 63) & 1)
+                            continue;
+                        visited[n >> 6] |= quint64(1) << (n & 63);
+                        queue.push_back(static_cast<int>(n));
+                    }
+                }
+            }
+
+            DefectType type = DefectType::Cluster;
+            const int size = static_cast<int>(component.size());
+            if (size == 1)
+                type = DefectType::Isolated;
+            else if (minY == maxY && size >= lineMinLength)
+                type = DefectType::HorizontalLine;
+            else if (minX == maxX && size >= lineMinLength)
+                type = DefectType::VerticalLine;
+
+            for (int idx : component)
+                stencils.push_back(makeStencil(idx % w, idx / w, type, searchRadius));
+
+            if (type == DefectType::Isolated)
+                nIsolated += size;
+            else if (type == DefectType::Cluster)
+                nCluster += size;
+            else
+                nLine += size;
+        }
+    }
+}
+
+XDefectMap::Stencil XDefectMap::makeStencil(int x, int y, DefectType type, int searchRadius) const
+{
+    static const int DIRS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+    Stencil s{};
+    s.x = x;
+    s.y = y;
+
+    auto collect = [&](int dirBegin, int dirEnd)
+    {
+        int taps = 0;
+        float weightSum = 0.0f;
+        const int radius = (type == DefectType::Isolated) ? 1 : searchRadius;
+        for (int d = dirBegin; d < dirEnd; ++d)
+        {
+            for (int step = 1; step <= radius; ++step)
+            {
+                const int nx = x + DIRS[d][0] * step;
+                const int ny = y + DIRS[d][1] * step;
+                if (nx < 0 || ny < 0 || nx >= w || ny >= h)
+                    break;
+                if (isDefect(nx, ny))
+                    continue;
+                s.tapX[taps] = nx;
+                s.tapY[taps] = ny;
+                s.weight[taps] = 1.0f / step;
+                weightSum += s.weight[taps];
+                ++taps;
+                break;
+            }
+        }
+        return std::make_pair(taps, weightSum);
+    };
+
+    // 线缺陷只在垂直方向取值，找不到时退化为四方向
+    std::pair<int, float> result = (type == DefectType::HorizontalLine) ? collect(2, 4)
+                                   : (type == DefectType::VerticalLine) ? collect(0, 2)
+                                                                        : collect(0, 4);
+    if (result.first == 0 && type != DefectType::Cluster && type != DefectType::Isolated)
+        result = collect(0, 4);
+
+    int taps = result.first;
+    float weightSum = result.second;
+
+    if (taps == 0)
+    {
+        // 周围没有可用像素，保持原值
+        s.tapX[0] = x;
+        s.tapY[0] = y;
+        s.weight[0] = 1.0f;
+        weightSum = 1.0f;
+        taps = 1;
+    }
+
+    for (int i = 0; i < taps; ++i)
+        s.weight[i] /= weightSum;
+    for (int i = taps; i < 4; ++i)
+    {
+        s.tapX[i] = s.tapX[0];
+        s.tapY[i] = s.tapY[0];
+        s.weight[i] = 0.0f;
+    }
+    return s;
+}
+
+bool XDefectMap::apply(QImage& image) const
+{
+    if (image.isNull() || image.format() != QImage::Format_Grayscale16 || image.width() != w || image.height() != h)
+    {
+        qWarning() << "[坏点表] 图像格式或尺寸" << image.size() << "与坏点表" << w << "x" << h << "不一致";
+        return false;
+    }
+
+    if (stencils.empty())
+        return true;
+
+    uchar* bits = image.bits();
+    const qsizetype bytesPerLine = image.bytesPerLine();
+    auto pixel = [bits, bytesPerLine](int x, int y) -> quint16&
+    { return reinterpret_cast<quint16*>(bits + y * bytesPerLine)[x]; };
+
+    // 坏点模板按固定数量分块，执行器的“行”在这里即模板序号
+    xTiles.parallelForTiles(static_cast<int>(stencils.size()), 0,
+                            [&](int begin, int end)
+                            {
+                                for (int i = begin; i < end; ++i)
+                                {
+                                    const Stencil& s = stencils[i];
+                                    const float v = s.weight[0] * pixel(s.tapX[0], s.tapY[0]) +
+                                                    s.weight[1] * pixel(s.tapX[1], s.tapY[1]) +
+                                                    s.weight[2] * pixel(s.tapX[2], s.tapY[2]) +
+                                                    s.weight[3] * pixel(s.tapX[3], s.tapY[3]);
+                                    pixel(s.x, s.y) = static_cast<quint16>(v + 0.5f);
+                                }
+                            },
+                            STENCIL_CHUNK);
+    return true;
+}
+
+QString XDefectMap::summary() const
+{
+    return QString("坏点 %1 (孤立 %2, 线 %3, 簇 %4)").arg(defectCount()).arg(nIsolated).arg(nLine).arg(nCluster);
+}
+
+bool XDefectMap::save(const QString& filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "[坏点表] 无法写入文件:" << filePath << file.errorString();
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, "XDMP", 4);
+    header.version = FILE_VERSION;
+    header.width = w;
+    header.height = h;
+    header.lineMinLength = lineMinLength;
+    header.searchRadius = searchRadius;
+
+    const qint64 maskBytes = static_cast<qint64>(mask.size() * sizeof(quint64));
+    const bool ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header) &&
+                    file.write(reinterpret_cast<const char*>(mask.data()), maskBytes) == maskBytes;
+    if (!ok)
+    {
+        qWarning() << "[坏点表] 文件写入不完整:" << filePath;
+        return false;
+    }
+
+    qDebug() << "[坏点表] 已保存:" << filePath << "," << summary();
+    return true;
+}
+
+std::shared_ptr<XDefectMap> XDefectMap::load(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "[坏点表] 无法打开文件:" << filePath << file.errorString();
+        return nullptr;
+    }
+
+    FileHeader header{};
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+        std::memcmp(header.magic, "XDMP", 4) != 0 || header.version != FILE_VERSION || header.width <= 0 ||
+        header.height <= 0)
+    {
+        qWarning() << "[坏点表] 文件格式错误:" << filePath;
+        return nullptr;
+    }
+
+    auto map = std::make_shared<XDefectMap>(header.width, header.height);
+    const qint64 maskBytes = static_cast<qint64>(map->mask.size() * sizeof(quint64));
+    if (file.read(reinterpret_cast<char*>(map->mask.data()), maskBytes) != maskBytes)
+    {
+        qWarning() << "[坏点表] 文件数据不完整:" << filePath;
+        return nullptr;
+    }
+
+    map->buildStencils(header.lineMinLength, header.searchRadius);
+    qDebug() << "[坏点表] 已加载:" << filePath << "," << map->summary();
+    return map;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <qimage.h>
+#include <qstring.h>
+
+/**
+ * @brief 坏点表：位掩码 + 预计算插值模板
+ *
+ * 由暗场均值（热点 / 亮点）与亮场信号（死点 / 响应异常）生成，坏点按连通域分为三类：
+ * - 孤立点：上下左右四邻域平均
+ * - 线缺陷：单像素宽的行/列段，仅沿垂直于缺陷方向插值
+ * - 簇缺陷：四个方向上最近的有效像素按距离倒数加权
+ *
+ * 每个坏点固定 4 个抽头，未用抽头权重为 0，逐帧应用时无分支；抽头只引用有效像素，可原地并行处理。
+ */
+class XDefectMap
+{
+public:
+    struct Params
+    {
+        double hotSigma{6.0};            // 暗场超过 中值 + hotSigma * 稳健标准差 视为热点
+        double responseTolerance{0.3};   // 亮场响应相对局部均值的允许偏差
+        int localWindow{15};             // 局部均值窗口（像素，奇数）
+        int lineMinLength{8};            // 单像素宽连通段达到该长度视为线缺陷
+        int searchRadius{8};             // 簇缺陷沿各方向搜索有效像素的最大距离
+
+        static Params fromConfig();
+    };
+
+    XDefectMap(int w, int h);
+
+    // flatSignal 为扣除本底后的亮场信号，可为空（仅检测热点）
+    static std::shared_ptr<XDefectMap> generate(const std::vector<float>& darkMean,
+                                                const std::vector<float>& flatSignal, int w, int h,
+                                                const Params& params);
+    static std::shared_ptr<XDefectMap> load(const QString& filePath);
+    bool save(const QString& filePath) const;
+
+    void setDefect(int x, int y);
+    bool isDefect(int x, int y) const;
+    // 根据掩码对坏点分类并生成插值模板，修改掩码后需要重新调用
+    void buildStencils(int lineMinLength, int searchRadius);
+
+    // 原地修复 16 位灰度图像中的坏点，尺寸不匹配时返回 false
+    bool apply(QImage& image) const;
+
+    int width() const { return w; }
+    int height() const { return h; }
+    int defectCount() const { return static_cast<int>(stencils.size()); }
+    int isolatedCount() const { return nIsolated; }
+    int lineCount() const { return nLine; }
+    int clusterCount() const { return nCluster; }
+    QString summary() const;
+
+private:
+    struct Stencil
+    {
+        int x;
+        int y;
+        int tapX[4];
+        int tapY[4];
+        float weight[4];
+    };
+
+    enum class DefectType
+    {
+        Isolated,
+        HorizontalLine,
+        VerticalLine,
+        Cluster
+    };
+
+    Stencil makeStencil(int x, int y, DefectType type, int searchRadius) const;
+
+    int w{0};
+    int h{0};
+    int lineMinLength{8};
+    int searchRadius{8};
+    std::vector<quint64> mask;
+    std::vector<Stencil> stencils;
+    int nIsolated{0};
+    int nLine{0};
+    int nCluster{0};
+};
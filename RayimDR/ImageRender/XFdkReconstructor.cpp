@@ -0,0 +1,602 @@
+#include "XFdkReconstructor.h"
+
+#include <qdebug.h>
+#include <qdir.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qrandom.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XFDK_USE_SSE2
+#endif
+
+#include "Components/XGlobal.h"
+#include "Components/XProjectionStack.h"
+#include "Components/XTileExecutor.h"
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+
+// 换算到旋转中心平面后的重建参数
+struct Setup
+{
+    int nu{0};
+    int nv{0};
+    int nx{0};
+    int ny{0};
+    int nz{0};
+    double sod{0.0};
+    double du{0.0};  // 旋转中心平面上的探测器像素尺寸 mm
+    double cu{0.0};  // 旋转中心投影所在的像素坐标
+    double cv{0.0};
+    double voxel{0.0};
+};
+
+bool makeSetup(const XFdkReconstructor::Geometry& g, int nu, int nv, Setup& s, QString& error)
+{
+    if (g.sod <= 0.0 || g.sdd <= g.sod || g.pixelSize <= 0.0 || g.volumeX <= 0 || g.volumeY <= 0 || g.volumeZ <= 0)
+    {
+        error = "重建几何参数无效";
+        return false;
+    }
+
+    s.nu = nu;
+    s.nv = nv;
+    s.nx = g.volumeX;
+    s.ny = g.volumeY;
+    s.nz = g.volumeZ;
+    s.sod = g.sod;
+    s.du = g.pixelSize * g.sod / g.sdd;
+    s.cu = (nu - 1) / 2.0 + g.offsetU;
+    s.cv = (nv - 1) / 2.0 + g.offsetV;
+    s.voxel = g.voxelSize > 0.0 ? g.voxelSize : s.du * nu / std::max(g.volumeX, g.volumeY);
+
+    // 体数据必须完全位于射线源轨迹之内
+    const double radius = s.voxel * 0.5 * std::hypot(s.nx, s.ny);
+    if (radius >= s.sod * 0.95)
+    {
+        error = QString("体数据半径 %1 mm 超出射线源轨迹 %2 mm").arg(radius, 0, 'f', 1).arg(s.sod, 0, 'f', 1);
+        return false;
+    }
+    return true;
+}
+
+// 按行的斜坡滤波。空间域 Ram-Lak 核（Kak & Slaney）循环补零后变换到频域得到实数增益，
+// 比直接构造 |w| 更准确地处理直流分量；频谱为 OpenCV CCS 打包格式，逐元素乘增益即可
+class RampFilter
+{
+public:
+    RampFilter(int nu, double du, bool hann)
+    {
+        fftLen = cv::getOptimalDFTSize(2 * nu);
+        while (fftLen % 2 != 0)
+            fftLen = cv::getOptimalDFTSize(fftLen + 1);
+
+        std::vector<float> kernel(fftLen, 0.0f);
+        kernel[0] = static_cast<float>(1.0 / (4.0 * du * du));
+        for (int n = 1; n <= fftLen / 2; n += 2)
+        {
+            const float value = static_cast<float>(-1.0 / (n * n * PI * PI * du * du));
+            kernel[n] = value;
+            kernel[fftLen - n] = value;
+        }
+
+        cv::Mat spectrum;
+        cv::dft(cv::Mat(1, fftLen, CV_32F, kernel.data()), spectrum);
+        const float* packed = spectrum.ptr<float>(0);
+
+        // 离散卷积需乘采样间隔 du
+        const int half = fftLen / 2;
+        auto response = [&](int k, float re)
+        {
+            const double window = hann ? 0.5 * (1.0 + std::cos(PI * k / half)) : 1.0;
+            return static_cast<float>(re * du * window);
+        };
+        gain.assign(fftLen, 0.0f);
+        gain[0] = response(0, packed[0]);
+        for (int k = 1; k < half; ++k)
+        {
+            gain[2 * k - 1] = gain[2 * k] = response(k, packed[2 * k - 1]);
+        }
+        gain[fftLen - 1] = response(half, packed[fftLen - 1]);
+    }
+
+    int length() const { return fftLen; }
+
+    // rows 每行 fftLen 个 float，前 nu 个为数据、其余为零，原地滤波
+    void apply(cv::Mat& rows) const
+    {
+        cv::dft(rows, rows, cv::DFT_ROWS);
+        for (int r = 0; r < rows.rows; ++r)
+        {
+            float* row = rows.ptr<float>(r);
+            for (int i = 0; i < fftLen; ++i)
+                row[i] *= gain[i];
+        }
+        cv::dft(rows, rows, cv::DFT_INVERSE | cv::DFT_ROWS | cv::DFT_SCALE);
+    }
+
+private:
+    int fftLen{0};
+    std::vector<float> gain;
+};
+
+// 线积分 -ln(I / I0)、余弦加权与斜坡滤波，结果写入 out（nv 行 × nu 列）
+bool filterProjection(const quint16* raw, float* out, const Setup& s, const RampFilter& ramp, float logI0)
+{
+    const float sod = static_cast<float>(s.sod);
+    std::vector<float> uu2(s.nu);
+    for (int u = 0; u < s.nu; ++u)
+    {
+        const float uu = static_cast<float>((u - s.cu) * s.du);
+        uu2[u] = sod * sod + uu * uu;
+    }
+
+    std::atomic_bool failed{false};
+    xTiles.parallelForTiles(
+        s.nv, static_cast<qsizetype>(ramp.length()) * sizeof(float),
+        [&](int rowBegin, int rowEnd)
+        {
+            try
+            {
+                cv::Mat rows(rowEnd - rowBegin, ramp.length(), CV_32F, cv::Scalar(0));
+                for (int v = rowBegin; v < rowEnd; ++v)
+                {
+                    const quint16* src = raw + static_cast<qsizetype>(v) * s.nu;
+                    float* dst = rows.ptr<float>(v - rowBegin);
+                    const float vv = static_cast<float>((v - s.cv) * s.du);
+                    const float vv2 = vv * vv;
+                    for (int u = 0; u < s.nu; ++u)
+                    {
+                        const float weight = sod / std::sqrt(uu2[u] + vv2);
+                        dst[u] = (logI0 - std::log(static_cast<float>(std::max<quint16>(src[u], 1)))) * weight;
+                    }
+                }
+
+                ramp.apply(rows);
+
+                for (int v = rowBegin; v < rowEnd; ++v)
+                {
+                    std::copy_n(rows.ptr<float>(v - rowBegin), s.nu, out + static_cast<qsizetype>(v) * s.nu);
+                }
+            }
+            catch (const cv::Exception& e)
+            {
+                qCritical() << "[重建] 斜坡滤波失败:" << e.what();
+                failed.store(true);
+            }
+        });
+    return !failed.load();
+}
+
+// 一批滤波投影，每个投影只含探测器行 [rowBase, rowBase + rows)
+struct Batch
+{
+    const float* data{nullptr};
+    int count{0};
+    int rowBase{0};
+    int rows{0};
+    const float* cosBeta{nullptr};
+    const float* sinBeta{nullptr};
+};
+
+// 把一批投影累加到 slab 的 [lineBegin, lineEnd) 体素行，slab 从第 z0 层开始。
+// 每条体素行在缓存中依次累加整批投影；沿 x 方向射线深度与横向坐标线性变化，
+// 探测器坐标与权重 4 个体素一组用 SSE2 计算，双线性插值逐体素取数
+void backprojectLines(float* slab, const Setup& s, int z0, const Batch& batch, int lineBegin, int lineEnd)
+{
+    std::vector<float> us(s.nx), vs(s.nx), ws(s.nx);
+    const float invDu = static_cast<float>(1.0 / s.du);
+    const float invSod = static_cast<float>(1.0 / s.sod);
+    const float cu = static_cast<float>(s.cu);
+    const float cv = static_cast<float>(s.cv - batch.rowBase);
+    const float x0 = static_cast<float>(-(s.nx - 1) / 2.0 * s.voxel);
+    const float voxel = static_cast<float>(s.voxel);
+    const qsizetype projStride = static_cast<qsizetype>(batch.rows) * s.nu;
+
+    for (int line = lineBegin; line < lineEnd; ++line)
+    {
+        const int z = z0 + line / s.ny;
+        const int y = line % s.ny;
+        const float zc = static_cast<float>((z - (s.nz - 1) / 2.0) * s.voxel);
+        const float yc = static_cast<float>((y - (s.ny - 1) / 2.0) * s.voxel);
+        float* dst = slab + static_cast<qsizetype>(line) * s.nx;
+
+        for (int p = 0; p < batch.count; ++p)
+        {
+            const float cosB = batch.cosBeta[p];
+            const float sinB = batch.sinBeta[p];
+            // U = (SOD - t) / SOD，t 为体素在射线源方向上的投影，a 为横向坐标
+            const float U0 = 1.0f - (x0 * cosB + yc * sinB) * invSod;
+            const float dU = -voxel * cosB * invSod;
+            const float a0 = -x0 * sinB + yc * cosB;
+            const float da = -voxel * sinB;
+            const float zInvDu = zc * invDu;
+
+            int i = 0;
+#ifdef XFDK_USE_SSE2
+            const __m128 vLane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+            const __m128 vOne = _mm_set1_ps(1.0f);
+            for (; i + 4 <= s.nx; i += 4)
+            {
+                const __m128 vi = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), vLane);
+                const __m128 U = _mm_add_ps(_mm_set1_ps(U0), _mm_mul_ps(vi, _mm_set1_ps(dU)));
+                const __m128 invU = _mm_div_ps(vOne, U);
+                const __m128 a = _mm_add_ps(_mm_set1_ps(a0), _mm_mul_ps(vi, _mm_set1_ps(da)));
+                _mm_storeu_ps(us.data() + i,
+                              _mm_add_ps(_mm_mul_ps(_mm_mul_ps(a, invU), _mm_set1_ps(invDu)), _mm_set1_ps(cu)));
+                _mm_storeu_ps(vs.data() + i, _mm_add_ps(_mm_mul_ps(invU, _mm_set1_ps(zInvDu)), _mm_set1_ps(cv)));
+                _mm_storeu_ps(ws.data() + i, _mm_mul_ps(invU, invU));
+            }
+#endif
+            for (; i < s.nx; ++i)
+            {
+                const float invU = 1.0f / (U0 + i * dU);
+                us[i] = (a0 + i * da) * invU * invDu + cu;
+                vs[i] = zInvDu * invU + cv;
+                ws[i] = invU * invU;
+            }
+
+            const float* proj = batch.data + projStride * p;
+            for (i = 0; i < s.nx; ++i)
+            {
+                const int iu = static_cast<int>(std::floor(us[i]));
+                const int iv = static_cast<int>(std::floor(vs[i]));
+                if (iu < 0 || iv < 0 || iu >= s.nu - 1 || iv >= batch.rows - 1)
+                    continue;
+
+                const float fu = us[i] - iu;
+                const float fv = vs[i] - iv;
+                const float* p0 = proj + static_cast<qsizetype>(iv) * s.nu + iu;
+                const float* p1 = p0 + s.nu;
+                const float top = p0[0] + fu * (p0[1] - p0[0]);
+                const float bottom = p1[0] + fu * (p1[1] - p1[0]);
+                dst[i] += ws[i] * (top + fv * (bottom - top));
+            }
+        }
+    }
+}
+
+// slab [z0, z1) 可能投影到的探测器行范围
+void detectorRows(const Setup& s, int z0, int z1, int& rowBegin, int& rowEnd)
+{
+    const double radius = s.voxel * 0.5 * std::hypot(s.nx, s.ny);
+    const double uNear = (s.sod - radius) / s.sod;
+    const double uFar = (s.sod + radius) / s.sod;
+    const double zLo = (z0 - (s.nz - 1) / 2.0) * s.voxel;
+    const double zHi = (z1 - 1 - (s.nz - 1) / 2.0) * s.voxel;
+    const double vLo = std::min(zLo / uNear, zLo / uFar);
+    const double vHi = std::max(zHi / uNear, zHi / uFar);
+    rowBegin = std::clamp(static_cast<int>(std::floor(vLo / s.du + s.cv)) - 1, 0, s.nv);
+    rowEnd = std::clamp(static_cast<int>(std::ceil(vHi / s.du + s.cv)) + 2, rowBegin, s.nv);
+}
+}  // namespace
+
+XFdkReconstructor::Geometry XFdkReconstructor::Geometry::fromConfig()
+{
+    Geometry g;
+    g.sod = xGlobal.getDouble("RECON", "RECON_SOD", g.sod);
+    g.sdd = xGlobal.getDouble("RECON", "RECON_SDD", g.sdd);
+    g.pixelSize = xGlobal.getDouble("RECON", "RECON_PIXEL_SIZE", g.pixelSize);
+    g.offsetU = xGlobal.getDouble("RECON", "RECON_OFFSET_U", g.offsetU);
+    g.offsetV = xGlobal.getDouble("RECON", "RECON_OFFSET_V", g.offsetV);
+    g.volumeX = xGlobal.getInt("RECON", "RECON_VOLUME_X", g.volumeX);
+    g.volumeY = xGlobal.getInt("RECON", "RECON_VOLUME_Y", g.volumeY);
+    g.volumeZ = xGlobal.getInt("RECON", "RECON_VOLUME_Z", g.volumeZ);
+    g.voxelSize = xGlobal.getDouble("RECON", "RECON_VOXEL_SIZE", g.voxelSize);
+    return g;
+}
+
+XFdkReconstructor::Options XFdkReconstructor::Options::fromConfig()
+{
+    Options o;
+    o.i0 = xGlobal.getDouble("RECON", "RECON_I0", o.i0);
+    o.hannWindow = xGlobal.getBool("RECON", "RECON_HANN", o.hannWindow);
+    o.projectionBatch = std::max(1, xGlobal.getInt("RECON", "RECON_BATCH", o.projectionBatch));
+    o.memoryMB = std::max(64, xGlobal.getInt("RECON", "RECON_MEMORY_MB", o.memoryMB));
+    o.tempDir = xGlobal.getString("RECON", "RECON_TEMP_DIR");
+    return o;
+}
+
+QString XFdkReconstructor::Result::summary() const
+{
+    if (!ok)
+    {
+        return QString("重建失败: %1").arg(error);
+    }
+    return QString("体数据 %1x%2x%3, 投影 %4, slab %5, 滤波 %6 s, 反投影 %7 s, 总耗时 %8 s, %9 GUPS")
+        .arg(volumeX)
+        .arg(volumeY)
+        .arg(volumeZ)
+        .arg(projections)
+        .arg(slabs)
+        .arg(filterSec, 0, 'f', 2)
+        .arg(backprojectSec, 0, 'f', 2)
+        .arg(totalSec, 0, 'f', 2)
+        .arg(gups, 0, 'f', 3);
+}
+
+XFdkReconstructor::Result XFdkReconstructor::reconstruct(const QString& projectionPath, const QString& outputDir,
+                                                         const Geometry& geometry, const Options& options,
+                                                         const ProgressFn& progress)
+{
+    Result result;
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    QString tempPath;
+    QFile filtered;
+    QFile volume;
+    auto fail = [&](const QString& msg)
+    {
+        result.ok = false;
+        result.error = msg;
+        // Windows 上无法删除仍打开的文件
+        filtered.close();
+        volume.close();
+        if (!tempPath.isEmpty())
+            QFile::remove(tempPath);
+        if (!result.volumePath.isEmpty())
+            QFile::remove(result.volumePath);
+        qCritical() << "[重建]" << msg;
+        return result;
+    };
+    auto report = [&](int percent, const QString& stage) { return !progress || progress(percent, stage); };
+
+    XProjectionStackReader reader;
+    if (!reader.open(projectionPath))
+        return fail(reader.errorString());
+
+    const int nu = reader.width();
+    const int nv = reader.height();
+    const int count = reader.count();
+    const double stepDeg = std::abs(reader.header().angleStep);
+    if (count < 2)
+        return fail(QString("投影数量不足: %1").arg(count));
+
+    Setup s;
+    QString setupError;
+    if (!makeSetup(geometry, nu, nv, s, setupError))
+        return fail(setupError);
+
+    result.volumeX = s.nx;
+    result.volumeY = s.ny;
+    result.volumeZ = s.nz;
+    result.projections = count;
+
+    QDir outDir(outputDir);
+    if (!outDir.exists() && !outDir.mkpath("."))
+        return fail(QString("无法创建输出目录 %1").arg(outputDir));
+
+    const QString baseName = QFileInfo(projectionPath).completeBaseName();
+    tempPath = QDir(options.tempDir.isEmpty() ? outputDir : options.tempDir).filePath(baseName + ".filtered.tmp");
+
+    qInfo() << "[重建] 开始 - 投影:" << count << "x" << nu << "x" << nv << ", 体数据:" << s.nx << "x" << s.ny << "x"
+            << s.nz << ", 体素:" << s.voxel << "mm, SOD:" << geometry.sod << "mm, SDD:" << geometry.sdd << "mm";
+
+    // 1. 逐个投影滤波并写入临时文件
+    filtered.setFileName(tempPath);
+    if (!filtered.open(QIODevice::ReadWrite | QIODevice::Truncate))
+        return fail(QString("无法创建临时文件 %1: %2").arg(tempPath).arg(filtered.errorString()));
+
+    const qint64 projectionBytes = static_cast<qint64>(nu) * nv * sizeof(float);
+    std::vector<quint16> raw(static_cast<size_t>(nu) * nv);
+    std::vector<float> filteredProjection(static_cast<size_t>(nu) * nv);
+    std::vector<float> cosBeta(count), sinBeta(count);
+    float logI0 = 0.0f;
+
+    {
+        const RampFilter ramp(nu, s.du, options.hannWindow);
+        QElapsedTimer filterTimer;
+        filterTimer.start();
+        for (int p = 0; p < count; ++p)
+        {
+            XProjectionRecord record{};
+            if (!reader.read(p, record, raw.data()))
+                return fail(reader.errorString());
+
+            if (p == 0)
+            {
+                const double i0 = options.i0 > 0.0 ? options.i0 : *std::max_element(raw.begin(), raw.end());
+                logI0 = static_cast<float>(std::log(std::max(i0, 1.0)));
+                qDebug() << "[重建] 空气值 I0:" << i0;
+            }
+            const double beta = record.angle * PI / 180.0;
+            cosBeta[p] = static_cast<float>(std::cos(beta));
+            sinBeta[p] = static_cast<float>(std::sin(beta));
+
+            if (!filterProjection(raw.data(), filteredProjection.data(), s, ramp, logI0))
+                return fail(QString("投影 %1 滤波失败").arg(p));
+            if (filtered.write(reinterpret_cast<const char*>(filteredProjection.data()), projectionBytes) !=
+                projectionBytes)
+                return fail(QString("写入临时文件失败: %1").arg(filtered.errorString()));
+
+            if (!report(30 * (p + 1) / count, QString("滤波投影 %1/%2").arg(p + 1).arg(count)))
+                return fail("重建已取消");
+        }
+        result.filterSec = filterTimer.nsecsElapsed() / 1e9;
+    }
+    reader.close();
+    raw = std::vector<quint16>();
+    filteredProjection = std::vector<float>();
+
+    // 2. 按 slab 反投影：一半内存给 slab，一半给投影批
+    const qint64 budget = static_cast<qint64>(options.memoryMB) * 1024 * 1024;
+    const qint64 sliceBytes = static_cast<qint64>(s.nx) * s.ny * sizeof(float);
+    const int slabZ = static_cast<int>(std::clamp<qint64>(budget / 2 / sliceBytes, 1, s.nz));
+
+    int maxRows = 0;
+    for (int z0 = 0; z0 < s.nz; z0 += slabZ)
+    {
+        int rowBegin = 0;
+        int rowEnd = 0;
+        detectorRows(s, z0, std::min(z0 + slabZ, s.nz), rowBegin, rowEnd);
+        maxRows = std::max(maxRows, rowEnd - rowBegin);
+    }
+    const qint64 rowBlockBytes = static_cast<qint64>(std::max(1, maxRows)) * nu * sizeof(float);
+    const int batchSize =
+        static_cast<int>(std::clamp<qint64>(budget / 2 / rowBlockBytes, 1, std::max(1, options.projectionBatch)));
+
+    result.volumePath =
+        outDir.filePath(QString("%1_Volume_%2x%3x%4_f32.raw").arg(baseName).arg(s.nx).arg(s.ny).arg(s.nz));
+    volume.setFileName(result.volumePath);
+    if (!volume.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return fail(QString("无法创建体数据文件 %1: %2").arg(result.volumePath).arg(volume.errorString()));
+
+    // 360° 圆轨迹的每个射线被采样两次，权重为 Δβ / 2
+    const double deltaBeta = stepDeg > 0.0 ? stepDeg * PI / 180.0 : 2.0 * PI / count;
+    const float scale = static_cast<float>(deltaBeta / 2.0);
+
+    std::vector<float> slab(static_cast<size_t>(slabZ) * s.nx * s.ny);
+    std::vector<float> batchData(static_cast<size_t>(batchSize) * std::max(1, maxRows) * nu);
+    result.slabs = (s.nz + slabZ - 1) / slabZ;
+    qDebug() << "[重建] 反投影 - slab:" << slabZ << "层 x" << result.slabs << ", 每批投影:" << batchSize
+             << ", 探测器行:" << maxRows;
+
+    qint64 backprojectNs = 0;
+    const qint64 totalWork = static_cast<qint64>(result.slabs) * count;
+    qint64 doneWork = 0;
+    for (int z0 = 0, slabIdx = 0; z0 < s.nz; z0 += slabZ, ++slabIdx)
+    {
+        const int z1 = std::min(z0 + slabZ, s.nz);
+        const int lines = (z1 - z0) * s.ny;
+        int rowBegin = 0;
+        int rowEnd = 0;
+        detectorRows(s, z0, z1, rowBegin, rowEnd);
+        const int rows = rowEnd - rowBegin;
+        std::fill(slab.begin(), slab.begin() + static_cast<size_t>(lines) * s.nx, 0.0f);
+
+        for (int p0 = 0; p0 < count && rows >= 2; p0 += batchSize)
+        {
+            const int batchCount = std::min(batchSize, count - p0);
+            const qint64 blockBytes = static_cast<qint64>(rows) * nu * sizeof(float);
+            for (int p = 0; p < batchCount; ++p)
+            {
+                char* dst = reinterpret_cast<char*>(batchData.data() + static_cast<size_t>(p) * rows * nu);
+                if (!filtered.seek(projectionBytes * (p0 + p) + static_cast<qint64>(rowBegin) * nu * sizeof(float)) ||
+                    filtered.read(dst, blockBytes) != blockBytes)
+                    return fail(QString("读取临时文件失败: %1").arg(filtered.errorString()));
+            }
+
+            Batch batch;
+            batch.data = batchData.data();
+            batch.count = batchCount;
+            batch.rowBase = rowBegin;
+            batch.rows = rows;
+            batch.cosBeta = cosBeta.data() + p0;
+            batch.sinBeta = sinBeta.data() + p0;
+
+            QElapsedTimer bpTimer;
+            bpTimer.start();
+            xTiles.parallelForTiles(lines, sliceBytes / s.ny, [&](int lineBegin, int lineEnd)
+                                    { backprojectLines(slab.data(), s, z0, batch, lineBegin, lineEnd); });
+            backprojectNs += bpTimer.nsecsElapsed();
+
+            doneWork += batchCount;
+            if (!report(30 + static_cast<int>(70 * doneWork / totalWork),
+                        QString("反投影 slab %1/%2, 投影 %3/%4")
+                            .arg(slabIdx + 1)
+                            .arg(result.slabs)
+                            .arg(p0 + batchCount)
+                            .arg(count)))
+                return fail("重建已取消");
+        }
+
+        const qint64 slabBytes = static_cast<qint64>(lines) * s.nx * sizeof(float);
+        std::transform(slab.begin(), slab.begin() + static_cast<size_t>(lines) * s.nx, slab.begin(),
+                       [scale](float v) { return v * scale; });
+        if (volume.write(reinterpret_cast<const char*>(slab.data()), slabBytes) != slabBytes)
+            return fail(QString("写入体数据失败: %1").arg(volume.errorString()));
+    }
+
+    volume.close();
+    filtered.close();
+    QFile::remove(tempPath);
+
+    result.backprojectSec = backprojectNs / 1e9;
+    result.totalSec = totalTimer.nsecsElapsed() / 1e9;
+    if (result.backprojectSec > 0.0)
+    {
+        result.gups = static_cast<double>(s.nx) * s.ny * s.nz * count / result.backprojectSec / 1e9;
+    }
+    result.ok = true;
+    qInfo() << "[重建]" << result.summary() << ", 输出:" << result.volumePath;
+    return result;
+}
+
+XFdkReconstructor::Result XFdkReconstructor::benchmark(int volumeSize, int projections, int detectorSize)
+{
+    Result result;
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    Geometry geometry;
+    geometry.pixelSize = 0.2;
+    geometry.volumeX = geometry.volumeY = geometry.volumeZ = std::max(8, volumeSize);
+
+    Setup s;
+    if (!makeSetup(geometry, detectorSize, detectorSize, s, result.error))
+    {
+        qWarning() << "[重建] 性能测试参数无效:" << result.error;
+        return result;
+    }
+    projections = std::max(1, projections);
+
+    // 只保留一批合成投影循环使用，角度照常递增
+    const int batchSize = std::min(projections, 16);
+    std::vector<float> batchData(static_cast<size_t>(batchSize) * s.nu * s.nv);
+    for (float& v : batchData)
+        v = static_cast<float>(QRandomGenerator::global()->generateDouble());
+
+    std::vector<float> cosBeta(projections), sinBeta(projections);
+    for (int p = 0; p < projections; ++p)
+    {
+        const double beta = 2.0 * PI * p / projections;
+        cosBeta[p] = static_cast<float>(std::cos(beta));
+        sinBeta[p] = static_cast<float>(std::sin(beta));
+    }
+
+    std::vector<float> volume(static_cast<size_t>(s.nx) * s.ny * s.nz, 0.0f);
+    const int lines = s.nz * s.ny;
+
+    QElapsedTimer bpTimer;
+    bpTimer.start();
+    for (int p0 = 0; p0 < projections; p0 += batchSize)
+    {
+        Batch batch;
+        batch.data = batchData.data();
+        batch.count = std::min(batchSize, projections - p0);
+        batch.rowBase = 0;
+        batch.rows = s.nv;
+        batch.cosBeta = cosBeta.data() + p0;
+        batch.sinBeta = sinBeta.data() + p0;
+        xTiles.parallelForTiles(lines, static_cast<qsizetype>(s.nx) * sizeof(float), [&](int lineBegin, int lineEnd)
+                                { backprojectLines(volume.data(), s, 0, batch, lineBegin, lineEnd); });
+    }
+
+    result.ok = true;
+    result.volumeX = s.nx;
+    result.volumeY = s.ny;
+    result.volumeZ = s.nz;
+    result.projections = projections;
+    result.slabs = 1;
+    result.backprojectSec = bpTimer.nsecsElapsed() / 1e9;
+    result.totalSec = totalTimer.nsecsElapsed() / 1e9;
+    if (result.backprojectSec > 0.0)
+    {
+        result.gups = static_cast<double>(s.nx) * s.ny * s.nz * projections / result.backprojectSec / 1e9;
+    }
+    qInfo() << "[重建] 性能测试 - 探测器" << detectorSize << "x" << detectorSize << "," << result.summary() << ", 线程:"
+            << (xTiles.workerCount() + 1);
+    return result;
+}
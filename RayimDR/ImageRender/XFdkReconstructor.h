@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+
+#include <qstring.h>
+
+/**
+ * @brief CPU 锥束 FDK 重建（圆轨迹、平板探测器）
+ *
+ * 输入为 CT 扫描写出的投影文件 (.xprj)，输出为 float32 RAW 体数据，分两步处理：
+ * 1. 滤波：逐个读取投影，转为线积分 -ln(I / I0)，乘余弦权重，按行做 FFT 斜坡滤波（Ram-Lak，可加 Hann 窗），
+ *    结果以 float 写入临时文件，每个投影只在内存中停留一次；
+ * 2. 反投影：体数据沿 z 切成若干 slab，slab 厚度由内存预算决定。每个 slab 只读取滤波投影中可能
+ *    投影到该 slab 的探测器行，投影按批加载；每条体素行在缓存中连续累加一批投影后再处理下一行。
+ *    完成的 slab 直接追加到输出文件，因此体数据可以大于内存。
+ *
+ * 旋转轴为 z，射线源在 xy 平面内绕轴旋转，探测器坐标统一换算到旋转中心平面。
+ * 角度取自投影记录；扫描范围应覆盖 360°，短扫描未做 Parker 加权。
+ */
+class XFdkReconstructor
+{
+public:
+    struct Geometry
+    {
+        double sod{500.0};        // 射线源到旋转中心 mm
+        double sdd{1000.0};       // 射线源到探测器 mm
+        double pixelSize{0.139};  // 投影文件中的像素尺寸 mm（含合并）
+        double offsetU{0.0};      // 旋转中心投影相对探测器中心的偏移，像素
+        double offsetV{0.0};
+        int volumeX{512};
+        int volumeY{512};
+        int volumeZ{512};
+        double voxelSize{0.0};  // mm，0 表示按探测器宽度在旋转中心处的视野自动计算
+
+        // [RECON] RECON_SOD / RECON_SDD / RECON_PIXEL_SIZE / RECON_OFFSET_U / RECON_OFFSET_V /
+        //         RECON_VOLUME_X / RECON_VOLUME_Y / RECON_VOLUME_Z / RECON_VOXEL_SIZE
+        static Geometry fromConfig();
+    };
+
+    struct Options
+    {
+        double i0{0.0};  // 空气值，0 表示取第一个投影的最大值
+        bool hannWindow{true};
+        int projectionBatch{16};  // 反投影时每批加载的投影数
+        int memoryMB{2048};       // slab 与投影批的内存预算
+        QString tempDir;          // 滤波投影临时文件目录，空表示输出目录
+
+        // [RECON] RECON_I0 / RECON_HANN / RECON_BATCH / RECON_MEMORY_MB / RECON_TEMP_DIR
+        static Options fromConfig();
+    };
+
+    struct Result
+    {
+        bool ok{false};
+        QString error;
+        QString volumePath;
+        int volumeX{0};
+        int volumeY{0};
+        int volumeZ{0};
+        int projections{0};
+        int slabs{0};
+        double filterSec{0.0};
+        double backprojectSec{0.0};  // 纯计算时间，不含读盘
+        double totalSec{0.0};
+        double gups{0.0};  // 反投影速度：每秒十亿次体素更新
+
+        QString summary() const;
+    };
+
+    // percent 为 0-100；返回 false 时取消重建
+    using ProgressFn = std::function<bool(int percent, const QString& stage)>;
+
+    static Result reconstruct(const QString& projectionPath, const QString& outputDir, const Geometry& geometry,
+                              const Options& options, const ProgressFn& progress = ProgressFn());
+
+    // 在内存中的合成滤波投影上测试反投影速度，不涉及磁盘
+    static Result benchmark(int volumeSize = 256, int projections = 180, int detectorSize = 512);
+};
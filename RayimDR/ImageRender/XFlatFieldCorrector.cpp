@@ -0,0 +1,515 @@
+#include "XFlatFieldCorrector.h"
+
+#include <qcoreapplication.h>
+#include <qdebug.h>
+#include <qdir.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XFF_USE_SSE2
+#endif
+
+#include "Components/XGlobal.h"
+#include "Components/XTileExecutor.h"
+#include "ImageRender/XImageHelper.h"
+
+#include "IRayDetector/TiffHelper.h"
+
+namespace
+{
+constexpr quint32 FILE_VERSION = 2;
+constexpr char FILE_NAME[] = "FlatField.xffc";
+constexpr char DEFECT_FILE_NAME[] = "DefectMap.xdm";
+
+struct FileHeader
+{
+    char magic[4];
+    quint32 version;
+    qint32 width;
+    qint32 height;
+    quint32 flags;  // bit0: offset, bit1: gain
+};
+
+template <bool UseGain>
+void correctRow(quint16* row, const float* offset, const float* gain, int width)
+{
+    int x = 0;
+#ifdef XFF_USE_SSE2
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vMax = _mm_set1_ps(65535.0f);
+    const __m128 vHalf = _mm_set1_ps(0.5f);
+    const __m128i vZeroI = _mm_setzero_si128();
+    const __m128i vBias = _mm_set1_epi32(32768);
+    const __m128i vFlip = _mm_set1_epi16(static_cast<short>(0x8000));
+
+    for (; x + 8 <= width; x += 8)
+    {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+        __m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(raw, vZeroI));
+        __m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(raw, vZeroI));
+
+        lo = _mm_sub_ps(lo, _mm_loadu_ps(offset + x));
+        hi = _mm_sub_ps(hi, _mm_loadu_ps(offset + x + 4));
+        if constexpr (UseGain)
+        {
+            lo = _mm_mul_ps(lo, _mm_loadu_ps(gain + x));
+            hi = _mm_mul_ps(hi, _mm_loadu_ps(gain + x + 4));
+        }
+        lo = _mm_min_ps(_mm_max_ps(lo, vZero), vMax);
+        hi = _mm_min_ps(_mm_max_ps(hi, vZero), vMax);
+
+        // 与尾部标量路径一致按 +0.5 截断取整（_mm_cvtps_epi32 为银行家舍入）
+        // SSE2 没有无符号饱和打包，先平移到有符号区间再打包，最后翻转符号位还原
+        __m128i ilo = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(lo, vHalf)), vBias);
+        __m128i ihi = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(hi, vHalf)), vBias);
+        __m128i packed = _mm_xor_si128(_mm_packs_epi32(ilo, ihi), vFlip);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), packed);
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        float v = static_cast<float>(row[x]) - offset[x];
+        if constexpr (UseGain)
+            v *= gain[x];
+        v = std::clamp(v, 0.0f, 65535.0f);
+        row[x] = static_cast<quint16>(v + 0.5f);
+    }
+}
+}  // namespace
+
+XFlatFieldCorrector& XFlatFieldCorrector::Instance()
+{
+    static XFlatFieldCorrector instance;
+    return instance;
+}
+
+QString XFlatFieldCorrector::templateDir()
+{
+    QString dirPath = xGlobal.getString("CORRECTION", "SOFT_CORRECTION_DIR", "SoftCorrection");
+    if (QDir::isRelativePath(dirPath))
+    {
+        dirPath = QCoreApplication::applicationDirPath() + "/" + dirPath;
+    }
+    return QDir::cleanPath(dirPath);
+}
+
+std::shared_ptr<const XFlatFieldCorrector::Templates> XFlatFieldCorrector::snapshot() const
+{
+    QMutexLocker locker(&mutex);
+    return templates;
+}
+
+void XFlatFieldCorrector::publish(std::shared_ptr<const Templates> next)
+{
+    QMutexLocker locker(&mutex);
+    templates = std::move(next);
+}
+
+bool XFlatFieldCorrector::averageFrames(const QList<QImage>& frames, int& w, int& h, std::vector<float>& mean)
+{
+    if (frames.isEmpty())
+    {
+        qWarning() << "[软件校正] 输入帧为空";
+        return false;
+    }
+
+    w = frames.first().width();
+    h = frames.first().height();
+    for (const QImage& frame : frames)
+    {
+        if (frame.format() != QImage::Format_Grayscale16 || frame.width() != w || frame.height() != h)
+        {
+            qWarning() << "[软件校正] 输入帧格式或尺寸不一致:" << frame.format() << frame.size() << ", 期望:" << w
+                       << "x" << h;
+            return false;
+        }
+    }
+
+    mean.assign(static_cast<size_t>(w) * h, 0.0f);
+    const float invCount = 1.0f / static_cast<float>(frames.size());
+
+    // 每个行块的累加结果在遍历所有帧期间保持在缓存中
+    xTiles.parallelForTiles(h, static_cast<qsizetype>(w) * sizeof(float),
+                            [&](int y0, int y1)
+                            {
+                                for (const QImage& frame : frames)
+                                {
+                                    for (int y = y0; y < y1; ++y)
+                                    {
+                                        const quint16* src = reinterpret_cast<const quint16*>(frame.constScanLine(y));
+                                        float* dst = mean.data() + static_cast<size_t>(y) * w;
+                                        for (int x = 0; x < w; ++x)
+                                            dst[x] += static_cast<float>(src[x]);
+                                    }
+                                }
+                                for (int y = y0; y < y1; ++y)
+                                {
+                                    float* dst = mean.data() + static_cast<size_t>(y) * w;
+                                    for (int x = 0; x < w; ++x)
+                                        dst[x] *= invCount;
+                                }
+                            });
+    return true;
+}
+
+bool XFlatFieldCorrector::buildOffset(const QList<QImage>& darkFrames)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto next = std::make_shared<Templates>();
+    if (!averageFrames(darkFrames, next->width, next->height, next->offset))
+    {
+        return false;
+    }
+
+    // 尺寸未变化时保留增益模板，否则必须重新生成；坏点表按新暗场检测热点
+    const XDefectMap::Params params = XDefectMap::Params::fromConfig();
+    std::shared_ptr<XDefectMap> defects =
+        XDefectMap::generate(next->offset, std::vector<float>(), next->width, next->height, params);
+    auto current = snapshot();
+    if (current && current->width == next->width && current->height == next->height)
+    {
+        next->gain = current->gain;
+
+        // 保留的增益模板对应的亮场死点 / 响应异常点不能丢，否则这些像素会被增益放大而不是插值
+        if (defects && current->defectMap && !next->gain.empty() && current->defectMap->width() == next->width &&
+            current->defectMap->height() == next->height)
+        {
+            const int before = defects->defectCount();
+            for (int y = 0; y < next->height; ++y)
+            {
+                for (int x = 0; x < next->width; ++x)
+                {
+                    if (current->defectMap->isDefect(x, y))
+                        defects->setDefect(x, y);
+                }
+            }
+            defects->buildStencils(params.lineMinLength, params.searchRadius);
+            qDebug() << "[软件校正] 沿用增益模板, 合并原坏点表:" << before << "->" << defects->defectCount();
+        }
+    }
+    next->defectMap = defects;
+
+    qDebug() << "[软件校正] 本底模板生成完成, 帧数:" << darkFrames.size() << ", 尺寸:" << next->width << "x"
+             << next->height << ", 耗时:" << timer.elapsed() << "ms";
+    publish(std::move(next));
+    return true;
+}
+
+bool XFlatFieldCorrector::buildGain(const QList<QImage>& flatFrames)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto current = snapshot();
+    if (!current || current->offset.empty())
+    {
+        qWarning() << "[软件校正] 生成增益模板前需要先生成本底模板";
+        return false;
+    }
+
+    int w = 0;
+    int h = 0;
+    std::vector<float> flat;
+    if (!averageFrames(flatFrames, w, h, flat))
+    {
+        return false;
+    }
+    if (w != current->width || h != current->height)
+    {
+        qWarning() << "[软件校正] 亮场尺寸" << w << "x" << h << "与本底模板" << current->width << "x"
+                   << current->height << "不一致";
+        return false;
+    }
+
+    const size_t total = flat.size();
+    double sum = 0.0;
+    size_t valid = 0;
+    for (size_t i = 0; i < total; ++i)
+    {
+        flat[i] -= current->offset[i];
+        if (flat[i] > 1.0f)
+        {
+            sum += flat[i];
+            ++valid;
+        }
+    }
+    if (valid == 0)
+    {
+        qWarning() << "[软件校正] 亮场信号过低, 无法生成增益模板";
+        return false;
+    }
+
+    const float meanSignal = static_cast<float>(sum / valid);
+
+    auto next = std::make_shared<Templates>();
+    next->width = w;
+    next->height = h;
+    next->offset = current->offset;
+    next->gain.resize(total);
+    for (size_t i = 0; i < total; ++i)
+    {
+        next->gain[i] = flat[i] > 1.0f ? meanSignal / flat[i] : 1.0f;
+    }
+    next->defectMap = XDefectMap::generate(next->offset, flat, w, h, XDefectMap::Params::fromConfig());
+
+    qDebug() << "[软件校正] 增益模板生成完成, 帧数:" << flatFrames.size() << ", 平均信号:" << meanSignal << ","
+             << (next->defectMap ? next->defectMap->summary() : QString("坏点表生成失败")) << ", 耗时:"
+             << timer.elapsed() << "ms";
+    publish(std::move(next));
+    return true;
+}
+
+void XFlatFieldCorrector::correctRows(const Templates& t, uchar* bits, qsizetype bytesPerLine, int rowBegin,
+                                      int rowEnd)
+{
+    const bool useGain = !t.gain.empty();
+    for (int y = rowBegin; y < rowEnd; ++y)
+    {
+        quint16* row = reinterpret_cast<quint16*>(bits + y * bytesPerLine);
+        const size_t base = static_cast<size_t>(y) * t.width;
+        if (useGain)
+            correctRow<true>(row, t.offset.data() + base, t.gain.data() + base, t.width);
+        else
+            correctRow<false>(row, t.offset.data() + base, nullptr, t.width);
+    }
+}
+
+bool XFlatFieldCorrector::apply(QImage& image) const
+{
+    auto t = snapshot();
+    if (!t || t->offset.empty())
+    {
+        return false;
+    }
+
+    if (image.isNull() || image.format() != QImage::Format_Grayscale16)
+    {
+        qWarning() << "[软件校正] 仅支持16位灰度图像, 当前格式:" << image.format();
+        return false;
+    }
+
+    if (image.width() != t->width || image.height() != t->height)
+    {
+        qWarning() << "[软件校正] 图像尺寸" << image.size() << "与模板" << t->width << "x" << t->height
+                   << "不一致, 跳过校正";
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    uchar* bits = image.bits();
+    const qsizetype bytesPerLine = image.bytesPerLine();
+
+    xTiles.parallelForTiles(t->height, bytesPerLine,
+                            [&](int y0, int y1) { correctRows(*t, bits, bytesPerLine, y0, y1); });
+
+    if (t->defectMap)
+        t->defectMap->apply(image);
+
+    qDebug() << "[软件校正] 校正完成, 尺寸:" << t->width << "x" << t->height << ", 坏点:"
+             << (t->defectMap ? t->defectMap->defectCount() : 0) << ", 耗时:" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool XFlatFieldCorrector::applyDefects(QImage& image) const
+{
+    auto t = snapshot();
+    if (!t || !t->defectMap)
+    {
+        return false;
+    }
+    return t->defectMap->apply(image);
+}
+
+bool XFlatFieldCorrector::correctFile(const QString& inPath, const QString& outPath, int w, int h) const
+{
+    QImage image = XImageHelper::openImageFile(inPath, w, h);
+    if (image.isNull())
+    {
+        qWarning() << "[软件校正] 文件读取失败:" << inPath;
+        return false;
+    }
+
+    if (!apply(image))
+    {
+        return false;
+    }
+
+    const QString suffix = QFileInfo(outPath).suffix().toLower();
+    if (suffix == "raw")
+    {
+        return XImageHelper::saveImageU16Raw(image, outPath);
+    }
+    if (suffix == "tif" || suffix == "tiff")
+    {
+        TiffHelper::SaveImage(image, outPath.toStdString());
+        return QFileInfo::exists(outPath);
+    }
+
+    qWarning() << "[软件校正] 不支持的输出格式:" << outPath;
+    return false;
+}
+
+bool XFlatFieldCorrector::saveTemplates(const QString& dirPath) const
+{
+    auto t = snapshot();
+    if (!t || t->offset.empty())
+    {
+        qWarning() << "[软件校正] 没有可保存的模板";
+        return false;
+    }
+
+    if (!QDir().mkpath(dirPath))
+    {
+        qWarning() << "[软件校正] 无法创建模板目录:" << dirPath;
+        return false;
+    }
+
+    const QString filePath = QDir(dirPath).filePath(FILE_NAME);
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "[软件校正] 无法写入模板文件:" << filePath << file.errorString();
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, "XFFC", 4);
+    header.version = FILE_VERSION;
+    header.width = t->width;
+    header.height = t->height;
+    header.flags = 0x1u | (t->gain.empty() ? 0u : 0x2u);
+
+    bool ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header);
+    ok = ok && file.write(reinterpret_cast<const char*>(t->offset.data()), t->offset.size() * sizeof(float)) ==
+                   static_cast<qint64>(t->offset.size() * sizeof(float));
+    if (!t->gain.empty())
+    {
+        ok = ok && file.write(reinterpret_cast<const char*>(t->gain.data()), t->gain.size() * sizeof(float)) ==
+                       static_cast<qint64>(t->gain.size() * sizeof(float));
+    }
+    file.close();
+    if (ok && t->defectMap)
+    {
+        ok = t->defectMap->save(QDir(dirPath).filePath(DEFECT_FILE_NAME));
+    }
+
+    if (!ok)
+    {
+        qWarning() << "[软件校正] 模板文件写入不完整:" << filePath;
+        return false;
+    }
+
+    qDebug() << "[软件校正] 模板已保存:" << filePath;
+    return true;
+}
+
+bool XFlatFieldCorrector::loadTemplates(const QString& dirPath)
+{
+    const QString filePath = QDir(dirPath).filePath(FILE_NAME);
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "[软件校正] 无法打开模板文件:" << filePath << file.errorString();
+        return false;
+    }
+
+    FileHeader header{};
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+        std::memcmp(header.magic, "XFFC", 4) != 0 || header.version != FILE_VERSION || header.width <= 0 ||
+        header.height <= 0 || !(header.flags & 0x1u))
+    {
+        qWarning() << "[软件校正] 模板文件格式错误:" << filePath;
+        return false;
+    }
+
+    auto next = std::make_shared<Templates>();
+    next->width = header.width;
+    next->height = header.height;
+    const size_t total = static_cast<size_t>(header.width) * header.height;
+
+    auto readVector = [&file](auto& vec, size_t count)
+    {
+        vec.resize(count);
+        const qint64 bytes = static_cast<qint64>(count * sizeof(vec[0]));
+        return file.read(reinterpret_cast<char*>(vec.data()), bytes) == bytes;
+    };
+
+    bool ok = readVector(next->offset, total);
+    if (ok && (header.flags & 0x2u))
+    {
+        ok = readVector(next->gain, total);
+    }
+    if (!ok)
+    {
+        qWarning() << "[软件校正] 模板文件数据不完整:" << filePath;
+        return false;
+    }
+
+    // 坏点表可选，尺寸不一致时忽略
+    const QString defectPath = QDir(dirPath).filePath(DEFECT_FILE_NAME);
+    if (QFile::exists(defectPath))
+    {
+        auto defectMap = XDefectMap::load(defectPath);
+        if (defectMap && defectMap->width() == next->width && defectMap->height() == next->height)
+            next->defectMap = std::move(defectMap);
+        else
+            qWarning() << "[软件校正] 坏点表无效或尺寸不匹配, 已忽略:" << defectPath;
+    }
+
+    qDebug() << "[软件校正] 模板已加载:" << filePath << ", 尺寸:" << next->width << "x" << next->height
+             << ", 增益:" << (next->gain.empty() ? "无" : "有") << ", 坏点:"
+             << (next->defectMap ? next->defectMap->defectCount() : 0);
+    publish(std::move(next));
+    return true;
+}
+
+void XFlatFieldCorrector::clear()
+{
+    publish(nullptr);
+}
+
+bool XFlatFieldCorrector::hasOffset() const
+{
+    auto t = snapshot();
+    return t && !t->offset.empty();
+}
+
+bool XFlatFieldCorrector::hasGain() const
+{
+    auto t = snapshot();
+    return t && !t->gain.empty();
+}
+
+QSize XFlatFieldCorrector::templateSize() const
+{
+    auto t = snapshot();
+    return t ? QSize(t->width, t->height) : QSize();
+}
+
+int XFlatFieldCorrector::defectCount() const
+{
+    auto t = snapshot();
+    return t && t->defectMap ? t->defectMap->defectCount() : 0;
+}
+
+QString XFlatFieldCorrector::defectSummary() const
+{
+    auto t = snapshot();
+    return t && t->defectMap ? t->defectMap->summary() : QString("无坏点表");
+}
+
+std::shared_ptr<const XDefectMap> XFlatFieldCorrector::defectMap() const
+{
+    auto t = snapshot();
+    return t ? t->defectMap : nullptr;
+}
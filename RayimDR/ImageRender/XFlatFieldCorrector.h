@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <qimage.h>
+#include <qlist.h>
+#include <qmutex.h>
+#include <qstring.h>
+
+#include "ImageRender/XDefectMap.h"
+
+/**
+ * @brief 主机端软件平场校正（本底 / 增益 / 坏点）
+ *
+ * 与探测器 SDK 内部的校正相互独立，可用于实时采集流水线，也可对已存档的 RAW/TIFF 数据离线重处理：
+ * - 由多帧暗场叠加生成本底模板 (offset)
+ * - 由多帧亮场叠加生成增益模板 (gain = mean(flat - offset) / (flat - offset))
+ * - 由暗场 / 亮场同时生成坏点表 (XDefectMap)
+ * - 校正公式：out = (raw - offset) * gain，坏点按坏点表的插值模板修复
+ *
+ * 模板以不可变快照的形式持有，apply() 可在任意线程并发调用。
+ */
+class XFlatFieldCorrector
+{
+public:
+    static XFlatFieldCorrector& Instance();
+
+    // 由暗场帧生成本底模板，尺寸变化时会清除已有的增益模板
+    bool buildOffset(const QList<QImage>& darkFrames);
+    // 由亮场帧生成增益模板与坏点表，需要先生成本底模板
+    bool buildGain(const QList<QImage>& flatFrames);
+
+    // 原地校正 16 位灰度图像，模板未就绪或尺寸不匹配时返回 false 且不修改图像
+    bool apply(QImage& image) const;
+    // 仅修复坏点，不做本底 / 增益校正
+    bool applyDefects(QImage& image) const;
+    // 读取 RAW/TIFF 文件，校正后按原格式写入 outPath（RAW 需指定宽高）
+    bool correctFile(const QString& inPath, const QString& outPath, int w = 0, int h = 0) const;
+
+    bool saveTemplates(const QString& dirPath) const;
+    bool loadTemplates(const QString& dirPath);
+    void clear();
+
+    bool hasOffset() const;
+    bool hasGain() const;
+    QSize templateSize() const;
+    int defectCount() const;
+    QString defectSummary() const;
+    std::shared_ptr<const XDefectMap> defectMap() const;
+
+    // 配置文件中指定的模板目录（相对路径相对于程序目录）
+    static QString templateDir();
+
+    XFlatFieldCorrector(const XFlatFieldCorrector&) = delete;
+    XFlatFieldCorrector& operator=(const XFlatFieldCorrector&) = delete;
+
+private:
+    XFlatFieldCorrector() = default;
+    ~XFlatFieldCorrector() = default;
+
+    struct Templates
+    {
+        int width{0};
+        int height{0};
+        std::vector<float> offset;                    // 空表示未生成
+        std::vector<float> gain;                      // 空表示未生成
+        std::shared_ptr<const XDefectMap> defectMap;  // 空表示未生成
+    };
+
+    std::shared_ptr<const Templates> snapshot() const;
+    void publish(std::shared_ptr<const Templates> next);
+
+    static bool averageFrames(const QList<QImage>& frames, int& w, int& h, std::vector<float>& mean);
+    static void correctRows(const Templates& t, uchar* bits, qsizetype bytesPerLine, int rowBegin, int rowEnd);
+
+    mutable QMutex mutex;
+    std::shared_ptr<const Templates> templates;
+};
@@ -0,0 +1,168 @@
+#include "XFramePool.h"
+
+#include <qdebug.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#include "Components/XGlobal.h"
+
+namespace
+{
+constexpr std::size_t BUFFER_ALIGN = 64;
+
+// 池析构后仍可能有图像被释放（静态对象析构顺序不定），此时直接归还给堆
+std::atomic_bool poolAlive{false};
+
+int bitsPerPixel(QImage::Format format)
+{
+    switch (format)
+    {
+        case QImage::Format_Grayscale8:
+            return 8;
+        case QImage::Format_Grayscale16:
+            return 16;
+        default:
+            return QImage::toPixelFormat(format).bitsPerPixel();
+    }
+}
+}  // namespace
+
+struct XFramePool::Buffer
+{
+    Key key;
+    uchar* data{nullptr};
+    qsizetype bytes{0};
+};
+
+XFramePool& XFramePool::Instance()
+{
+    static XFramePool instance;
+    return instance;
+}
+
+XFramePool::XFramePool()
+{
+    enabled = xGlobal.getBool("SYSTEM", "FRAME_POOL_ENABLE", true);
+    maxFreePerSize = std::max(0, xGlobal.getInt("SYSTEM", "FRAME_POOL_MAX_PER_SIZE", maxFreePerSize));
+    poolAlive.store(true);
+}
+
+XFramePool::~XFramePool()
+{
+    QMutexLocker locker(&mutex);
+    poolAlive.store(false);
+    for (auto& entry : freeBuffers)
+    {
+        for (Buffer* buffer : entry.second)
+            freeBuffer(buffer);
+    }
+    freeBuffers.clear();
+}
+
+QImage XFramePool::acquire(int width, int height, QImage::Format format)
+{
+    if (!enabled || width <= 0 || height <= 0)
+    {
+        return QImage(width, height, format);
+    }
+
+    const Key key{width, height, static_cast<int>(format)};
+    // 与 QImage 默认行字节数一致（4 字节对齐），保证整幅数据连续
+    const qsizetype bytesPerLine = (static_cast<qsizetype>(width) * bitsPerPixel(format) + 31) / 32 * 4;
+
+    Buffer* buffer = nullptr;
+    {
+        QMutexLocker locker(&mutex);
+        auto it = freeBuffers.find(key);
+        if (it != freeBuffers.end() && !it->second.empty())
+        {
+            buffer = it->second.back();
+            it->second.pop_back();
+            freeBytes -= buffer->bytes;
+            ++hits;
+        }
+        else
+        {
+            ++misses;
+        }
+        ++outstanding;
+    }
+
+    if (!buffer)
+    {
+        const qsizetype bytes = bytesPerLine * height;
+        try
+        {
+            buffer = new Buffer{key, static_cast<uchar*>(::operator new(bytes, std::align_val_t(BUFFER_ALIGN))), bytes};
+        }
+        catch (const std::bad_alloc&)
+        {
+            qCritical() << "[帧池] 分配失败:" << width << "x" << height << format << bytes << "bytes";
+            QMutexLocker locker(&mutex);
+            --outstanding;
+            return QImage();
+        }
+    }
+
+    return QImage(buffer->data, width, height, bytesPerLine, format, &XFramePool::release, buffer);
+}
+
+void XFramePool::release(void* info)
+{
+    Buffer* buffer = static_cast<Buffer*>(info);
+    if (!poolAlive.load())
+    {
+        freeBuffer(buffer);
+        return;
+    }
+    Instance().recycle(buffer);
+}
+
+void XFramePool::freeBuffer(Buffer* buffer)
+{
+    ::operator delete(buffer->data, std::align_val_t(BUFFER_ALIGN));
+    delete buffer;
+}
+
+void XFramePool::recycle(Buffer* buffer)
+{
+    QMutexLocker locker(&mutex);
+    --outstanding;
+
+    std::vector<Buffer*>& list = freeBuffers[buffer->key];
+    if (static_cast<int>(list.size()) >= maxFreePerSize)
+    {
+        locker.unlock();
+        freeBuffer(buffer);
+        return;
+    }
+    list.push_back(buffer);
+    freeBytes += buffer->bytes;
+}
+
+void XFramePool::trim()
+{
+    std::map<Key, std::vector<Buffer*>> released;
+    {
+        QMutexLocker locker(&mutex);
+        released.swap(freeBuffers);
+        freeBytes = 0;
+    }
+    for (auto& entry : released)
+    {
+        for (Buffer* buffer : entry.second)
+            freeBuffer(buffer);
+    }
+}
+
+QString XFramePool::statistics() const
+{
+    QMutexLocker locker(&mutex);
+    return QString("命中 %1, 新分配 %2, 借出 %3, 空闲 %4 MB")
+        .arg(hits)
+        .arg(misses)
+        .arg(outstanding)
+        .arg(freeBytes / 1024.0 / 1024.0, 0, 'f', 1);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <qimage.h>
+#include <qmutex.h>
+#include <qstring.h>
+
+/**
+ * @brief 帧缓冲池，回收叠加、变换与显示各环节的大幅 QImage
+ *
+ * 连续采集时每一帧都会新建多个数兆字节的图像。acquire() 返回的 QImage 直接引用池中
+ * 64 字节对齐的缓冲区，最后一个引用释放时由 QImage 的 cleanupFunction 放回
+ * (宽, 高, 格式) 对应的空闲列表，稳定运行后不再有大块堆分配。
+ *
+ * 池图像与普通 QImage 的用法相同；共享状态下调用 bits() 仍会深拷贝到普通堆内存。
+ * 每种尺寸最多保留 FRAME_POOL_MAX_PER_SIZE 个空闲缓冲，多余的直接释放。
+ */
+class XFramePool
+{
+public:
+    static XFramePool& Instance();
+
+    // 返回内容未初始化的图像；内存不足时返回空图像
+    QImage acquire(int width, int height, QImage::Format format);
+
+    // 释放全部空闲缓冲，已借出的不受影响
+    void trim();
+    QString statistics() const;
+
+    XFramePool(const XFramePool&) = delete;
+    XFramePool& operator=(const XFramePool&) = delete;
+
+private:
+    XFramePool();
+    ~XFramePool();
+
+    struct Key
+    {
+        int width;
+        int height;
+        int format;
+
+        bool operator<(const Key& other) const
+        {
+            return std::tie(width, height, format) < std::tie(other.width, other.height, other.format);
+        }
+    };
+    struct Buffer;
+
+    static void release(void* info);
+    static void freeBuffer(Buffer* buffer);
+    void recycle(Buffer* buffer);
+
+    bool enabled{true};
+    int maxFreePerSize{8};
+
+    mutable QMutex mutex;
+    std::map<Key, std::vector<Buffer*>> freeBuffers;
+    qint64 hits{0};
+    qint64 misses{0};
+    qint64 outstanding{0};
+    qint64 freeBytes{0};
+};
+
+#define xFramePool XFramePool::Instance()
@@ -0,0 +1,278 @@
+#include "XFrameRegistration.h"
+
+#include <qdebug.h>
+#include <qstringlist.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <opencv2/imgproc.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XFR_USE_SSE2
+#endif
+
+#include "Components/XGlobal.h"
+#include "Components/XTileExecutor.h"
+#include "ImageRender/XFramePool.h"
+#include "ImageRender/XImageBinning.h"
+
+namespace
+{
+// 相位相关至少需要的合并后尺寸
+constexpr int MIN_CORRELATION_SIZE = 16;
+
+// 合并到 downsample 倍并转为去均值浮点，宽高写入 width / height
+bool downsampled(const QImage& image, const XFrameRegistration::Options& options, std::vector<float>& pixels,
+                 int& width, int& height)
+{
+    XImageBinning::Options binning;
+    binning.factor = options.downsample;
+    binning.roi = options.roi;
+    const QImage binned = XImageBinning::bin(image, binning);
+    if (binned.isNull() || binned.width() < MIN_CORRELATION_SIZE || binned.height() < MIN_CORRELATION_SIZE)
+    {
+        return false;
+    }
+
+    width = binned.width();
+    height = binned.height();
+    pixels.resize(static_cast<size_t>(width) * height);
+    double sum = 0.0;
+    for (int y = 0; y < height; ++y)
+    {
+        const quint16* src = reinterpret_cast<const quint16*>(binned.constScanLine(y));
+        float* dst = pixels.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x)
+        {
+            dst[x] = src[x];
+            sum += src[x];
+        }
+    }
+
+    // 去掉直流分量，避免加窗后的整体亮度把相关峰拉向零位移
+    const float mean = static_cast<float>(sum / pixels.size());
+    for (float& value : pixels)
+        value -= mean;
+    return true;
+}
+
+// dst[x] = w00 * r0[x] + w01 * r0[x + 1] + w10 * r1[x] + w11 * r1[x + 1]，x ∈ [begin, end)
+// r0 / r1 已按整数位移偏移
+void blendRow(const quint16* r0, const quint16* r1, quint16* dst, int begin, int end, float w00, float w01,
+              float w10, float w11)
+{
+    int x = begin;
+#ifdef XFR_USE_SSE2
+    const __m128i vZero = _mm_setzero_si128();
+    const __m128i vBias = _mm_set1_epi32(32768);
+    const __m128i vFlip = _mm_set1_epi16(static_cast<short>(0x8000));
+    const __m128 v00 = _mm_set1_ps(w00);
+    const __m128 v01 = _mm_set1_ps(w01);
+    const __m128 v10 = _mm_set1_ps(w10);
+    const __m128 v11 = _mm_set1_ps(w11);
+    const __m128 vHalf = _mm_set1_ps(0.5f);
+    for (; x + 8 <= end; x += 8)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + x));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + x + 1));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + x));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + x + 1));
+
+        __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(a, vZero)), v00);
+        lo = _mm_add_ps(lo, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(b, vZero)), v01));
+        lo = _mm_add_ps(lo, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(c, vZero)), v10));
+        lo = _mm_add_ps(lo, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(d, vZero)), v11));
+        __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(a, vZero)), v00);
+        hi = _mm_add_ps(hi, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(b, vZero)), v01));
+        hi = _mm_add_ps(hi, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(c, vZero)), v10));
+        hi = _mm_add_ps(hi, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(d, vZero)), v11));
+
+        // 权重和为 1，结果不超过 65535；减偏置后有符号打包，再翻转符号位还原无符号值
+        const __m128i iLo = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(lo, vHalf)), vBias);
+        const __m128i iHi = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(hi, vHalf)), vBias);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_xor_si128(_mm_packs_epi32(iLo, iHi), vFlip));
+    }
+#endif
+    for (; x < end; ++x)
+    {
+        const float value = w00 * r0[x] + w01 * r0[x + 1] + w10 * r1[x] + w11 * r1[x + 1];
+        dst[x] = static_cast<quint16>(std::min(65535.0f, value + 0.5f));
+    }
+}
+}  // namespace
+
+XFrameRegistration::Options XFrameRegistration::Options::fromConfig()
+{
+    Options options;
+    options.downsample = std::clamp(xGlobal.getInt("SYSTEM", "REG_DOWNSAMPLE", options.downsample), 1, 16);
+    options.minResponse = xGlobal.getDouble("SYSTEM", "REG_MIN_RESPONSE", options.minResponse);
+    options.maxShift = std::max(0.0, xGlobal.getDouble("SYSTEM", "REG_MAX_SHIFT", options.maxShift));
+    options.minShift = std::max(0.0, xGlobal.getDouble("SYSTEM", "REG_MIN_SHIFT", options.minShift));
+
+    const QStringList parts = xGlobal.getString("SYSTEM", "REG_ROI").split(',', Qt::SkipEmptyParts);
+    if (parts.size() == 4)
+    {
+        bool ok[4] = {false, false, false, false};
+        const QRect roi(parts[0].trimmed().toInt(&ok[0]), parts[1].trimmed().toInt(&ok[1]),
+                        parts[2].trimmed().toInt(&ok[2]), parts[3].trimmed().toInt(&ok[3]));
+        if (ok[0] && ok[1] && ok[2] && ok[3] && roi.isValid())
+        {
+            options.roi = roi;
+        }
+        else
+        {
+            qWarning() << "[配准] REG_ROI 格式错误, 应为 x,y,w,h";
+        }
+    }
+    return options;
+}
+
+std::shared_ptr<const XFrameRegistration::Reference> XFrameRegistration::makeReference(const QImage& image,
+                                                                                       const Options& options)
+{
+    if (image.isNull() || image.format() != QImage::Format_Grayscale16)
+    {
+        qWarning() << "[配准] 仅支持 16 位灰度图像:" << image.format();
+        return nullptr;
+    }
+
+    auto reference = std::make_shared<Reference>();
+    reference->options = options;
+    reference->imageSize = image.size();
+    if (!downsampled(image, options, reference->pixels, reference->width, reference->height))
+    {
+        qWarning() << "[配准] 参考区域过小, 不进行配准:" << image.size() << options.roi;
+        return nullptr;
+    }
+
+    reference->window.resize(reference->pixels.size());
+    cv::Mat window(reference->height, reference->width, CV_32F, reference->window.data());
+    cv::createHanningWindow(window, window.size(), CV_32F);
+    return reference;
+}
+
+XFrameRegistration::Result XFrameRegistration::align(const Reference& reference, const QImage& image)
+{
+    Result result;
+    result.image = image;
+    if (image.size() != reference.imageSize || image.format() != QImage::Format_Grayscale16)
+    {
+        qWarning() << "[配准] 图像与参考帧不一致:" << image.size() << image.format();
+        return result;
+    }
+
+    std::vector<float> pixels;
+    int width = 0;
+    int height = 0;
+    if (!downsampled(image, reference.options, pixels, width, height) || width != reference.width ||
+        height != reference.height)
+    {
+        return result;
+    }
+
+    const cv::Mat ref(reference.height, reference.width, CV_32F, const_cast<float*>(reference.pixels.data()));
+    const cv::Mat window(reference.height, reference.width, CV_32F, const_cast<float*>(reference.window.data()));
+    const cv::Mat cur(height, width, CV_32F, pixels.data());
+    const cv::Point2d shift = cv::phaseCorrelate(ref, cur, window, &result.response);
+
+    // 合并后的 1 像素对应全分辨率 downsample 像素
+    const int factor = std::max(1, reference.options.downsample);
+    result.dx = shift.x * factor;
+    result.dy = shift.y * factor;
+
+    const double magnitude = std::hypot(result.dx, result.dy);
+    if (result.response < reference.options.minResponse || magnitude > reference.options.maxShift)
+    {
+        qWarning() << "[配准] 估计不可靠, 该帧不做对齐:" << formatShift(result);
+        return result;
+    }
+    result.valid = true;
+
+    if (magnitude >= reference.options.minShift)
+    {
+        const QImage aligned = translate(image, result.dx, result.dy);
+        if (!aligned.isNull())
+        {
+            result.image = aligned;
+            result.applied = true;
+        }
+    }
+    return result;
+}
+
+QImage XFrameRegistration::translate(const QImage& image, double dx, double dy)
+{
+    if (image.isNull() || image.format() != QImage::Format_Grayscale16)
+    {
+        qWarning() << "[配准] 仅支持 16 位灰度图像:" << image.format();
+        return QImage();
+    }
+
+    const int width = image.width();
+    const int height = image.height();
+    QImage result = xFramePool.acquire(width, height, QImage::Format_Grayscale16);
+    if (result.isNull())
+    {
+        return QImage();
+    }
+
+    // 整帧平移，小数部分对所有像素相同，双线性权重只算一次
+    const int ix = static_cast<int>(std::floor(dx));
+    const int iy = static_cast<int>(std::floor(dy));
+    const float fx = static_cast<float>(dx - ix);
+    const float fy = static_cast<float>(dy - iy);
+    const float w00 = (1.0f - fx) * (1.0f - fy);
+    const float w01 = fx * (1.0f - fy);
+    const float w10 = (1.0f - fx) * fy;
+    const float w11 = fx * fy;
+
+    // 源列 x + ix 与 x + ix + 1 都在图像内的输出列区间
+    const int innerBegin = std::clamp(-ix, 0, width);
+    const int innerEnd = std::clamp(width - 1 - ix, innerBegin, width);
+
+    uchar* dstBits = result.bits();
+    const qsizetype dstBytesPerLine = result.bytesPerLine();
+    xTiles.parallelForTiles(
+        height, static_cast<qsizetype>(width) * 2 * sizeof(quint16),
+        [&](int y0, int y1)
+        {
+            for (int y = y0; y < y1; ++y)
+            {
+                // 越界行按边缘复制
+                const quint16* r0 =
+                    reinterpret_cast<const quint16*>(image.constScanLine(std::clamp(y + iy, 0, height - 1)));
+                const quint16* r1 =
+                    reinterpret_cast<const quint16*>(image.constScanLine(std::clamp(y + iy + 1, 0, height - 1)));
+                quint16* dst = reinterpret_cast<quint16*>(dstBits + y * dstBytesPerLine);
+
+                if (innerEnd > innerBegin)
+                {
+                    blendRow(r0 + ix, r1 + ix, dst, innerBegin, innerEnd, w00, w01, w10, w11);
+                }
+
+                // 左右越界列逐像素处理
+                auto edge = [&](int x)
+                {
+                    const int c0 = std::clamp(x + ix, 0, width - 1);
+                    const int c1 = std::clamp(x + ix + 1, 0, width - 1);
+                    const float value = w00 * r0[c0] + w01 * r0[c1] + w10 * r1[c0] + w11 * r1[c1];
+                    dst[x] = static_cast<quint16>(std::min(65535.0f, value + 0.5f));
+                };
+                for (int x = 0; x < innerBegin; ++x)
+                    edge(x);
+                for (int x = innerEnd; x < width; ++x)
+                    edge(x);
+            }
+        });
+    return result;
+}
+
+QString XFrameRegistration::formatShift(const Result& result)
+{
+    return QString("dx %1, dy %2 px, 响应 %3")
+        .arg(result.dx, 0, 'f', 2)
+        .arg(result.dy, 0, 'f', 2)
+        .arg(result.response, 0, 'f', 3);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <qimage.h>
+#include <qrect.h>
+#include <qstring.h>
+
+/**
+ * @brief 叠加前的子帧配准：估计并补偿整帧平移（振动 / 漂移）
+ *
+ * 便携式架设时被检物体或平板在长时间叠加中会轻微移动，直接平均会使结果模糊。
+ * 组内首帧作为参考，其余各帧：
+ * - 在 factor×factor 合并后的副本上做 FFT 相位相关（Hann 窗，去均值），得到亚像素平移；
+ * - 相关峰响应过低或位移超出上限时认为估计不可靠，原样参与叠加；
+ * - 位移小于 minShift 时不重采样，否则按常数双线性权重平移，内部区域 SSE2 每次 8 像素，
+ *   越界部分按边缘像素复制，输出行按条带并行（XTileExecutor），结果从帧池分配。
+ * 仅支持 16 位灰度图像。
+ */
+class XFrameRegistration
+{
+public:
+    struct Options
+    {
+        int downsample{4};        // 相位相关前的合并倍数
+        double minResponse{0.1};  // 相关峰响应下限
+        double maxShift{50.0};    // 位移上限，全分辨率像素
+        double minShift{0.1};     // 小于该位移时不重采样
+        QRect roi;                // 参与相关的区域，图像坐标，空表示整幅
+
+        // [SYSTEM] REG_DOWNSAMPLE / REG_MIN_RESPONSE / REG_MAX_SHIFT / REG_MIN_SHIFT / REG_ROI ("x,y,w,h")
+        static Options fromConfig();
+    };
+
+    // 参考帧：合并后的去均值浮点副本与 Hann 窗，组内各帧共享，只读
+    struct Reference
+    {
+        Options options;
+        QSize imageSize;
+        int width{0};
+        int height{0};
+        std::vector<float> pixels;
+        std::vector<float> window;
+    };
+
+    struct Result
+    {
+        QImage image;    // 对齐后的图像；未重采样时与输入共享数据
+        double dx{0.0};  // image(x + dx, y + dy) 对应参考帧 (x, y)
+        double dy{0.0};
+        double response{0.0};
+        bool valid{false};    // 估计可靠
+        bool applied{false};  // 已重采样
+    };
+
+    // 图像过小或格式不符时返回空指针
+    static std::shared_ptr<const Reference> makeReference(const QImage& image, const Options& options);
+    static Result align(const Reference& reference, const QImage& image);
+
+    // out(x, y) = image(x + dx, y + dy)，双线性插值，越界按边缘复制
+    static QImage translate(const QImage& image, double dx, double dy);
+
+    static QString formatShift(const Result& result);
+};
@@ -224,6 +224,21 @@ void XGraphicsView::addImageToList(QImage image)
     srcU16ImageList.append(image);
 }
 
+void XGraphicsView::setImageList(const QList<QImage>& images)
+{
+    srcU16ImageList = images;
+    emit signalSrcU16ImageListSizeChanged(srcU16ImageList.size());
+    if (!srcU16ImageList.isEmpty())
+    {
+        updateImage(srcU16ImageList.first(), true);
+    }
+}
+
+const QList<QImage>& XGraphicsView::getSrcU16ImageList() const
+{
+    return srcU16ImageList;
+}
+
 void XGraphicsView::onWindowLevelChanged(int width, int level)
 {
     // 当窗宽窗位改变时，更新Scene显示
@@ -434,10 +449,7 @@ void XGraphicsView::openImageFolder()
                 }
                 else
                 {
-                    srcU16ImageList.clear();
-                    srcU16ImageList = result;
-                    emit signalSrcU16ImageListSizeChanged(srcU16ImageList.size());
-                    updateImage(srcU16ImageList.first(), true);
+                    setImageList(result);
 
                     qDebug() << "成功读取" << result.size() << "/" << fileList.size() << "个图像文件";
                 }
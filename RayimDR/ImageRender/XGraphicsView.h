@@ -56,6 +56,9 @@ public:
     void clearCurrentImageList();               ///< 清空图像列表
     void addImageToList(QImage image);          ///< 添加图像到列表
 
+    void setImageList(const QList<QImage>& images);   ///< 替换图像列表并显示第一张
+    const QList<QImage>& getSrcU16ImageList() const;  ///< 获取图像列表
+
 private:
     void initContextMenu();                           ///< 初始化右键菜单
     void onWindowLevelChanged(int width, int level);  ///< 窗宽窗位变化回调
@@ -0,0 +1,335 @@
+#include "XHdrFusion.h"
+
+#include <qdebug.h>
+#include <qelapsedtimer.h>
+#include <qstringlist.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XHF_USE_SSE2
+#endif
+
+#include "Components/XGlobal.h"
+#include "Components/XTileExecutor.h"
+#include "ImageRender/XFramePool.h"
+
+namespace
+{
+// 档位映射拟合的采样步长与最少有效样本数
+constexpr int SAMPLE_STEP = 4;
+constexpr qint64 MIN_FIT_SAMPLES = 256;
+
+// 单个档位在核心中使用的常量
+struct Weighting
+{
+    float slope{1.0f};
+    float offset{0.0f};
+    float varianceScale{1.0f};  // slope²
+    float saturation{60000.0f};
+    float dark{0.0f};
+    float invRamp{1.0f / 4000.0f};
+    float noiseFloor{100.0f};
+};
+
+double sampledMean(const QImage& image)
+{
+    double sum = 0.0;
+    qint64 count = 0;
+    for (int y = 0; y < image.height(); y += SAMPLE_STEP)
+    {
+        const quint16* row = reinterpret_cast<const quint16*>(image.constScanLine(y));
+        for (int x = 0; x < image.width(); x += SAMPLE_STEP, ++count)
+            sum += row[x];
+    }
+    return count > 0 ? sum / count : 0.0;
+}
+
+// 在两档都处于有效范围的采样点上拟合 dst ≈ a·src + b；样本不足时按本底以上均值之比估计斜率
+void fitMapping(const QImage& src, const QImage& dst, const XHdrFusion::Options& options, double& a, double& b)
+{
+    const double low = options.darkLevel + options.ramp;
+    const double high = options.saturation - options.ramp;
+    double sx = 0.0;
+    double sy = 0.0;
+    double sxx = 0.0;
+    double sxy = 0.0;
+    qint64 n = 0;
+    for (int y = 0; y < src.height(); y += SAMPLE_STEP)
+    {
+        const quint16* rowSrc = reinterpret_cast<const quint16*>(src.constScanLine(y));
+        const quint16* rowDst = reinterpret_cast<const quint16*>(dst.constScanLine(y));
+        for (int x = 0; x < src.width(); x += SAMPLE_STEP)
+        {
+            const double u = rowSrc[x];
+            const double v = rowDst[x];
+            if (u < low || u > high || v < low || v > high)
+                continue;
+            sx += u;
+            sy += v;
+            sxx += u * u;
+            sxy += u * v;
+            ++n;
+        }
+    }
+
+    const double denominator = n * sxx - sx * sx;
+    if (n >= MIN_FIT_SAMPLES && denominator > 0.0)
+    {
+        a = (n * sxy - sx * sy) / denominator;
+        b = (sy - a * sx) / n;
+        if (a > 0.0)
+            return;
+    }
+
+    const double meanSrc = sampledMean(src) - options.darkLevel;
+    const double meanDst = sampledMean(dst) - options.darkLevel;
+    a = meanSrc > 0.0 && meanDst > 0.0 ? meanDst / meanSrc : 1.0;
+    b = options.darkLevel * (1.0 - a);
+    qWarning() << "[HDR] 相邻档位重叠的有效像素不足 (" << n << "), 按均值比估计映射, a =" << a;
+}
+
+// acc[x] += w·(a·v + b)，wsum[x] += w，w = 帽形权重 / (a²·max(v - dark, floor))
+void accumulateRow(const quint16* src, const Weighting& p, float* acc, float* wsum, int width)
+{
+    int x = 0;
+#ifdef XHF_USE_SSE2
+    const __m128i vZero = _mm_setzero_si128();
+    const __m128 vZeroF = _mm_setzero_ps();
+    const __m128 vOne = _mm_set1_ps(1.0f);
+    const __m128 vSlope = _mm_set1_ps(p.slope);
+    const __m128 vOffset = _mm_set1_ps(p.offset);
+    const __m128 vScale = _mm_set1_ps(p.varianceScale);
+    const __m128 vSat = _mm_set1_ps(p.saturation);
+    const __m128 vDark = _mm_set1_ps(p.dark);
+    const __m128 vInvRamp = _mm_set1_ps(p.invRamp);
+    const __m128 vFloor = _mm_set1_ps(p.noiseFloor);
+    for (; x + 8 <= width; x += 8)
+    {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const __m128 values[2] = {_mm_cvtepi32_ps(_mm_unpacklo_epi16(raw, vZero)),
+                                  _mm_cvtepi32_ps(_mm_unpackhi_epi16(raw, vZero))};
+        for (int half = 0; half < 2; ++half)
+        {
+            const __m128 v = values[half];
+            const __m128 above = _mm_sub_ps(v, vDark);
+            const __m128 hi = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(vSat, v), vInvRamp), vZeroF), vOne);
+            const __m128 lo = _mm_min_ps(_mm_max_ps(_mm_mul_ps(above, vInvRamp), vZeroF), vOne);
+            const __m128 variance = _mm_mul_ps(_mm_max_ps(above, vFloor), vScale);
+            const __m128 w = _mm_div_ps(_mm_mul_ps(hi, lo), variance);
+            float* a = acc + x + half * 4;
+            float* s = wsum + x + half * 4;
+            _mm_storeu_ps(a, _mm_add_ps(_mm_loadu_ps(a), _mm_mul_ps(w, _mm_add_ps(_mm_mul_ps(v, vSlope), vOffset))));
+            _mm_storeu_ps(s, _mm_add_ps(_mm_loadu_ps(s), w));
+        }
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        const float v = src[x];
+        const float above = v - p.dark;
+        const float hi = std::clamp((p.saturation - v) * p.invRamp, 0.0f, 1.0f);
+        const float lo = std::clamp(above * p.invRamp, 0.0f, 1.0f);
+        const float w = hi * lo / (std::max(above, p.noiseFloor) * p.varianceScale);
+        acc[x] += w * (v * p.slope + p.offset);
+        wsum[x] += w;
+    }
+}
+
+// dst[x] = wsum[x] > 0 ? acc[x] / wsum[x] : fallback[x]，四舍五入并限制在 16 位范围
+void resolveRow(const float* acc, const float* wsum, const quint16* fallback, quint16* dst, int width)
+{
+    int x = 0;
+#ifdef XHF_USE_SSE2
+    const __m128i vZero = _mm_setzero_si128();
+    const __m128 vZeroF = _mm_setzero_ps();
+    const __m128 vHalf = _mm_set1_ps(0.5f);
+    const __m128 vMax = _mm_set1_ps(65535.0f);
+    const __m128 vTiny = _mm_set1_ps(1e-30f);
+    const __m128i vBias = _mm_set1_epi32(32768);
+    const __m128i vFlip = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (; x + 8 <= width; x += 8)
+    {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(fallback + x));
+        const __m128 fb[2] = {_mm_cvtepi32_ps(_mm_unpacklo_epi16(raw, vZero)),
+                              _mm_cvtepi32_ps(_mm_unpackhi_epi16(raw, vZero))};
+        __m128i packed[2];
+        for (int half = 0; half < 2; ++half)
+        {
+            const __m128 s = _mm_loadu_ps(wsum + x + half * 4);
+            const __m128 mask = _mm_cmpgt_ps(s, vZeroF);
+            const __m128 q = _mm_div_ps(_mm_loadu_ps(acc + x + half * 4), _mm_max_ps(s, vTiny));
+            __m128 value = _mm_or_ps(_mm_and_ps(mask, q), _mm_andnot_ps(mask, fb[half]));
+            value = _mm_min_ps(_mm_max_ps(_mm_add_ps(value, vHalf), vZeroF), vMax);
+            packed[half] = _mm_sub_epi32(_mm_cvttps_epi32(value), vBias);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x),
+                         _mm_xor_si128(_mm_packs_epi32(packed[0], packed[1]), vFlip));
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        const float value = wsum[x] > 0.0f ? acc[x] / wsum[x] : static_cast<float>(fallback[x]);
+        dst[x] = static_cast<quint16>(std::clamp(value + 0.5f, 0.0f, 65535.0f));
+    }
+}
+}  // namespace
+
+XHdrFusion::Options XHdrFusion::Options::fromConfig()
+{
+    Options options;
+    const int minVoltage = xGlobal.getInt("XRAY", "XRAY_MIN_VOLTAGE", 30);
+    const int maxVoltage = xGlobal.getInt("XRAY", "XRAY_MAX_VOLTAGE", 120);
+    const int minCurrent = xGlobal.getInt("XRAY", "XRAY_MIN_CURRENT", 200);
+    const int maxCurrent = xGlobal.getInt("XRAY", "XRAY_MAX_CURRENT", 1000);
+    for (const QString& item : xGlobal.getString("HDR", "HDR_BRACKET").split(',', Qt::SkipEmptyParts))
+    {
+        const QStringList pair = item.trimmed().split(':');
+        bool okV = false;
+        bool okC = false;
+        Exposure exposure;
+        if (pair.size() == 2)
+        {
+            exposure.voltage = pair[0].trimmed().toInt(&okV);
+            exposure.current = pair[1].trimmed().toInt(&okC);
+        }
+        if (!okV || !okC)
+        {
+            qWarning() << "[HDR] HDR_BRACKET 格式错误, 忽略:" << item << ", 应为 kV:uA";
+            continue;
+        }
+        exposure.voltage = std::clamp(exposure.voltage, minVoltage, maxVoltage);
+        exposure.current = std::clamp(exposure.current, minCurrent, maxCurrent);
+        options.bracket.append(exposure);
+    }
+
+    options.skipFrames = std::max(0, xGlobal.getInt("HDR", "HDR_SKIP_FRAMES", options.skipFrames));
+    options.saturation = xGlobal.getDouble("HDR", "HDR_SATURATION", options.saturation);
+    options.darkLevel = xGlobal.getDouble("HDR", "HDR_DARK_LEVEL", options.darkLevel);
+    options.ramp = std::max(1.0, xGlobal.getDouble("HDR", "HDR_RAMP", options.ramp));
+    options.noiseFloor = std::max(1.0, xGlobal.getDouble("HDR", "HDR_NOISE_FLOOR", options.noiseFloor));
+    return options;
+}
+
+QString XHdrFusion::formatBracket(const QVector<Exposure>& bracket)
+{
+    QStringList parts;
+    for (const Exposure& exposure : bracket)
+        parts.append(QString("%1kV/%2uA").arg(exposure.voltage).arg(exposure.current));
+    return parts.join(", ");
+}
+
+QString XHdrFusion::Result::summary() const
+{
+    if (image.isNull())
+    {
+        return "HDR 融合失败";
+    }
+    QStringList maps;
+    for (int i = 0; i < slopes.size(); ++i)
+    {
+        maps.append(
+            QString("%1·v%2%3").arg(slopes[i], 0, 'f', 3).arg(offsets[i] < 0 ? "" : "+").arg(offsets[i], 0, 'f', 0));
+    }
+    return QString("HDR 融合 %1 档, 参考第 %2 档, 映射 [%3], 耗时 %4 ms")
+        .arg(slopes.size())
+        .arg(reference + 1)
+        .arg(maps.join(", "))
+        .arg(ms, 0, 'f', 1);
+}
+
+XHdrFusion::Result XHdrFusion::fuse(const QVector<QImage>& exposures, const Options& options)
+{
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+
+    const int count = exposures.size();
+    if (count == 0)
+    {
+        return result;
+    }
+    const QSize size = exposures.first().size();
+    for (const QImage& image : exposures)
+    {
+        if (image.isNull() || image.format() != QImage::Format_Grayscale16 || image.size() != size)
+        {
+            qWarning() << "[HDR] 各档图像须为同尺寸的 16 位灰度图像:" << image.size() << image.format();
+            return result;
+        }
+    }
+
+    // 从暗到亮排序，相邻档位逐级拟合并复合到最暗一档
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<double> means(count);
+    for (int i = 0; i < count; ++i)
+        means[i] = sampledMean(exposures[i]);
+    std::stable_sort(order.begin(), order.end(), [&](int l, int r) { return means[l] < means[r]; });
+
+    result.reference = order.front();
+    result.slopes.fill(1.0, count);
+    result.offsets.fill(0.0, count);
+    for (int k = 1; k < count; ++k)
+    {
+        const int current = order[k];
+        const int previous = order[k - 1];
+        double a = 1.0;
+        double b = 0.0;
+        fitMapping(exposures[current], exposures[previous], options, a, b);
+        result.slopes[current] = result.slopes[previous] * a;
+        result.offsets[current] = result.slopes[previous] * b + result.offsets[previous];
+    }
+
+    const int width = size.width();
+    const int height = size.height();
+    result.image = xFramePool.acquire(width, height, QImage::Format_Grayscale16);
+    if (result.image.isNull())
+    {
+        return result;
+    }
+
+    std::vector<Weighting> weightings(count);
+    for (int i = 0; i < count; ++i)
+    {
+        Weighting& p = weightings[i];
+        p.slope = static_cast<float>(result.slopes[i]);
+        p.offset = static_cast<float>(result.offsets[i]);
+        p.varianceScale = p.slope * p.slope;
+        p.saturation = static_cast<float>(options.saturation);
+        p.dark = static_cast<float>(options.darkLevel);
+        p.invRamp = static_cast<float>(1.0 / options.ramp);
+        p.noiseFloor = static_cast<float>(options.noiseFloor);
+    }
+
+    const QImage& reference = exposures[result.reference];
+    uchar* dstBits = result.image.bits();
+    const qsizetype dstBytesPerLine = result.image.bytesPerLine();
+    xTiles.parallelForTiles(
+        height, static_cast<qsizetype>(width) * count * sizeof(quint16),
+        [&](int y0, int y1)
+        {
+            std::vector<float> acc(width);
+            std::vector<float> wsum(width);
+            for (int y = y0; y < y1; ++y)
+            {
+                std::fill(acc.begin(), acc.end(), 0.0f);
+                std::fill(wsum.begin(), wsum.end(), 0.0f);
+                for (int i = 0; i < count; ++i)
+                {
+                    accumulateRow(reinterpret_cast<const quint16*>(exposures[i].constScanLine(y)), weightings[i],
+                                  acc.data(), wsum.data(), width);
+                }
+                resolveRow(acc.data(), wsum.data(), reinterpret_cast<const quint16*>(reference.constScanLine(y)),
+                           reinterpret_cast<quint16*>(dstBits + y * dstBytesPerLine), width);
+            }
+        });
+
+    result.ms = timer.nsecsElapsed() / 1e6;
+    qInfo() << "[HDR]" << result.summary();
+    return result;
+}
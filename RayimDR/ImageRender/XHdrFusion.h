@@ -0,0 +1,59 @@
+#pragma once
+
+#include <qimage.h>
+#include <qstring.h>
+#include <qvector.h>
+
+/**
+ * @brief 多档 kV / uA 曝光的高动态范围融合
+ *
+ * 厚薄差异大的工件在单一电压下总有一部分欠曝或饱和。HDR 采集按档位逐档出束、叠加，
+ * 再把各档图像逐像素融合为一幅：
+ * - 按采样均值从暗到亮排序，最暗一档为参考；相邻两档在都未饱和、未欠曝的采样点上做
+ *   最小二乘仿射拟合 v_prev ≈ a·v + b，沿档位链复合得到各档到参考档的映射；
+ * - 每个像素的权重 = 饱和 / 本底附近线性衰减的帽形权重 × 映射后噪声方差的倒数
+ *   （光子噪声方差近似正比于 v - dark），因此亮档在厚区提供低噪声数据，暗档填补饱和区；
+ * - 所有档位都无有效权重时取参考档的值。
+ * 结果以参考档（最暗档）的灰度标度写入 16 位图像：亮档数据映射后带小数，但其噪声远大于量化步长，
+ * 16 位足以保留扩展的动态范围。
+ *
+ * 核心按行块并行（XTileExecutor），每行依次累加各档，SSE2 每次处理 8 像素，结果从帧池分配。
+ */
+class XHdrFusion
+{
+public:
+    struct Exposure
+    {
+        int voltage{0};  // kV
+        int current{0};  // uA
+    };
+
+    struct Options
+    {
+        QVector<Exposure> bracket;
+        int skipFrames{2};           // 切换档位后丢弃的帧数
+        double saturation{60000.0};  // 饱和灰度
+        double darkLevel{0.0};       // 本底灰度
+        double ramp{4000.0};         // 饱和 / 本底附近权重的过渡宽度
+        double noiseFloor{100.0};    // 噪声方差下限，避免近本底像素权重发散
+
+        // [HDR] HDR_BRACKET ("kV:uA,kV:uA,...") / HDR_SKIP_FRAMES / HDR_SATURATION / HDR_DARK_LEVEL /
+        //       HDR_RAMP / HDR_NOISE_FLOOR
+        static Options fromConfig();
+    };
+
+    struct Result
+    {
+        QImage image;
+        int reference{-1};        // 参考档在输入中的序号
+        QVector<double> slopes;   // 各档映射到参考档的 a
+        QVector<double> offsets;  // 各档映射到参考档的 b
+        double ms{0.0};
+
+        QString summary() const;
+    };
+
+    // 输入为同尺寸的 16 位灰度图像，顺序与 bracket 一致
+    static Result fuse(const QVector<QImage>& exposures, const Options& options);
+    static QString formatBracket(const QVector<Exposure>& bracket);
+};
@@ -0,0 +1,140 @@
+#include "XImageBinning.h"
+
+#include <qdebug.h>
+#include <qstringlist.h>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XIB_USE_SSE2
+#endif
+
+#include "Components/XGlobal.h"
+#include "Components/XTileExecutor.h"
+#include "ImageRender/XFramePool.h"
+
+namespace
+{
+// acc[x] += src[x]
+void accumulateRow(quint32* acc, const quint16* src, int width)
+{
+    int x = 0;
+#ifdef XIB_USE_SSE2
+    const __m128i vZero = _mm_setzero_si128();
+    for (; x + 8 <= width; x += 8)
+    {
+        __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        __m128i* dst = reinterpret_cast<__m128i*>(acc + x);
+        _mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), _mm_unpacklo_epi16(raw, vZero)));
+        _mm_storeu_si128(dst + 1, _mm_add_epi32(_mm_loadu_si128(dst + 1), _mm_unpackhi_epi16(raw, vZero)));
+    }
+#endif
+    for (; x < width; ++x)
+        acc[x] += src[x];
+}
+
+void binRow(const quint32* acc, quint16* dst, int outWidth, int factor)
+{
+    const quint32 count = static_cast<quint32>(factor) * factor;
+    const quint32 half = count / 2;
+    for (int x = 0; x < outWidth; ++x)
+    {
+        const quint32* group = acc + x * factor;
+        quint32 sum = 0;
+        for (int i = 0; i < factor; ++i)
+            sum += group[i];
+        dst[x] = static_cast<quint16>((sum + half) / count);
+    }
+}
+}  // namespace
+
+XImageBinning::Options XImageBinning::Options::fromConfig()
+{
+    Options options;
+    options.factor = std::clamp(xGlobal.getInt("SYSTEM", "PREVIEW_BINNING", 1), 1, 8);
+    options.decimate = xGlobal.getBool("SYSTEM", "PREVIEW_DECIMATE", false);
+
+    const QStringList parts = xGlobal.getString("SYSTEM", "PREVIEW_ROI").split(',', Qt::SkipEmptyParts);
+    if (parts.size() == 4)
+    {
+        bool ok[4] = {false, false, false, false};
+        const QRect roi(parts[0].trimmed().toInt(&ok[0]), parts[1].trimmed().toInt(&ok[1]),
+                        parts[2].trimmed().toInt(&ok[2]), parts[3].trimmed().toInt(&ok[3]));
+        if (ok[0] && ok[1] && ok[2] && ok[3] && roi.isValid())
+        {
+            options.roi = roi;
+        }
+        else
+        {
+            qWarning() << "[预览] PREVIEW_ROI 格式错误, 应为 x,y,w,h";
+        }
+    }
+    return options;
+}
+
+QImage XImageBinning::bin(const QImage& image, const Options& options)
+{
+    if (image.isNull() || image.format() != QImage::Format_Grayscale16)
+    {
+        qWarning() << "[预览] 仅支持 16 位灰度图像:" << image.format();
+        return QImage();
+    }
+
+    const int factor = std::max(1, options.factor);
+    QRect roi = options.roi.isNull() ? image.rect() : options.roi.intersected(image.rect());
+    roi.setWidth(roi.width() / factor * factor);
+    roi.setHeight(roi.height() / factor * factor);
+    if (roi.isEmpty())
+    {
+        return QImage();
+    }
+
+    if (factor == 1)
+    {
+        return roi == image.rect() ? image : image.copy(roi);
+    }
+
+    const int outWidth = roi.width() / factor;
+    const int outHeight = roi.height() / factor;
+    QImage result = xFramePool.acquire(outWidth, outHeight, QImage::Format_Grayscale16);
+    if (result.isNull())
+    {
+        return QImage();
+    }
+
+    // 输出行按源数据量（factor 行源像素）分块
+    const bool decimate = options.decimate;
+    uchar* dstBits = result.bits();
+    const qsizetype dstBytesPerLine = result.bytesPerLine();
+    const qsizetype srcBytesPerRow = static_cast<qsizetype>(roi.width()) * factor * sizeof(quint16);
+    xTiles.parallelForTiles(outHeight, srcBytesPerRow,
+                            [&](int y0, int y1)
+                            {
+                                std::vector<quint32> acc(decimate ? 0 : roi.width());
+                                for (int y = y0; y < y1; ++y)
+                                {
+                                    quint16* dst = reinterpret_cast<quint16*>(dstBits + y * dstBytesPerLine);
+                                    const int srcY = roi.y() + y * factor;
+                                    if (decimate)
+                                    {
+                                        const quint16* src =
+                                            reinterpret_cast<const quint16*>(image.constScanLine(srcY)) + roi.x();
+                                        for (int x = 0; x < outWidth; ++x)
+                                            dst[x] = src[x * factor];
+                                        continue;
+                                    }
+
+                                    std::fill(acc.begin(), acc.end(), 0u);
+                                    for (int r = 0; r < factor; ++r)
+                                    {
+                                        const quint16* src =
+                                            reinterpret_cast<const quint16*>(image.constScanLine(srcY + r)) + roi.x();
+                                        accumulateRow(acc.data(), src, roi.width());
+                                    }
+                                    binRow(acc.data(), dst, outWidth, factor);
+                                }
+                            });
+    return result;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <qimage.h>
+#include <qrect.h>
+
+/**
+ * @brief 软件像素合并 / ROI 裁剪，用于实时预览
+ *
+ * 探测器硬件合并模式需要通过 UpdateMode 切换，耗时且会阻塞采集启动。
+ * 预览时改为对全分辨率帧在软件中做 factor×factor 盒式平均（或直接抽点），
+ * 可选先裁剪到 ROI，使叠加、变换与显示都在缩小后的图像上进行。
+ *
+ * 盒式平均按行累加到 32 位列和（SSE2），再按列分组求均值，输出行按条带并行。
+ */
+class XImageBinning
+{
+public:
+    struct Options
+    {
+        int factor{1};          // 1 表示不合并
+        bool decimate{false};   // true: 取每个块左上角像素，false: 块内平均
+        QRect roi;              // 探测器坐标，空表示整幅
+
+        bool enabled() const { return factor > 1 || !roi.isNull(); }
+
+        // [SYSTEM] PREVIEW_BINNING / PREVIEW_DECIMATE / PREVIEW_ROI ("x,y,w,h")
+        static Options fromConfig();
+    };
+
+    // 仅支持 16 位灰度图像；ROI 与图像求交后按 factor 向下对齐，结果为空时返回空图像
+    static QImage bin(const QImage& image, const Options& options);
+};
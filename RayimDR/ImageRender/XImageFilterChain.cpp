@@ -0,0 +1,221 @@
+#include "XImageFilterChain.h"
+
+#include <qdebug.h>
+#include <qelapsedtimer.h>
+#include <qstringlist.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include <opencv2/opencv.hpp>
+
+#include "Components/XGlobal.h"
+#include "Components/XTileExecutor.h"
+
+namespace
+{
+// 包装 QImage 像素，不拷贝
+cv::Mat wrap(const QImage& image)
+{
+    return cv::Mat(image.height(), image.width(), CV_16UC1, const_cast<uchar*>(image.constBits()),
+                   static_cast<size_t>(image.bytesPerLine()));
+}
+
+cv::Mat wrap(QImage& image)
+{
+    return cv::Mat(image.height(), image.width(), CV_16UC1, image.bits(), static_cast<size_t>(image.bytesPerLine()));
+}
+
+// 与 OpenCV 对 16 位输入自动选取的高斯核一致（半径约 4σ），显式传入保证条带 halo 覆盖整个核
+int unsharpKernelSize(double sigma)
+{
+    return cvRound(sigma * 4 * 2 + 1) | 1;
+}
+
+int haloRows(const XImageFilterChain::Filter& filter)
+{
+    switch (filter.type)
+    {
+        case XImageFilterChain::FilterType::Median:
+            return filter.kernelSize / 2;
+        case XImageFilterChain::FilterType::Unsharp:
+            return unsharpKernelSize(filter.sigma) / 2;
+        default:
+            return 0;
+    }
+}
+
+void filterBand(const XImageFilterChain::Filter& filter, const cv::Mat& src, cv::Mat& dst)
+{
+    switch (filter.type)
+    {
+        case XImageFilterChain::FilterType::Median:
+            cv::medianBlur(src, dst, filter.kernelSize);
+            break;
+        case XImageFilterChain::FilterType::Unsharp:
+        {
+            cv::Mat blurred;
+            const int ksize = unsharpKernelSize(filter.sigma);
+            cv::GaussianBlur(src, blurred, cv::Size(ksize, ksize), filter.sigma);
+            cv::addWeighted(src, 1.0 + filter.amount, blurred, -filter.amount, 0.0, dst, CV_16U);
+            break;
+        }
+        default:
+            src.copyTo(dst);
+            break;
+    }
+}
+
+// 按行条带并行执行邻域滤波，每个条带带上下 halo 行一起计算，只写回本条带
+bool runBanded(const XImageFilterChain::Filter& filter, const cv::Mat& src, cv::Mat& dst, int bandRows)
+{
+    const int height = src.rows;
+    const int halo = haloRows(filter);
+
+    // 工作线程中的异常不能跨出执行器，记录后由调用方处理
+    std::atomic_bool failed{false};
+    xTiles.parallelForTiles(height, 0,
+                            [&](int y0, int y1)
+                            {
+                                const int a = std::max(0, y0 - halo);
+                                const int b = std::min(height, y1 + halo);
+
+                                try
+                                {
+                                    cv::Mat out;
+                                    filterBand(filter, src.rowRange(a, b), out);
+                                    cv::Mat target = dst.rowRange(y0, y1);
+                                    out.rowRange(y0 - a, y1 - a).copyTo(target);
+                                }
+                                catch (const cv::Exception& e)
+                                {
+                                    qCritical() << "[图像处理] 条带" << y0 << "滤波失败:" << e.what();
+                                    failed.store(true);
+                                }
+                            },
+                            bandRows);
+    return !failed.load();
+}
+}  // namespace
+
+XImageFilterChain XImageFilterChain::fromConfig()
+{
+    XImageFilterChain chain;
+    if (!xGlobal.getBool("FILTER", "FILTER_ENABLE", false))
+    {
+        return chain;
+    }
+
+    chain.setBandRows(xGlobal.getInt("FILTER", "FILTER_BAND_ROWS", 128));
+
+    const QStringList names = xGlobal.getString("FILTER", "FILTER_CHAIN").split(',', Qt::SkipEmptyParts);
+    for (const QString& rawName : names)
+    {
+        const QString name = rawName.trimmed().toLower();
+        Filter filter;
+        if (name == "median")
+        {
+            filter.type = FilterType::Median;
+            // OpenCV 16 位中值滤波只支持 3 / 5
+            filter.kernelSize = xGlobal.getInt("FILTER", "FILTER_MEDIAN_KSIZE", 3) >= 5 ? 5 : 3;
+        }
+        else if (name == "unsharp")
+        {
+            filter.type = FilterType::Unsharp;
+            filter.sigma = std::max(0.3, xGlobal.getDouble("FILTER", "FILTER_UNSHARP_SIGMA", filter.sigma));
+            filter.amount = xGlobal.getDouble("FILTER", "FILTER_UNSHARP_AMOUNT", filter.amount);
+        }
+        else if (name == "clahe")
+        {
+            filter.type = FilterType::Clahe;
+            filter.clipLimit = xGlobal.getDouble("FILTER", "FILTER_CLAHE_CLIP", filter.clipLimit);
+            filter.tiles = std::clamp(xGlobal.getInt("FILTER", "FILTER_CLAHE_TILES", filter.tiles), 1, 64);
+        }
+        else
+        {
+            qWarning() << "[图像处理] 未知的滤波器:" << rawName;
+            continue;
+        }
+        chain.append(filter);
+    }
+    return chain;
+}
+
+QString XImageFilterChain::filterName(const Filter& filter)
+{
+    switch (filter.type)
+    {
+        case FilterType::Median:
+            return QString("median%1x%1").arg(filter.kernelSize);
+        case FilterType::Unsharp:
+            return QString("unsharp(s=%1,a=%2)").arg(filter.sigma).arg(filter.amount);
+        case FilterType::Clahe:
+            return QString("clahe(clip=%1,tiles=%2)").arg(filter.clipLimit).arg(filter.tiles);
+    }
+    return QString();
+}
+
+QString XImageFilterChain::formatTimings(const QList<Timing>& timings)
+{
+    QStringList parts;
+    double total = 0.0;
+    for (const Timing& timing : timings)
+    {
+        parts << QString("%1 %2 ms").arg(timing.name).arg(timing.ms, 0, 'f', 2);
+        total += timing.ms;
+    }
+    return QString("%1, 合计 %2 ms").arg(parts.join(", ")).arg(total, 0, 'f', 2);
+}
+
+QImage XImageFilterChain::apply(const QImage& image, QList<Timing>* timings) const
+{
+    if (filters.isEmpty())
+    {
+        return image;
+    }
+    if (image.isNull() || image.format() != QImage::Format_Grayscale16)
+    {
+        qWarning() << "[图像处理] 仅支持 16 位灰度图像:" << image.format();
+        return image;
+    }
+
+    // 中间结果逐级传递，最后一步直接写入结果图像
+    QImage result(image.size(), QImage::Format_Grayscale16);
+    cv::Mat current = wrap(image);
+    QElapsedTimer timer;
+
+    try
+    {
+        for (int i = 0; i < filters.size(); ++i)
+        {
+            const Filter& filter = filters[i];
+            timer.start();
+
+            const bool last = i == filters.size() - 1;
+            cv::Mat out = last ? wrap(result) : cv::Mat(current.rows, current.cols, CV_16UC1);
+
+            if (filter.type == FilterType::Clahe)
+            {
+                cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE(filter.clipLimit, cv::Size(filter.tiles, filter.tiles));
+                clahe->apply(current, out);
+            }
+            else if (!runBanded(filter, current, out, bandRows))
+            {
+                return image;
+            }
+
+            if (timings)
+            {
+                timings->append({filterName(filter), timer.nsecsElapsed() / 1e6});
+            }
+            current = out;
+        }
+    }
+    catch (const cv::Exception& e)
+    {
+        qCritical() << "[图像处理] 滤波失败:" << e.what();
+        return image;
+    }
+
+    return result;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <qimage.h>
+#include <qlist.h>
+#include <qstring.h>
+
+/**
+ * @brief 16 位图像显示增强滤波链
+ *
+ * 按配置顺序依次执行：
+ * - median : 中值去噪（3x3 / 5x5）
+ * - unsharp: 反锐化掩模边缘增强，out = src + amount * (src - Gaussian(src))
+ * - clahe  : 限制对比度的自适应直方图均衡（局部对比度）
+ *
+ * 邻域滤波按行条带切分（带半径大小的重叠区）并行处理，使每个条带的数据停留在缓存中；
+ * CLAHE 需要全局分块统计，整幅交给 OpenCV 处理。每个滤波器单独计时，便于控制实时采集的帧预算。
+ *
+ * 链本身不可变，apply() 可在任意线程并发调用。
+ */
+class XImageFilterChain
+{
+public:
+    enum class FilterType
+    {
+        Median,
+        Unsharp,
+        Clahe,
+    };
+
+    struct Filter
+    {
+        FilterType type{FilterType::Median};
+        int kernelSize{3};       // median
+        double sigma{2.0};       // unsharp
+        double amount{0.8};      // unsharp
+        double clipLimit{2.0};   // clahe
+        int tiles{8};            // clahe，每个方向的分块数
+    };
+
+    struct Timing
+    {
+        QString name;
+        double ms{0.0};
+    };
+
+    // [FILTER] FILTER_CHAIN="median,unsharp,clahe" 及各滤波器参数；FILTER_ENABLE=false 时返回空链
+    static XImageFilterChain fromConfig();
+
+    void append(const Filter& filter) { filters.append(filter); }
+    bool isEmpty() const { return filters.isEmpty(); }
+    void setBandRows(int rows) { bandRows = rows > 0 ? rows : bandRows; }
+
+    // 仅支持 16 位灰度图像；失败时返回原图。timings 非空时追加各滤波器耗时
+    QImage apply(const QImage& image, QList<Timing>* timings = nullptr) const;
+
+    static QString filterName(const Filter& filter);
+    static QString formatTimings(const QList<Timing>& timings);
+
+private:
+    QList<Filter> filters;
+    int bandRows{128};
+};
@@ -9,10 +9,113 @@
 #include <qfiledialog.h>
 #include <qcollator.h>
 #include <qimagewriter.h>
+#include <qtransform.h>
+#include <qfileinfo.h>
+#include <qmutex.h>
 
 #include <opencv2/opencv.hpp>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <limits>
+
+#include "Components/XTileExecutor.h"
+#include "ImageRender/XFramePool.h"
+#include "IRayDetector/TiffHelper.h"
+
+namespace
+{
+// 按行块并行统计区域内的最小最大灰度值，各块局部结果最后合并
+template <typename T>
+void tiledMinMax(const QImage& image, const QRect& region, int& minOut, int& maxOut)
+{
+    QMutex mutex;
+    int minValue = std::numeric_limits<T>::max();
+    int maxValue = 0;
+
+    xTiles.parallelForTiles(region.height(), static_cast<qsizetype>(region.width()) * sizeof(T),
+                            [&](int rowBegin, int rowEnd)
+                            {
+                                int tileMin = std::numeric_limits<T>::max();
+                                int tileMax = 0;
+                                for (int y = region.top() + rowBegin; y < region.top() + rowEnd; ++y)
+                                {
+                                    const T* line = reinterpret_cast<const T*>(image.constScanLine(y)) + region.left();
+                                    for (int x = 0; x < region.width(); ++x)
+                                    {
+                                        const int gray = line[x];
+                                        if (gray < tileMin)
+                                            tileMin = gray;
+                                        if (gray > tileMax)
+                                            tileMax = gray;
+                                    }
+                                }
+
+                                QMutexLocker locker(&mutex);
+                                minValue = std::min(minValue, tileMin);
+                                maxValue = std::max(maxValue, tileMax);
+                            });
+
+    minOut = minValue;
+    maxOut = maxValue;
+}
+
+// dst(x, y) = src(map(x, y))，map 为 90 度整数倍旋转与翻转的组合。
+// 同一输出行内源地址等步长变化，只需算出行首地址与步长；
+// 旋转 90/270 度时按列分段写，使每段读取的源行保持在缓存中
+template <typename T>
+void remapRotateFlip(const QImage& src, QImage& dst, int rotate, bool flipH, bool flipV)
+{
+    const int srcW = src.width();
+    const int srcH = src.height();
+    const int dstW = dst.width();
+    const int dstH = dst.height();
+    const T* srcBits = reinterpret_cast<const T*>(src.constBits());
+    const qsizetype srcStride = src.bytesPerLine() / sizeof(T);
+    uchar* dstBits = dst.bits();
+    const qsizetype dstBytesPerLine = dst.bytesPerLine();
+
+    // 输出坐标（翻转前的旋转结果坐标）对应的源像素偏移
+    auto sourceOffset = [&](int rx, int ry) -> qsizetype
+    {
+        switch (rotate)
+        {
+            case 90:
+                return static_cast<qsizetype>(srcH - 1 - rx) * srcStride + ry;
+            case 180:
+                return static_cast<qsizetype>(srcH - 1 - ry) * srcStride + (srcW - 1 - rx);
+            case 270:
+                return static_cast<qsizetype>(rx) * srcStride + (srcW - 1 - ry);
+            default:
+                return static_cast<qsizetype>(ry) * srcStride + rx;
+        }
+    };
+
+    const bool transposed = rotate == 90 || rotate == 270;
+    const int columnBlock = transposed ? 64 : dstW;
+
+    xTiles.parallelForTiles(
+        dstH, static_cast<qsizetype>(dstW) * sizeof(T) * 2,
+        [&](int rowBegin, int rowEnd)
+        {
+            for (int x0 = 0; x0 < dstW; x0 += columnBlock)
+            {
+                const int x1 = std::min(x0 + columnBlock, dstW);
+                for (int y = rowBegin; y < rowEnd; ++y)
+                {
+                    const int ry = flipV ? dstH - 1 - y : y;
+                    const int rx0 = flipH ? dstW - 1 - x0 : x0;
+                    const qsizetype step = sourceOffset(flipH ? rx0 - 1 : rx0 + 1, ry) - sourceOffset(rx0, ry);
+                    const T* s = srcBits + sourceOffset(rx0, ry);
+                    T* d = reinterpret_cast<T*>(dstBits + y * dstBytesPerLine);
+                    for (int x = x0; x < x1; ++x, s += step)
+                        d[x] = *s;
+                }
+            }
+        },
+        transposed ? 32 : 0);
+}
+}  // namespace
 
 XImageHelper::XImageHelper(QObject* parent) : QObject(parent) {}
 
@@ -210,45 +313,13 @@ bool XImageHelper::calculateMaxMinValue(const QImage& image, int& max, int& min)
     if (image.format() == QImage::Format_Grayscale8)
     {
         // 8位灰度图
-        int minValue = 255;  // 8位灰度图最大值
-        int maxValue = 0;    // 8位灰度图最小值
-        for (int y = 0; y < image.height(); ++y)
-        {
-            const uchar* scanLine = image.constScanLine(y);
-            for (int x = 0; x < image.width(); ++x)
-            {
-                int gray = scanLine[x];
-                if (gray < minValue)
-                    minValue = gray;
-                if (gray > maxValue)
-                    maxValue = gray;
-            }
-        }
-
-        max = maxValue;
-        min = minValue;
+        tiledMinMax<uchar>(image, image.rect(), min, max);
         return true;
     }
     else if (image.format() == QImage::Format_Grayscale16)
     {
         // 16位灰度图
-        int minValue = 65535;  // 16位灰度图最大值
-        int maxValue = 0;      // 16位灰度图最小值
-        for (int y = 0; y < image.height(); ++y)
-        {
-            const ushort* scanLine = reinterpret_cast<const ushort*>(image.constScanLine(y));
-            for (int x = 0; x < image.width(); ++x)
-            {
-                int gray = scanLine[x];
-                if (gray < minValue)
-                    minValue = gray;
-                if (gray > maxValue)
-                    maxValue = gray;
-            }
-        }
-
-        max = maxValue;
-        min = minValue;
+        tiledMinMax<ushort>(image, image.rect(), min, max);
         return true;
     }
     else
@@ -274,33 +345,8 @@ bool XImageHelper::calculateMaxMinValue(const QImage& image, const QRect& rect,
         return false;
     }
 
-    // 初始化最大最小值
-    min = 65536;  // 最大值初始化
-    max = 0;      // 最小值初始化
-
-    // 遍历指定区域内的每一个像素
-    for (int y = validRegion.top(); y <= validRegion.bottom(); ++y)
-    {
-        for (int x = validRegion.left(); x <= validRegion.right(); ++x)
-        {
-            // 获取该行数据的常量指针，并重新解释为 ushort 指针
-            const uchar* scanLine = image.constScanLine(y);                       // 获取第y行数据的起始地址
-            const ushort* pixelData = reinterpret_cast<const ushort*>(scanLine);  // 解释为16位数据
-
-            // 读取该像素的16位灰度值
-            ushort grayValue16 = pixelData[x];  // 范围是 0 到 65535
-
-            // 更新最大最小值
-            if (grayValue16 < min)
-            {
-                min = grayValue16;
-            }
-            if (grayValue16 > max)
-            {
-                max = grayValue16;
-            }
-        }
-    }
+    // 只遍历指定区域内的像素
+    tiledMinMax<ushort>(image, validRegion, min, max);
 
     return true;
 }
@@ -457,6 +503,22 @@ QImage XImageHelper::openImageU16Raw(const QString& filePath, int w, int h)
     return image;
 }
 
+QImage XImageHelper::openImageFile(const QString& filePath, int w, int h)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "tif" || suffix == "tiff")
+    {
+        return TiffHelper::ReadImage(filePath.toStdString());
+    }
+    if (suffix == "raw")
+    {
+        return openImageU16Raw(filePath, w, h);
+    }
+
+    qWarning() << "不支持的文件格式：" << filePath;
+    return QImage();
+}
+
 bool XImageHelper::saveImageU16Raw(const QImage& image, const QString& filePath)
 {
     // 参数检查
@@ -742,9 +804,12 @@ QImage XImageHelper::adjustWL(const QImage& image, int width, int level)
     int w = image.width();
     int h = image.height();
 
-    // 创建8位输出图像用于显示
-    QImage dest(w, h, QImage::Format_Grayscale8);
-    dest.fill(0);
+    // 创建8位输出图像用于显示，所有像素都会被写入，无需清零
+    QImage dest = xFramePool.acquire(w, h, QImage::Format_Grayscale8);
+    if (dest.isNull())
+    {
+        return QImage();
+    }
 
     // 计算窗口边界
     int windowMin = level - width / 2;
@@ -758,29 +823,85 @@ QImage XImageHelper::adjustWL(const QImage& image, int width, int level)
     }
 
     // 遍历所有像素并应用线性映射
-    for (int y = 0; y < h; ++y)
-    {
-        const uint16_t* srcLine = reinterpret_cast<const uint16_t*>(image.scanLine(y));
-        uchar* dstLine = dest.scanLine(y);
-
-        for (int x = 0; x < w; ++x)
+    uchar* dstBits = dest.bits();
+    const qsizetype dstBytesPerLine = dest.bytesPerLine();
+    xTiles.parallelForTiles(
+        h, static_cast<qsizetype>(w) * (sizeof(uint16_t) + sizeof(uchar)),
+        [&](int rowBegin, int rowEnd)
         {
-            uint16_t pixelValue = srcLine[x];
+            for (int y = rowBegin; y < rowEnd; ++y)
+            {
+                const uint16_t* srcLine = reinterpret_cast<const uint16_t*>(image.constScanLine(y));
+                uchar* dstLine = dstBits + y * dstBytesPerLine;
+
+                for (int x = 0; x < w; ++x)
+                {
+                    uint16_t pixelValue = srcLine[x];
 
-            // 线性映射：将 [windowMin, windowMax] 映射到 [0, 255]
-            float normalized = 255.0f * (pixelValue - windowMin) / windowRange;
+                    // 线性映射：将 [windowMin, windowMax] 映射到 [0, 255]
+                    float normalized = 255.0f * (pixelValue - windowMin) / windowRange;
 
-            // 饱和处理：小于窗口最小值 -> 0，大于窗口最大值 -> 255
-            if (normalized < 0)
-                normalized = 0;
-            if (normalized > 255)
-                normalized = 255;
+                    // 饱和处理：小于窗口最小值 -> 0，大于窗口最大值 -> 255
+                    if (normalized < 0)
+                        normalized = 0;
+                    if (normalized > 255)
+                        normalized = 255;
 
-            dstLine[x] = static_cast<uchar>(normalized);
+                    dstLine[x] = static_cast<uchar>(normalized);
+                }
+            }
+        });
+
+    return dest;
+}
+
+QImage XImageHelper::transformImage(const QImage& image, int rotate, bool flipH, bool flipV)
+{
+    rotate = ((rotate % 360) + 360) % 360;
+    if (image.isNull() || (rotate == 0 && !flipH && !flipV))
+    {
+        return image;
+    }
+
+    const QImage::Format format = image.format();
+    const bool gray = format == QImage::Format_Grayscale16 || format == QImage::Format_Grayscale8;
+    if (!gray || rotate % 90 != 0)
+    {
+        // 任意角度仍交给 QImage 插值，保持原始格式
+        QImage rotated = image;
+        if (rotate != 0)
+        {
+            QTransform transform;
+            transform.rotate(rotate);
+            rotated = image.transformed(transform, Qt::SmoothTransformation);
+            if (rotated.format() != format)
+            {
+                rotated = rotated.convertToFormat(format);
+            }
         }
+
+        if (flipH && flipV)
+            return rotated.flipped(Qt::Horizontal | Qt::Vertical);
+        if (flipH)
+            return rotated.flipped(Qt::Horizontal);
+        if (flipV)
+            return rotated.flipped(Qt::Vertical);
+        return rotated;
     }
 
-    return dest;
+    const bool transposed = rotate == 90 || rotate == 270;
+    QImage result = xFramePool.acquire(transposed ? image.height() : image.width(),
+                                       transposed ? image.width() : image.height(), format);
+    if (result.isNull())
+    {
+        return QImage();
+    }
+
+    if (format == QImage::Format_Grayscale16)
+        remapRotateFlip<quint16>(image, result, rotate, flipH, flipV);
+    else
+        remapRotateFlip<uchar>(image, result, rotate, flipH, flipV);
+    return result;
 }
 
 void XImageHelper::testQImage()
@@ -914,36 +1035,35 @@ QImage XImageHelper::convert16BitTo8BitLinear(const QImage& image16)
 
     int w = image16.width();
     int h = image16.height();
-    QImage image8(w, h, QImage::Format_Grayscale8);
-
-    // 找到16位图像的实际最小值和最大值
-    ushort minVal = 65535, maxVal = 0;
-    for (int y = 0; y < h; ++y)
+    QImage image8 = xFramePool.acquire(w, h, QImage::Format_Grayscale8);
+    if (image8.isNull())
     {
-        const ushort* line16 = (const ushort*)image16.constScanLine(y);
-        for (int x = 0; x < w; ++x)
-        {
-            ushort val = line16[x];
-            if (val < minVal)
-                minVal = val;
-            if (val > maxVal)
-                maxVal = val;
-        }
+        return QImage();
     }
+
+    // 找到16位图像的实际最小值和最大值
+    int minVal = 65535, maxVal = 0;
+    tiledMinMax<ushort>(image16, image16.rect(), minVal, maxVal);
     double range = maxVal - minVal;
     if (range < 1.0)
         range = 1.0;  // 避免除以零
 
     // 线性映射并填充8位图像
-    for (int y = 0; y < h; ++y)
-    {
-        const ushort* line16 = (const ushort*)image16.constScanLine(y);
-        uchar* line8 = image8.scanLine(y);
-        for (int x = 0; x < w; ++x)
-        {
-            double normalized = (line16[x] - minVal) / range;  // 归一化到0~1
-            line8[x] = static_cast<uchar>(normalized * 255.0);
-        }
-    }
+    uchar* bits8 = image8.bits();
+    const qsizetype bytesPerLine8 = image8.bytesPerLine();
+    xTiles.parallelForTiles(h, static_cast<qsizetype>(w) * (sizeof(ushort) + sizeof(uchar)),
+                            [&](int rowBegin, int rowEnd)
+                            {
+                                for (int y = rowBegin; y < rowEnd; ++y)
+                                {
+                                    const ushort* line16 = (const ushort*)image16.constScanLine(y);
+                                    uchar* line8 = bits8 + y * bytesPerLine8;
+                                    for (int x = 0; x < w; ++x)
+                                    {
+                                        double normalized = (line16[x] - minVal) / range;  // 归一化到0~1
+                                        line8[x] = static_cast<uchar>(normalized * 255.0);
+                                    }
+                                }
+                            });
     return image8;
 }
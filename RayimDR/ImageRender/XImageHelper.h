@@ -34,6 +34,8 @@ public:
     static bool calculateWLAdvanced(int max, int min, int& w, int& l, int mode = 0);
     // 从文件打开16位灰度图
     static QImage openImageU16Raw(const QString& filePath, int w, int h);
+    // 按扩展名打开 RAW/TIFF 文件，RAW 需要指定宽高
+    static QImage openImageFile(const QString& filePath, int w = 0, int h = 0);
     // 将16位灰度图保存为图像文件
     static bool saveImageU16Raw(const QImage& image, const QString& filePath);
     static bool saveImagePNG(const QImage& image, const QString& filePath, int compressionLevel = 0);
@@ -44,6 +46,8 @@ public:
     static QList<QImage> openImagesInFolder(int w, int h, const QString& folderPath);
     // 对于给定的图像，返回调整窗宽窗位后的图像
     static QImage adjustWL(const QImage& image, int width, int level);
+    // 先顺时针旋转 rotate 度，再按需水平/垂直翻转；灰度图旋转 90 的整数倍时单次遍历写入帧池缓冲
+    static QImage transformImage(const QImage& image, int rotate, bool flipH, bool flipV);
 
     // 关于QImage的一些测试
     static void testQImage();
@@ -0,0 +1,450 @@
+#include "XImageStacker.h"
+
+#include <qdebug.h>
+#include <qelapsedtimer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XIS_USE_SSE2
+#endif
+
+#include "Components/XGlobal.h"
+#include "Components/XTileExecutor.h"
+#include "XFramePool.h"
+
+namespace
+{
+constexpr float MAD_TO_SIGMA = 1.4826f;
+
+using RowPtrs = std::vector<const quint16*>;
+
+// 每个行块一份的行缓冲
+struct RowScratch
+{
+    RowScratch(int width, int frames) : values(frames), center(width), limit(width), acc(width), count(width) {}
+
+    std::vector<quint16> values;
+    std::vector<float> center;
+    std::vector<float> limit;
+    std::vector<float> acc;
+    std::vector<float> count;
+};
+
+inline quint16 saturate(float v)
+{
+    return static_cast<quint16>(std::clamp(v + 0.5f, 0.0f, 65535.0f));
+}
+
+// 偶数帧取中间两个值的平均（向上取整，与 _mm_avg_epu16 一致）；vals 会被重排
+quint16 medianOf(quint16* vals, int n)
+{
+    const int mid = n / 2;
+    std::nth_element(vals, vals + mid, vals + n);
+    if (n % 2 == 1)
+        return vals[mid];
+    const quint16 lower = *std::max_element(vals, vals + mid);
+    return static_cast<quint16>((lower + vals[mid] + 1) / 2);
+}
+
+// 以中值 / MAD 为中心与尺度的裁剪平均
+float clipMedianMad(const RowPtrs& rows, int x, float kappa, quint16* scratch)
+{
+    const int n = static_cast<int>(rows.size());
+    for (int i = 0; i < n; ++i)
+        scratch[i] = rows[i][x];
+    const int med = medianOf(scratch, n);
+    for (int i = 0; i < n; ++i)
+        scratch[i] = static_cast<quint16>(std::abs(rows[i][x] - med));
+    const float limit = std::max(kappa * MAD_TO_SIGMA * medianOf(scratch, n), kappa);
+
+    float sum = 0.0f;
+    float count = 0.0f;
+    for (int i = 0; i < n; ++i)
+    {
+        const int v = rows[i][x];
+        if (static_cast<float>(std::abs(v - med)) <= limit)
+        {
+            sum += static_cast<float>(v);
+            count += 1.0f;
+        }
+    }
+    return sum / count;
+}
+
+#ifdef XIS_USE_SSE2
+// SSE2 只有有符号 16 位 min / max，数据先翻转符号位映射到有符号区间，比较后再翻回
+inline void compareExchange(__m128i& a, __m128i& b)
+{
+    const __m128i lo = _mm_min_epi16(a, b);
+    b = _mm_max_epi16(a, b);
+    a = lo;
+}
+
+// 部分冒泡网络：结束后 v[0..k] 依次为最小的 k + 1 个值，求中值只需排到中间位置
+inline void partialSort(__m128i* v, int n, int k)
+{
+    for (int i = 0; i <= k; ++i)
+    {
+        for (int j = n - 1; j > i; --j)
+            compareExchange(v[j - 1], v[j]);
+    }
+}
+
+// v 为翻转符号位后的 n 个向量（会被重排），返回无符号中值
+inline __m128i medianNetwork(__m128i* v, int n)
+{
+    const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+    const int mid = n / 2;
+    partialSort(v, n, mid);
+    const __m128i upper = _mm_xor_si128(v[mid], flip);
+    if (n % 2 == 1)
+        return upper;
+    return _mm_avg_epu16(_mm_xor_si128(v[mid - 1], flip), upper);
+}
+
+inline __m128i absDiff(__m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+}
+
+inline __m128i loadRow(const quint16* row, int x)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+}
+#endif
+
+void meanRow(const RowPtrs& rows, quint16* dst, int width, RowScratch& scratch)
+{
+    const float invCount = 1.0f / static_cast<float>(rows.size());
+    float* acc = scratch.acc.data();
+    std::fill_n(acc, width, 0.0f);
+    for (const quint16* src : rows)
+    {
+        for (int x = 0; x < width; ++x)
+            acc[x] += static_cast<float>(src[x]);
+    }
+    for (int x = 0; x < width; ++x)
+        dst[x] = static_cast<quint16>(acc[x] * invCount);
+}
+
+void medianRow(const RowPtrs& rows, quint16* dst, int width, RowScratch& scratch)
+{
+    const int n = static_cast<int>(rows.size());
+    int x = 0;
+#ifdef XIS_USE_SSE2
+    if (n <= XImageStacker::NETWORK_MAX)
+    {
+        const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+        __m128i v[XImageStacker::NETWORK_MAX];
+        for (; x + 8 <= width; x += 8)
+        {
+            for (int i = 0; i < n; ++i)
+                v[i] = _mm_xor_si128(loadRow(rows[i], x), flip);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), medianNetwork(v, n));
+        }
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        for (int i = 0; i < n; ++i)
+            scratch.values[i] = rows[i][x];
+        dst[x] = medianOf(scratch.values.data(), n);
+    }
+}
+
+// 帧数少：中值 / MAD 在寄存器中求出后，再遍历一次各帧累加阈值内的像素
+void sigmaClipNetworkRow(const RowPtrs& rows, quint16* dst, int width, float kappa, RowScratch& scratch)
+{
+    const int n = static_cast<int>(rows.size());
+    int x = 0;
+#ifdef XIS_USE_SSE2
+    const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128 vScale = _mm_set1_ps(kappa * MAD_TO_SIGMA);
+    const __m128 vFloor = _mm_set1_ps(kappa);
+    const __m128 vOne = _mm_set1_ps(1.0f);
+    const __m128 vHalf = _mm_set1_ps(0.5f);
+    __m128i v[XImageStacker::NETWORK_MAX];
+    for (; x + 8 <= width; x += 8)
+    {
+        for (int i = 0; i < n; ++i)
+            v[i] = _mm_xor_si128(loadRow(rows[i], x), flip);
+        const __m128i med = medianNetwork(v, n);
+
+        for (int i = 0; i < n; ++i)
+            v[i] = _mm_xor_si128(absDiff(loadRow(rows[i], x), med), flip);
+        const __m128i mad = medianNetwork(v, n);
+
+        // 阈值与累加在 float 中进行，低 / 高 4 个像素分开
+        const __m128 limitLo = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(mad, zero)), vScale), vFloor);
+        const __m128 limitHi = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(mad, zero)), vScale), vFloor);
+        __m128 sumLo = _mm_setzero_ps();
+        __m128 sumHi = _mm_setzero_ps();
+        __m128 cntLo = _mm_setzero_ps();
+        __m128 cntHi = _mm_setzero_ps();
+        for (int i = 0; i < n; ++i)
+        {
+            const __m128i s = loadRow(rows[i], x);
+            const __m128i d = absDiff(s, med);
+            const __m128 keepLo = _mm_cmple_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(d, zero)), limitLo);
+            const __m128 keepHi = _mm_cmple_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(d, zero)), limitHi);
+            sumLo = _mm_add_ps(sumLo, _mm_and_ps(keepLo, _mm_cvtepi32_ps(_mm_unpacklo_epi16(s, zero))));
+            sumHi = _mm_add_ps(sumHi, _mm_and_ps(keepHi, _mm_cvtepi32_ps(_mm_unpackhi_epi16(s, zero))));
+            cntLo = _mm_add_ps(cntLo, _mm_and_ps(keepLo, vOne));
+            cntHi = _mm_add_ps(cntHi, _mm_and_ps(keepHi, vOne));
+        }
+
+        // 至少一半的帧落在 MAD 以内，计数不为零；SSE2 没有无符号饱和打包，先平移到有符号区间
+        const __m128i outLo = _mm_cvttps_epi32(_mm_add_ps(_mm_div_ps(sumLo, cntLo), vHalf));
+        const __m128i outHi = _mm_cvttps_epi32(_mm_add_ps(_mm_div_ps(sumHi, cntHi), vHalf));
+        const __m128i packed =
+            _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(outLo, bias), _mm_sub_epi32(outHi, bias)), flip);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), packed);
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        dst[x] = saturate(clipMedianMad(rows, x, kappa, scratch.values.data()));
+    }
+}
+
+// 帧数多：两遍流式。第一遍以首帧为偏移累加一阶 / 二阶矩（避免 E[x²] - E[x]² 的抵消误差），
+// 第二遍只累加 mean ± kappa·σ 内的像素
+void sigmaClipStreamRow(const RowPtrs& rows, quint16* dst, int width, float kappa, RowScratch& scratch)
+{
+    const int n = static_cast<int>(rows.size());
+    float* center = scratch.center.data();
+    float* limit = scratch.limit.data();
+    float* acc = scratch.acc.data();
+    float* count = scratch.count.data();
+    std::fill_n(center, width, 0.0f);
+    std::fill_n(limit, width, 0.0f);
+
+    const quint16* base = rows[0];
+    for (int i = 1; i < n; ++i)
+    {
+        const quint16* src = rows[i];
+        for (int x = 0; x < width; ++x)
+        {
+            const float d = static_cast<float>(src[x]) - static_cast<float>(base[x]);
+            center[x] += d;
+            limit[x] += d * d;
+        }
+    }
+
+    const float invN = 1.0f / static_cast<float>(n);
+    const float unbiased = static_cast<float>(n) / static_cast<float>(n - 1);
+    for (int x = 0; x < width; ++x)
+    {
+        const float mean = center[x] * invN;
+        const float variance = std::max(limit[x] * invN - mean * mean, 0.0f) * unbiased;
+        center[x] = mean + static_cast<float>(base[x]);
+        limit[x] = kappa * std::max(std::sqrt(variance), 1.0f);
+    }
+
+    std::fill_n(acc, width, 0.0f);
+    std::fill_n(count, width, 0.0f);
+    for (const quint16* src : rows)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const float v = static_cast<float>(src[x]);
+            const float keep = std::abs(v - center[x]) <= limit[x] ? 1.0f : 0.0f;
+            acc[x] += keep * v;
+            count[x] += keep;
+        }
+    }
+    for (int x = 0; x < width; ++x)
+        dst[x] = saturate(count[x] > 0.0f ? acc[x] / count[x] : center[x]);
+}
+}  // namespace
+
+XImageStacker::Options XImageStacker::Options::fromConfig()
+{
+    Options options;
+    const QString method = xGlobal.getString("SYSTEM", "STACK_METHOD", "mean").trimmed().toLower();
+    if (method == "median")
+    {
+        options.method = Method::Median;
+    }
+    else if (method == "sigma")
+    {
+        options.method = Method::SigmaClip;
+    }
+    else if (method != "mean")
+    {
+        qWarning() << "[叠加] 未知的 STACK_METHOD:" << method << ", 使用平均";
+    }
+    options.kappa = std::clamp(xGlobal.getDouble("SYSTEM", "STACK_SIGMA_KAPPA", options.kappa), 1.0, 10.0);
+    return options;
+}
+
+QString XImageStacker::methodName(Method method)
+{
+    switch (method)
+    {
+        case Method::Median:
+            return "中值";
+        case Method::SigmaClip:
+            return "裁剪平均";
+        default:
+            return "平均";
+    }
+}
+
+QImage XImageStacker::stack(const QVector<const QImage*>& frames, const Options& options)
+{
+    if (frames.isEmpty())
+    {
+        return QImage();
+    }
+
+    const int width = frames.first()->width();
+    const int height = frames.first()->height();
+    const int n = frames.size();
+    QImage result = XFramePool::Instance().acquire(width, height, frames.first()->format());
+    if (result.isNull())
+    {
+        qCritical() << "[叠加] 结果图像分配失败";
+        return QImage();
+    }
+
+    // 两帧时中值与裁剪平均都退化为平均
+    const Method method = n <= 2 ? Method::Mean : options.method;
+    const float kappa = static_cast<float>(options.kappa);
+    uchar* dstBits = result.bits();
+    const qsizetype dstBytesPerLine = result.bytesPerLine();
+    const int tileRows = xTiles.tileRowsFor(height, static_cast<qsizetype>(width) * n * 2);
+
+    xTiles.parallelForTiles(
+        height, 0,
+        [&](int rowBegin, int rowEnd)
+        {
+            RowPtrs rows(n);
+            RowScratch scratch(width, n);
+            for (int y = rowBegin; y < rowEnd; ++y)
+            {
+                for (int i = 0; i < n; ++i)
+                    rows[i] = reinterpret_cast<const quint16*>(frames[i]->constScanLine(y));
+                quint16* dst = reinterpret_cast<quint16*>(dstBits + y * dstBytesPerLine);
+
+                switch (method)
+                {
+                    case Method::Median:
+                        medianRow(rows, dst, width, scratch);
+                        break;
+                    case Method::SigmaClip:
+                        if (n <= NETWORK_MAX)
+                            sigmaClipNetworkRow(rows, dst, width, kappa, scratch);
+                        else
+                            sigmaClipStreamRow(rows, dst, width, kappa, scratch);
+                        break;
+                    default:
+                        meanRow(rows, dst, width, scratch);
+                        break;
+                }
+            }
+        },
+        tileRows);
+
+    return result;
+}
+
+QVector<XImageStacker::BenchmarkRow> XImageStacker::benchmark(int width, int height, int maxFrames)
+{
+    maxFrames = std::clamp(maxFrames, 2, 1000);
+    qInfo() << "[叠加] 性能测试开始 - 尺寸:" << width << "x" << height << ", 最大帧数:" << maxFrames;
+
+    // 合成帧：平坦背景 + 高斯噪声，每帧约 0.1% 像素为尖峰。噪声表按随机偏移复用，避免逐像素生成随机数
+    std::mt19937 rng(20240601);
+    const qsizetype pixels = static_cast<qsizetype>(width) * height;
+    std::vector<quint16> noise(pixels + 65536);
+    std::normal_distribution<float> gauss(20000.0f, 150.0f);
+    for (quint16& v : noise)
+        v = saturate(gauss(rng));
+
+    QVector<QImage> images;
+    images.reserve(maxFrames);
+    std::uniform_int_distribution<qsizetype> offsetDist(0, 65535);
+    std::uniform_int_distribution<qsizetype> pixelDist(0, pixels - 1);
+    for (int i = 0; i < maxFrames; ++i)
+    {
+        QImage image(width, height, QImage::Format_Grayscale16);
+        const quint16* src = noise.data() + offsetDist(rng);
+        for (int y = 0; y < height; ++y)
+            std::copy_n(src + static_cast<qsizetype>(y) * width, width, reinterpret_cast<quint16*>(image.scanLine(y)));
+        for (qsizetype s = 0; s < pixels / 1000; ++s)
+        {
+            const qsizetype p = pixelDist(rng);
+            reinterpret_cast<quint16*>(image.scanLine(static_cast<int>(p / width)))[p % width] = 60000;
+        }
+        images.append(image);
+    }
+
+    QVector<int> counts;
+    for (int n : {2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 16, 24, 32, 48, 64, 100})
+    {
+        if (n <= maxFrames)
+            counts.append(n);
+    }
+    if (counts.last() != maxFrames)
+        counts.append(maxFrames);
+
+    auto timeMs = [](const QVector<const QImage*>& frames, Method method)
+    {
+        Options options;
+        options.method = method;
+        double best = 0.0;
+        for (int run = 0; run < 3; ++run)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            const QImage result = stack(frames, options);
+            const double ms = timer.nsecsElapsed() / 1e6;
+            best = run == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    };
+
+    QVector<BenchmarkRow> rows;
+    QVector<const QImage*> frames;
+    for (int n : counts)
+    {
+        frames.clear();
+        for (int i = 0; i < n; ++i)
+            frames.append(&images[i]);
+
+        BenchmarkRow row;
+        row.frames = n;
+        row.meanMs = timeMs(frames, Method::Mean);
+        row.medianMs = timeMs(frames, Method::Median);
+        row.sigmaClipMs = timeMs(frames, Method::SigmaClip);
+        rows.append(row);
+    }
+
+    qInfo().noquote() << formatBenchmark(rows, width, height);
+    return rows;
+}
+
+QString XImageStacker::formatBenchmark(const QVector<BenchmarkRow>& rows, int width, int height)
+{
+    QString text = QString("[叠加] 性能测试 %1x%2, 线程 %3:").arg(width).arg(height).arg(xTiles.workerCount() + 1);
+    for (const BenchmarkRow& row : rows)
+    {
+        const double base = std::max(row.meanMs, 1e-3);
+        text += QString("\n  N=%1: 平均 %2 ms, 中值 %3 ms (%4x), 裁剪平均 %5 ms (%6x)")
+                    .arg(row.frames, 3)
+                    .arg(row.meanMs, 0, 'f', 2)
+                    .arg(row.medianMs, 0, 'f', 2)
+                    .arg(row.medianMs / base, 0, 'f', 1)
+                    .arg(row.sigmaClipMs, 0, 'f', 2)
+                    .arg(row.sigmaClipMs / base, 0, 'f', 1);
+    }
+    return text;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <qimage.h>
+#include <qstring.h>
+#include <qvector.h>
+
+/**
+ * @brief 多帧叠加：算术平均、中值与 kappa-sigma 裁剪平均
+ *
+ * 单个子帧上的宇宙射线 / 散射尖峰或读出毛刺会直接进入算术平均结果，中值与裁剪平均可以剔除这类离群值。
+ * 三种方法都按行块并行（XTileExecutor），每个行块逐行处理，行缓冲始终留在缓存中：
+ * - 中值：帧数不超过 NETWORK_MAX 时，8 个像素一组装入 SSE2 寄存器，用部分冒泡比较网络
+ *   （min / max）只排到中间位置；帧数更多时逐像素 nth_element。
+ * - 裁剪平均：帧数少时样本标准差会被离群值本身拉大，改用中值与 MAD（1.4826 × 绝对偏差中值）
+ *   作为中心与尺度，同样在寄存器中求；帧数多时按两遍流式计算，第一遍求均值与标准差，
+ *   第二遍只累加落在 mean ± kappa·σ 内的像素。
+ * 输入须为尺寸一致的 16 位灰度图像，结果从帧池分配。
+ */
+class XImageStacker
+{
+public:
+    enum class Method
+    {
+        Mean = 0,
+        Median,
+        SigmaClip
+    };
+
+    struct Options
+    {
+        Method method{Method::Mean};
+        double kappa{3.0};  // 裁剪阈值，单位为 σ
+
+        // [SYSTEM] STACK_METHOD (mean / median / sigma) / STACK_SIGMA_KAPPA
+        static Options fromConfig();
+    };
+
+    // 不超过该帧数时用寄存器比较网络
+    static constexpr int NETWORK_MAX = 16;
+
+    static QImage stack(const QVector<const QImage*>& frames, const Options& options);
+    static QString methodName(Method method);
+
+    struct BenchmarkRow
+    {
+        int frames{0};
+        double meanMs{0.0};
+        double medianMs{0.0};
+        double sigmaClipMs{0.0};
+    };
+
+    // 合成带尖峰的噪声帧，对 N = 2..maxFrames 比较三种方法的耗时（取 3 次最短）
+    static QVector<BenchmarkRow> benchmark(int width = 1024, int height = 1024, int maxFrames = 100);
+    static QString formatBenchmark(const QVector<BenchmarkRow>& rows, int width, int height);
+};
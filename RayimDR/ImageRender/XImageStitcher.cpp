@@ -0,0 +1,458 @@
+#include "XImageStitcher.h"
+
+#include <qdebug.h>
+#include <qdir.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qrect.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <opencv2/imgproc.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XST_USE_SSE2
+#endif
+
+#include "Components/XGlobal.h"
+#include "Components/XTileExecutor.h"
+#include "ImageRender/XImageBinning.h"
+#include "ImageRender/XImageHelper.h"
+
+namespace
+{
+// 相位相关的最小边长（合并后）
+constexpr int MIN_CORRELATION_SIZE = 16;
+// 精配准重叠区的最大边长，超出时取中心部分
+constexpr int MAX_REFINE_SIZE = 2048;
+
+struct PairEstimate
+{
+    QPoint offset;  // b 的原点在 a 坐标系中的位置
+    double response{0.0};
+    double gain{1.0};  // b 乘以 gain 后与 a 亮度一致
+    bool aligned{false};
+};
+
+// rect 区域按 factor 合并后转为去均值浮点
+bool toFloat(const QImage& image, const QRect& rect, int factor, std::vector<float>& pixels, int& width, int& height)
+{
+    XImageBinning::Options binning;
+    binning.factor = factor;
+    binning.roi = rect;
+    const QImage binned = XImageBinning::bin(image, binning);
+    if (binned.isNull() || binned.width() < MIN_CORRELATION_SIZE || binned.height() < MIN_CORRELATION_SIZE)
+    {
+        return false;
+    }
+
+    width = binned.width();
+    height = binned.height();
+    pixels.resize(static_cast<size_t>(width) * height);
+    double sum = 0.0;
+    for (int y = 0; y < height; ++y)
+    {
+        const quint16* src = reinterpret_cast<const quint16*>(binned.constScanLine(y));
+        float* dst = pixels.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x)
+        {
+            dst[x] = src[x];
+            sum += src[x];
+        }
+    }
+    const float mean = static_cast<float>(sum / pixels.size());
+    for (float& value : pixels)
+        value -= mean;
+    return true;
+}
+
+// 在 a 的 rectA 与 b 的同尺寸 rectB 上做相位相关（Hann 窗），shift 为 b 中内容相对 a 的位移，全分辨率像素
+bool correlate(const QImage& a, const QRect& rectA, const QImage& b, const QRect& rectB, int factor, QPointF& shift,
+               double& response)
+{
+    std::vector<float> pixelsA;
+    std::vector<float> pixelsB;
+    int widthA = 0;
+    int heightA = 0;
+    int widthB = 0;
+    int heightB = 0;
+    if (!toFloat(a, rectA, factor, pixelsA, widthA, heightA) || !toFloat(b, rectB, factor, pixelsB, widthB, heightB) ||
+        widthA != widthB || heightA != heightB)
+    {
+        return false;
+    }
+
+    cv::Mat window;
+    cv::createHanningWindow(window, cv::Size(widthA, heightA), CV_32F);
+    const cv::Point2d peak = cv::phaseCorrelate(cv::Mat(heightA, widthA, CV_32F, pixelsA.data()),
+                                                cv::Mat(heightB, widthB, CV_32F, pixelsB.data()), window, &response);
+    shift = QPointF(peak.x * factor, peak.y * factor);
+    return true;
+}
+
+// 抽点均值，用于重叠区增益估计
+double sampledMean(const QImage& image, const QRect& rect)
+{
+    constexpr int STEP = 4;
+    double sum = 0.0;
+    qint64 count = 0;
+    for (int y = rect.top(); y <= rect.bottom(); y += STEP)
+    {
+        const quint16* row = reinterpret_cast<const quint16*>(image.constScanLine(y));
+        for (int x = rect.left(); x <= rect.right(); x += STEP, ++count)
+            sum += row[x];
+    }
+    return count > 0 ? sum / count : 0.0;
+}
+
+// 中心裁剪到不超过 MAX_REFINE_SIZE
+QRect limitRefineRect(const QRect& rect)
+{
+    const int width = std::min(rect.width(), MAX_REFINE_SIZE);
+    const int height = std::min(rect.height(), MAX_REFINE_SIZE);
+    return QRect(rect.x() + (rect.width() - width) / 2, rect.y() + (rect.height() - height) / 2, width, height);
+}
+
+// b 位于 a 右侧（horizontal）或下方：先在名义重叠条带上粗配准，再在全分辨率的实际重叠区上求残差
+PairEstimate alignPair(const QImage& a, const QImage& b, bool horizontal, const XImageStitcher::Options& options)
+{
+    PairEstimate estimate;
+    const int extent = horizontal ? std::min(a.width(), b.width()) : std::min(a.height(), b.height());
+    const int band = std::clamp(static_cast<int>(std::lround(extent * options.overlap)), 1, extent);
+    const QPoint nominal = horizontal ? QPoint(a.width() - band, 0) : QPoint(0, a.height() - band);
+    estimate.offset = nominal;
+
+    // 条带内容位移 s 与 b 原点的关系：offset = 条带在 a 中的原点 - 条带在 b 中的原点 - s
+    const QSize stripSize = horizontal ? QSize(band, std::min(a.height(), b.height()))
+                                       : QSize(std::min(a.width(), b.width()), band);
+    QPointF coarse;
+    if (!correlate(a, QRect(nominal, stripSize), b, QRect(QPoint(0, 0), stripSize), options.pyramidFactor, coarse,
+                   estimate.response) ||
+        estimate.response < options.minResponse)
+    {
+        return estimate;
+    }
+    QPoint offset =
+        nominal - QPoint(static_cast<int>(std::lround(coarse.x())), static_cast<int>(std::lround(coarse.y())));
+
+    const QRect overlap = limitRefineRect(a.rect().intersected(b.rect().translated(offset)));
+    QPointF residual;
+    double response = 0.0;
+    if (correlate(a, overlap, b, overlap.translated(-offset), 1, residual, response) &&
+        response >= options.minResponse)
+    {
+        offset -= QPoint(static_cast<int>(std::lround(residual.x())), static_cast<int>(std::lround(residual.y())));
+        estimate.response = response;
+    }
+    estimate.offset = offset;
+    estimate.aligned = true;
+
+    const QRect finalOverlap = a.rect().intersected(b.rect().translated(offset));
+    if (!finalOverlap.isEmpty())
+    {
+        const double meanA = sampledMean(a, finalOverlap);
+        const double meanB = sampledMean(b, finalOverlap.translated(-offset));
+        if (meanA > 0.0 && meanB > 0.0)
+        {
+            estimate.gain = std::clamp(meanA / meanB, 0.5, 2.0);
+        }
+    }
+    return estimate;
+}
+
+// acc[x] += w * gain * src[x]，weight[x] += w，其中 w = min(wx[x], wy)
+void accumulateRow(const quint16* src, const float* wx, float wy, float gain, float* acc, float* weight, int width)
+{
+    int x = 0;
+#ifdef XST_USE_SSE2
+    const __m128i vZero = _mm_setzero_si128();
+    const __m128 vWy = _mm_set1_ps(wy);
+    const __m128 vGain = _mm_set1_ps(gain);
+    for (; x + 8 <= width; x += 8)
+    {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(raw, vZero)), vGain);
+        const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(raw, vZero)), vGain);
+        const __m128 wLo = _mm_min_ps(_mm_loadu_ps(wx + x), vWy);
+        const __m128 wHi = _mm_min_ps(_mm_loadu_ps(wx + x + 4), vWy);
+        _mm_storeu_ps(acc + x, _mm_add_ps(_mm_loadu_ps(acc + x), _mm_mul_ps(lo, wLo)));
+        _mm_storeu_ps(acc + x + 4, _mm_add_ps(_mm_loadu_ps(acc + x + 4), _mm_mul_ps(hi, wHi)));
+        _mm_storeu_ps(weight + x, _mm_add_ps(_mm_loadu_ps(weight + x), wLo));
+        _mm_storeu_ps(weight + x + 4, _mm_add_ps(_mm_loadu_ps(weight + x + 4), wHi));
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        const float w = std::min(wx[x], wy);
+        acc[x] += w * gain * src[x];
+        weight[x] += w;
+    }
+}
+
+// dst[x] = acc[x] / weight[x]，四舍五入并限制在 16 位范围，无拍摄覆盖处为 0
+void resolveRow(const float* acc, const float* weight, quint16* dst, int width)
+{
+    int x = 0;
+#ifdef XST_USE_SSE2
+    const __m128 vZero = _mm_setzero_ps();
+    const __m128 vHalf = _mm_set1_ps(0.5f);
+    const __m128 vMax = _mm_set1_ps(65535.0f);
+    const __m128 vTiny = _mm_set1_ps(1e-6f);
+    const __m128i vBias = _mm_set1_epi32(32768);
+    const __m128i vFlip = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (; x + 8 <= width; x += 8)
+    {
+        const __m128 wLo = _mm_loadu_ps(weight + x);
+        const __m128 wHi = _mm_loadu_ps(weight + x + 4);
+        __m128 lo = _mm_div_ps(_mm_loadu_ps(acc + x), _mm_max_ps(wLo, vTiny));
+        __m128 hi = _mm_div_ps(_mm_loadu_ps(acc + x + 4), _mm_max_ps(wHi, vTiny));
+        lo = _mm_and_ps(_mm_min_ps(_mm_max_ps(_mm_add_ps(lo, vHalf), vZero), vMax), _mm_cmpgt_ps(wLo, vZero));
+        hi = _mm_and_ps(_mm_min_ps(_mm_max_ps(_mm_add_ps(hi, vHalf), vZero), vMax), _mm_cmpgt_ps(wHi, vZero));
+        const __m128i iLo = _mm_sub_epi32(_mm_cvttps_epi32(lo), vBias);
+        const __m128i iHi = _mm_sub_epi32(_mm_cvttps_epi32(hi), vBias);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_xor_si128(_mm_packs_epi32(iLo, iHi), vFlip));
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        const float value = weight[x] > 0.0f ? acc[x] / weight[x] + 0.5f : 0.0f;
+        dst[x] = static_cast<quint16>(std::clamp(value, 0.0f, 65535.0f));
+    }
+}
+}  // namespace
+
+XImageStitcher::Options XImageStitcher::Options::fromConfig()
+{
+    Options o;
+    o.columns = std::max(0, xGlobal.getInt("STITCH", "STITCH_COLUMNS", o.columns));
+    o.overlap = std::clamp(xGlobal.getDouble("STITCH", "STITCH_OVERLAP", o.overlap), 0.02, 0.9);
+    o.pyramidFactor = std::clamp(xGlobal.getInt("STITCH", "STITCH_PYRAMID", o.pyramidFactor), 1, 16);
+    o.minResponse = xGlobal.getDouble("STITCH", "STITCH_MIN_RESPONSE", o.minResponse);
+    o.featherPx = std::max(1, xGlobal.getInt("STITCH", "STITCH_FEATHER", o.featherPx));
+    o.gainCompensation = xGlobal.getBool("STITCH", "STITCH_GAIN", o.gainCompensation);
+    o.memoryMB = std::max(16, xGlobal.getInt("STITCH", "STITCH_MEMORY_MB", o.memoryMB));
+    o.rawWidth = xGlobal.getInt("DET", "DET_WIDTH_1X1");
+    o.rawHeight = xGlobal.getInt("DET", "DET_HEIGHT_1X1");
+    return o;
+}
+
+QString XImageStitcher::Result::summary() const
+{
+    if (!ok)
+    {
+        return QString("拼接失败: %1").arg(error);
+    }
+    return QString("拼接图 %1x%2, 拍摄 %3 张 (%4 张使用名义位置), 条带 %5, 配准 %6 s, 合成 %7 s, 总耗时 %8 s")
+        .arg(width)
+        .arg(height)
+        .arg(shots)
+        .arg(unaligned)
+        .arg(bands)
+        .arg(alignSec, 0, 'f', 2)
+        .arg(composeSec, 0, 'f', 2)
+        .arg(totalSec, 0, 'f', 2);
+}
+
+XImageStitcher::Result XImageStitcher::stitch(const QStringList& files, const QString& outputDir,
+                                              const Options& options, const ProgressFn& progress)
+{
+    Result result;
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    QFile mosaic;
+    auto fail = [&](const QString& msg)
+    {
+        result.ok = false;
+        result.error = msg;
+        mosaic.close();
+        if (!result.mosaicPath.isEmpty())
+            QFile::remove(result.mosaicPath);
+        qCritical() << "[拼接]" << msg;
+        return result;
+    };
+    auto report = [&](int percent, const QString& stage) { return !progress || progress(percent, stage); };
+    auto load = [&](int i)
+    {
+        const QImage image = XImageHelper::openImageFile(files[i], options.rawWidth, options.rawHeight);
+        return image.format() == QImage::Format_Grayscale16 ? image : QImage();
+    };
+
+    const int count = files.size();
+    result.shots = count;
+    if (count < 2)
+        return fail(QString("至少需要 2 张图像, 当前 %1 张").arg(count));
+    const int columns = options.columns > 0 ? std::min(options.columns, count) : count;
+
+    qInfo() << "[拼接] 开始 - 拍摄:" << count << "张, 每行:" << columns << ", 名义重叠:" << options.overlap
+            << ", 金字塔:" << options.pyramidFactor << ", 羽化:" << options.featherPx << "px";
+
+    // 1. 配准：每张与左侧相邻拍摄（行首与上方拍摄）配准，位置沿生成树累积
+    QVector<QSize> sizes(count);
+    result.positions.resize(count);
+    result.gains.fill(1.0, count);
+    QImage previous;
+    for (int i = 0; i < count; ++i)
+    {
+        const QImage current = load(i);
+        if (current.isNull())
+            return fail(QString("无法读取 16 位图像 %1").arg(files[i]));
+        sizes[i] = current.size();
+
+        if (i > 0)
+        {
+            const bool horizontal = i % columns != 0;
+            const int neighbour = horizontal ? i - 1 : i - columns;
+            const QImage reference = horizontal ? previous : load(neighbour);
+            if (reference.isNull())
+                return fail(QString("无法读取 16 位图像 %1").arg(files[neighbour]));
+
+            const PairEstimate estimate = alignPair(reference, current, horizontal, options);
+            result.positions[i] = result.positions[neighbour] + estimate.offset;
+            result.gains[i] = options.gainCompensation ? result.gains[neighbour] * estimate.gain : 1.0;
+            if (!estimate.aligned)
+            {
+                ++result.unaligned;
+                qWarning() << "[拼接] 第" << (i + 1) << "张配准响应过低:" << estimate.response << ", 使用名义位置";
+            }
+            qDebug() << "[拼接] 第" << (i + 1) << "张: 位置" << result.positions[i] << ", 响应" << estimate.response
+                     << ", 增益" << result.gains[i];
+        }
+        previous = current;
+
+        if (!report(40 * (i + 1) / count, QString("配准 %1/%2").arg(i + 1).arg(count)))
+            return fail("拼接已取消");
+    }
+    previous = QImage();
+    result.alignSec = totalTimer.nsecsElapsed() / 1e9;
+
+    QRect bounds;
+    for (int i = 0; i < count; ++i)
+        bounds |= QRect(result.positions[i], sizes[i]);
+    for (QPoint& position : result.positions)
+        position -= bounds.topLeft();
+    result.width = bounds.width();
+    result.height = bounds.height();
+
+    QDir outDir(outputDir);
+    if (!outDir.exists() && !outDir.mkpath("."))
+        return fail(QString("无法创建输出目录 %1").arg(outputDir));
+    result.mosaicPath = outDir.filePath(QString("Mosaic_%1x%2.raw").arg(result.width).arg(result.height));
+    mosaic.setFileName(result.mosaicPath);
+    if (!mosaic.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return fail(QString("无法创建拼接文件 %1: %2").arg(result.mosaicPath).arg(mosaic.errorString()));
+
+    // 2. 合成：每行累加值、权重与输出各一份，条带高度由内存预算决定
+    const int width = result.width;
+    const qint64 bytesPerRow = static_cast<qint64>(width) * (2 * sizeof(float) + sizeof(quint16));
+    const qint64 budget = static_cast<qint64>(options.memoryMB) * 1024 * 1024;
+    const int bandRows = static_cast<int>(std::min<qint64>(result.height, std::max<qint64>(16, budget / bytesPerRow)));
+    std::vector<float> acc(static_cast<size_t>(bandRows) * width);
+    std::vector<float> weight(acc.size());
+    std::vector<quint16> band(acc.size());
+    result.bands = (result.height + bandRows - 1) / bandRows;
+
+    const int previewStep = std::max(1, (std::max(result.width, result.height) + PREVIEW_MAX - 1) / PREVIEW_MAX);
+    result.preview = QImage((result.width + previewStep - 1) / previewStep,
+                            (result.height + previewStep - 1) / previewStep, QImage::Format_Grayscale16);
+    result.preview.fill(0);
+
+    qDebug() << "[拼接] 合成 - 拼接图:" << result.width << "x" << result.height << ", 条带:" << bandRows << "行 x"
+             << result.bands;
+
+    // 拍摄在条带首次触及时读入，条带越过其底边后释放
+    const float feather = static_cast<float>(options.featherPx);
+    QVector<QImage> resident(count);
+    std::vector<std::vector<float>> columnWeights(count);
+    QElapsedTimer composeTimer;
+    composeTimer.start();
+    for (int y0 = 0, bandIdx = 0; y0 < result.height; y0 += bandRows, ++bandIdx)
+    {
+        const int y1 = std::min(y0 + bandRows, result.height);
+        const size_t bandPixels = static_cast<size_t>(y1 - y0) * width;
+        std::fill(acc.begin(), acc.begin() + bandPixels, 0.0f);
+        std::fill(weight.begin(), weight.begin() + bandPixels, 0.0f);
+
+        for (int i = 0; i < count; ++i)
+        {
+            const QRect shot(result.positions[i], sizes[i]);
+            if (shot.bottom() < y0)
+            {
+                resident[i] = QImage();
+                columnWeights[i].clear();
+                columnWeights[i].shrink_to_fit();
+                continue;
+            }
+            if (shot.top() >= y1)
+                continue;
+
+            if (resident[i].isNull())
+            {
+                resident[i] = load(i);
+                if (resident[i].size() != sizes[i])
+                    return fail(QString("无法重新读取图像 %1").arg(files[i]));
+                std::vector<float>& wx = columnWeights[i];
+                wx.resize(shot.width());
+                for (int x = 0; x < shot.width(); ++x)
+                    wx[x] = std::min(feather, static_cast<float>(std::min(x + 1, shot.width() - x)));
+            }
+
+            const QImage& image = resident[i];
+            const float* wx = columnWeights[i].data();
+            const float gain = static_cast<float>(result.gains[i]);
+            const int rowBegin = std::max(y0, shot.top());
+            const int rowEnd = std::min(y1, shot.bottom() + 1);
+            xTiles.parallelForTiles(rowEnd - rowBegin, static_cast<qsizetype>(shot.width()) * sizeof(quint16),
+                                    [&](int r0, int r1)
+                                    {
+                                        for (int r = r0; r < r1; ++r)
+                                        {
+                                            const int y = rowBegin + r;
+                                            const int sy = y - shot.top();
+                                            const float wy = std::min(
+                                                feather, static_cast<float>(std::min(sy + 1, shot.height() - sy)));
+                                            const size_t offset = static_cast<size_t>(y - y0) * width + shot.left();
+                                            accumulateRow(reinterpret_cast<const quint16*>(image.constScanLine(sy)),
+                                                          wx, wy, gain, acc.data() + offset, weight.data() + offset,
+                                                          shot.width());
+                                        }
+                                    });
+        }
+
+        xTiles.parallelForTiles(y1 - y0, static_cast<qsizetype>(width) * 2 * sizeof(float),
+                                [&](int r0, int r1)
+                                {
+                                    for (int r = r0; r < r1; ++r)
+                                    {
+                                        const size_t offset = static_cast<size_t>(r) * width;
+                                        resolveRow(acc.data() + offset, weight.data() + offset, band.data() + offset,
+                                                   width);
+                                    }
+                                });
+
+        for (int y = y0 + (previewStep - y0 % previewStep) % previewStep; y < y1; y += previewStep)
+        {
+            const quint16* src = band.data() + static_cast<size_t>(y - y0) * width;
+            quint16* dst = reinterpret_cast<quint16*>(result.preview.scanLine(y / previewStep));
+            for (int x = 0; x < width; x += previewStep)
+                dst[x / previewStep] = src[x];
+        }
+
+        const qint64 bandBytes = static_cast<qint64>(bandPixels) * sizeof(quint16);
+        if (mosaic.write(reinterpret_cast<const char*>(band.data()), bandBytes) != bandBytes)
+            return fail(QString("写入拼接文件失败: %1").arg(mosaic.errorString()));
+
+        if (!report(40 + 60 * y1 / result.height, QString("合成条带 %1/%2").arg(bandIdx + 1).arg(result.bands)))
+            return fail("拼接已取消");
+    }
+    mosaic.close();
+
+    result.composeSec = composeTimer.nsecsElapsed() / 1e9;
+    result.totalSec = totalTimer.nsecsElapsed() / 1e9;
+    result.ok = true;
+    qInfo() << "[拼接]" << result.summary() << ", 输出:" << result.mosaicPath;
+    return result;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <functional>
+
+#include <qimage.h>
+#include <qpoint.h>
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvector.h>
+
+/**
+ * @brief 多次 DR 拍摄的拼接，用于超出单块平板视野的大工件
+ *
+ * 拍摄按行优先顺序给出（columns 张一行），相邻拍摄须有重叠。处理分两步：
+ * 1. 配准：每张与左侧（行首为上方）相邻拍摄在名义重叠条带上做两级金字塔相位相关：
+ *    先在 pyramidFactor 倍合并的条带上求粗位移，再在全分辨率的实际重叠区上求残差。
+ *    响应过低时退回名义位置。可选按重叠区均值比逐张传递增益，消除曝光差异造成的接缝。
+ * 2. 合成：拼接图沿行切成条带，条带高度由内存预算决定。每张拍摄在条带首次触及时读入，
+ *    条带越过其底边后释放；条带内按到拍摄边缘的距离羽化加权（SSE2，行块并行），
+ *    完成的条带直接追加到输出 RAW 文件，因此拼接图可以远大于内存。
+ *
+ * 拍摄只做整数平移，不做旋转与几何畸变校正；位置按生成树逐张累积，未做全局平差。
+ */
+class XImageStitcher
+{
+public:
+    struct Options
+    {
+        int columns{0};            // 每行拍摄数，0 表示全部在一行
+        double overlap{0.2};       // 相邻拍摄的名义重叠比例
+        int pyramidFactor{4};      // 粗配准的合并倍数
+        double minResponse{0.05};  // 相关峰响应下限
+        int featherPx{128};        // 接缝羽化宽度，像素
+        bool gainCompensation{true};
+        int memoryMB{512};  // 合成条带的内存预算
+        int rawWidth{0};    // RAW 输入尺寸，0 表示取 [DET] DET_WIDTH_1X1 / DET_HEIGHT_1X1
+        int rawHeight{0};
+
+        // [STITCH] STITCH_COLUMNS / STITCH_OVERLAP / STITCH_PYRAMID / STITCH_MIN_RESPONSE / STITCH_FEATHER /
+        //          STITCH_GAIN / STITCH_MEMORY_MB
+        static Options fromConfig();
+    };
+
+    struct Result
+    {
+        bool ok{false};
+        QString error;
+        QString mosaicPath;
+        int width{0};
+        int height{0};
+        int shots{0};
+        int unaligned{0};  // 退回名义位置的拍摄数
+        int bands{0};
+        QVector<QPoint> positions;
+        QVector<double> gains;
+        QImage preview;  // 抽点预览，长边不超过 PREVIEW_MAX
+        double alignSec{0.0};
+        double composeSec{0.0};
+        double totalSec{0.0};
+
+        QString summary() const;
+    };
+
+    static constexpr int PREVIEW_MAX = 4096;
+
+    // percent 为 0-100；返回 false 时取消拼接
+    using ProgressFn = std::function<bool(int percent, const QString& stage)>;
+
+    // 输入为 16 位 RAW / TIFF 文件，输出 outputDir/Mosaic_<w>x<h>.raw
+    static Result stitch(const QStringList& files, const QString& outputDir, const Options& options,
+                         const ProgressFn& progress = ProgressFn());
+};
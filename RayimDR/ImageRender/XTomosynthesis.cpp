@@ -0,0 +1,251 @@
+#include "XTomosynthesis.h"
+
+#include <qdebug.h>
+#include <qelapsedtimer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XTS_USE_SSE2
+#endif
+
+#include "Components/XGlobal.h"
+#include "Components/XTileExecutor.h"
+#include "XFramePool.h"
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+constexpr int MAX_PLANES = 512;
+
+// 帧在某个焦平面上的亚像素平移：采样位置为 x + k + f，0 <= f < 1
+struct Shift
+{
+    int k{0};
+    float f{0.0f};
+};
+
+Shift frameShift(const XTomosynthesis::Options& options, double theta, double z)
+{
+    const double s = -options.sdd * std::sin(theta) * z / (options.sdd * std::cos(theta) - z) / options.pixelSize;
+    const double whole = std::floor(s);
+    return {static_cast<int>(whole), static_cast<float>(s - whole)};
+}
+
+// acc[i] += w0 * p0[i] + w1 * p1[i]
+void accumulateBlend(float* acc, const quint16* p0, const quint16* p1, float w0, float w1, int n)
+{
+    int i = 0;
+#ifdef XTS_USE_SSE2
+    const __m128i vZero = _mm_setzero_si128();
+    const __m128 vW0 = _mm_set1_ps(w0);
+    const __m128 vW1 = _mm_set1_ps(w1);
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1 + i));
+        const __m128 lo = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(a, vZero)), vW0),
+                                     _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(b, vZero)), vW1));
+        const __m128 hi = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(a, vZero)), vW0),
+                                     _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(b, vZero)), vW1));
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), lo));
+        _mm_storeu_ps(acc + i + 4, _mm_add_ps(_mm_loadu_ps(acc + i + 4), hi));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        acc[i] += w0 * p0[i] + w1 * p1[i];
+    }
+}
+
+QImage reconstructPlane(const QList<QImage>& frames, const std::vector<Shift>& shifts, bool vertical)
+{
+    const int width = frames.first().width();
+    const int height = frames.first().height();
+    QImage plane = XFramePool::Instance().acquire(width, height, QImage::Format_Grayscale16);
+    if (plane.isNull())
+    {
+        return QImage();
+    }
+
+    // 平移后超出图像的位置不参与平均，按位置统计实际参与的帧数
+    const int length = vertical ? height : width;
+    std::vector<float> count(length, 0.0f);
+    for (const Shift& s : shifts)
+    {
+        const int lo = std::max(0, -s.k);
+        const int hi = std::min(length, length - 1 - s.k);
+        for (int j = lo; j < hi; ++j)
+            count[j] += 1.0f;
+    }
+
+    std::vector<float> acc(width);
+    for (int y = 0; y < height; ++y)
+    {
+        std::fill(acc.begin(), acc.end(), 0.0f);
+        for (int i = 0; i < frames.size(); ++i)
+        {
+            const QImage& frame = frames.at(i);
+            const Shift& s = shifts[i];
+            if (vertical)
+            {
+                const int sy = y + s.k;
+                if (sy < 0 || sy + 1 >= height)
+                    continue;
+                accumulateBlend(acc.data(), reinterpret_cast<const quint16*>(frame.constScanLine(sy)),
+                                reinterpret_cast<const quint16*>(frame.constScanLine(sy + 1)), 1.0f - s.f, s.f,
+                                width);
+            }
+            else
+            {
+                const int lo = std::max(0, -s.k);
+                const int hi = std::min(width, width - 1 - s.k);
+                if (hi <= lo)
+                    continue;
+                const quint16* src = reinterpret_cast<const quint16*>(frame.constScanLine(y)) + lo + s.k;
+                accumulateBlend(acc.data() + lo, src, src + 1, 1.0f - s.f, s.f, hi - lo);
+            }
+        }
+
+        quint16* dst = reinterpret_cast<quint16*>(plane.scanLine(y));
+        for (int x = 0; x < width; ++x)
+        {
+            const float c = vertical ? count[y] : count[x];
+            const float v = c > 0.0f ? acc[x] / c + 0.5f : 0.0f;
+            dst[x] = static_cast<quint16>(std::clamp(v, 0.0f, 65535.0f));
+        }
+    }
+    return plane;
+}
+}  // namespace
+
+const char* const XTomosynthesis::PLANE_HEIGHT_KEY = "TomoPlaneHeight";
+
+XTomosynthesis::Options XTomosynthesis::Options::fromConfig()
+{
+    Options o;
+    o.arcDeg = xGlobal.getDouble("TOMO", "TOMO_ARC", o.arcDeg);
+    o.sdd = xGlobal.getDouble("TOMO", "TOMO_SDD", o.sdd);
+    o.pixelSize = xGlobal.getDouble("TOMO", "TOMO_PIXEL_SIZE", o.pixelSize);
+    o.planeMin = xGlobal.getDouble("TOMO", "TOMO_PLANE_MIN", o.planeMin);
+    o.planeMax = xGlobal.getDouble("TOMO", "TOMO_PLANE_MAX", o.planeMax);
+    o.planeStep = xGlobal.getDouble("TOMO", "TOMO_PLANE_STEP", o.planeStep);
+    o.verticalShift = xGlobal.getBool("TOMO", "TOMO_VERTICAL_SHIFT", o.verticalShift);
+    o.memoryMB = std::max(64, xGlobal.getInt("TOMO", "TOMO_MEMORY_MB", o.memoryMB));
+    return o;
+}
+
+QString XTomosynthesis::Result::summary() const
+{
+    if (!ok)
+    {
+        return QString("断层合成失败: %1").arg(error);
+    }
+    return QString("断层合成完成: %1 个焦平面, 高度 %2 - %3 mm, 耗时 %4 s")
+        .arg(planes.size())
+        .arg(heights.first(), 0, 'f', 1)
+        .arg(heights.last(), 0, 'f', 1)
+        .arg(seconds, 0, 'f', 2);
+}
+
+XTomosynthesis::Result XTomosynthesis::reconstruct(const QList<QImage>& frames, const Options& options)
+{
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+
+    if (frames.size() < 2)
+    {
+        result.error = QString("至少需要 2 帧图像，当前 %1 帧").arg(frames.size());
+        qWarning() << "[断层合成]" << result.error;
+        return result;
+    }
+    const QSize size = frames.first().size();
+    for (const QImage& frame : frames)
+    {
+        if (frame.format() != QImage::Format_Grayscale16 || frame.size() != size)
+        {
+            result.error = "帧图像须为尺寸一致的 16 位灰度图像";
+            qWarning() << "[断层合成]" << result.error << frame.format() << frame.size();
+            return result;
+        }
+    }
+
+    const double halfArc = options.arcDeg * 0.5 * PI / 180.0;
+    if (options.sdd <= 0.0 || options.pixelSize <= 0.0 || options.planeStep <= 0.0 ||
+        options.planeMax < options.planeMin || options.planeMin < 0.0 ||
+        options.planeMax >= options.sdd * std::cos(halfArc) * 0.9)
+    {
+        result.error = "断层合成参数无效";
+        qWarning() << "[断层合成]" << result.error << "- SDD:" << options.sdd << ", 像素:" << options.pixelSize
+                   << ", 平面:" << options.planeMin << "-" << options.planeMax << "/" << options.planeStep;
+        return result;
+    }
+
+    const int planeCount =
+        static_cast<int>(std::floor((options.planeMax - options.planeMin) / options.planeStep + 1e-6)) + 1;
+    // 结果一次性交给浏览列表，所有平面同时驻留内存，按整幅 16 位图像估算
+    const qint64 planeBytes = static_cast<qint64>(size.width()) * size.height() * sizeof(quint16);
+    const qint64 budget = static_cast<qint64>(options.memoryMB) * 1024 * 1024;
+    const int maxPlanes = static_cast<int>(std::clamp<qint64>(budget / planeBytes, 1, MAX_PLANES));
+    if (planeCount > maxPlanes)
+    {
+        result.error = QString("焦平面数量 %1 超过上限 %2（内存预算 %3 MB），请增大平面间距或 TOMO_MEMORY_MB")
+                           .arg(planeCount)
+                           .arg(maxPlanes)
+                           .arg(options.memoryMB);
+        qWarning() << "[断层合成]" << result.error;
+        return result;
+    }
+
+    // 帧按采集顺序均匀分布在摆角范围内
+    const int frameCount = frames.size();
+    std::vector<std::vector<Shift>> shifts(planeCount, std::vector<Shift>(frameCount));
+    result.heights.resize(planeCount);
+    for (int p = 0; p < planeCount; ++p)
+    {
+        const double z = options.planeMin + p * options.planeStep;
+        result.heights[p] = z;
+        for (int i = 0; i < frameCount; ++i)
+        {
+            const double theta = -halfArc + 2.0 * halfArc * i / (frameCount - 1);
+            shifts[p][i] = frameShift(options, theta, z);
+        }
+    }
+
+    std::vector<QImage> planes(planeCount);
+    const qsizetype bytesPerPlane = static_cast<qsizetype>(size.width()) * size.height() * 2 * frameCount;
+    XTileExecutor::Instance().parallelForTiles(
+        planeCount, bytesPerPlane,
+        [&](int planeBegin, int planeEnd)
+        {
+            for (int p = planeBegin; p < planeEnd; ++p)
+            {
+                planes[p] = reconstructPlane(frames, shifts[p], options.verticalShift);
+                if (!planes[p].isNull())
+                    planes[p].setText(PLANE_HEIGHT_KEY, QString::number(result.heights[p], 'f', 2));
+            }
+        },
+        1);
+
+    for (int p = 0; p < planeCount; ++p)
+    {
+        if (planes[p].isNull())
+        {
+            result.heights.clear();
+            result.error = "焦平面图像分配失败";
+            qCritical() << "[断层合成]" << result.error;
+            return result;
+        }
+        result.planes.append(planes[p]);
+    }
+
+    result.ok = true;
+    result.seconds = timer.nsecsElapsed() / 1e9;
+    qInfo() << "[断层合成]" << result.summary() << ", 帧数:" << frameCount << ", 尺寸:" << size << ", 摆角:"
+            << options.arcDeg << "°, 线程:" << (XTileExecutor::Instance().workerCount() + 1);
+    return result;
+}
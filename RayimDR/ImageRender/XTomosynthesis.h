@@ -0,0 +1,53 @@
+#pragma once
+
+#include <qimage.h>
+#include <qlist.h>
+#include <qstring.h>
+#include <qvector.h>
+
+/**
+ * @brief 有限角度断层合成（移位叠加法）
+ *
+ * 探测器固定，射线源在 [-arc/2, arc/2] 范围内绕探测器中心摆动，每个位置采集一帧（多帧 DR 采集）。
+ * 距探测器高度为 z 的平面在第 i 帧上的投影相对探测器平移
+ *     s_i(z) = -SDD * sinθ_i * z / (SDD * cosθ_i - z)
+ * 把每帧按 -s_i(z) 做亚像素平移（线性插值）后取平均，z 平面内的结构对齐叠加而变清晰，其余平面被模糊。
+ *
+ * 每个焦平面是一个独立任务，平面之间并行；单个平面内逐行对全部帧做 SSE2 加权累加。
+ */
+class XTomosynthesis
+{
+public:
+    struct Options
+    {
+        double arcDeg{30.0};      // 射线源总摆角，帧按顺序均匀分布
+        double sdd{1000.0};       // 射线源到探测器 mm
+        double pixelSize{0.139};  // 图像像素尺寸 mm（含合并）
+        double planeMin{0.0};     // 焦平面距探测器高度 mm
+        double planeMax{50.0};
+        double planeStep{1.0};
+        bool verticalShift{false};  // 射线源沿图像垂直方向摆动
+        int memoryMB{2048};         // 全部焦平面同时驻留内存，平面数量受此预算限制
+
+        // [TOMO] TOMO_ARC / TOMO_SDD / TOMO_PIXEL_SIZE / TOMO_PLANE_MIN / TOMO_PLANE_MAX / TOMO_PLANE_STEP /
+        //        TOMO_VERTICAL_SHIFT / TOMO_MEMORY_MB
+        static Options fromConfig();
+    };
+
+    struct Result
+    {
+        bool ok{false};
+        QString error;
+        QList<QImage> planes;     // 16 位灰度，按高度从低到高
+        QVector<double> heights;  // 与 planes 一一对应，mm
+        double seconds{0.0};
+
+        QString summary() const;
+    };
+
+    // 每个焦平面图像的 QImage::text() 中记录其高度（mm），便于浏览时显示
+    static const char* const PLANE_HEIGHT_KEY;
+
+    // frames 须为尺寸一致的 16 位灰度图像，至少 2 帧
+    static Result reconstruct(const QList<QImage>& frames, const Options& options);
+};
@@ -11,6 +11,7 @@
 
 #include "IRayDetector/NDT1717MA.h"
 #include "VJXRAY/IXS120BP120P366.h"
+#include "VJXRAY/XRayWarmupSequencer.h"
 
 #pragma warning(disable : 4305)
 
@@ -47,10 +48,18 @@ CommonConfigUI::CommonConfigUI(QWidget* parent) : QWidget(parent)
         QPixmap(":/Resource/Image/xray_close.png").scaled(32, 32, Qt::KeepAspectRatio, Qt::SmoothTransformation));
     ui.label_xRayStatus->setScaledContents(false);  // 自动缩放
                                                     // 定时器超时时切换图标
+
+    warmupSequencer = new XRayWarmupSequencer();
+    warmupSequencer->moveToThread(IXS120BP120P366::Instance().thread());
+
     initUIConnect();
 }
 
-CommonConfigUI::~CommonConfigUI() {}
+CommonConfigUI::~CommonConfigUI()
+{
+    warmupSequencer->abort();
+    warmupSequencer->deleteLater();
+}
 
 bool CommonConfigUI::checkInputValid()
 {
@@ -104,21 +113,14 @@ bool CommonConfigUI::checkInputValid()
     }
 
     // Check X-ray source status
+    autoXRayRequested = false;
     if (!IXS120BP120P366::Instance().xRayIsOn())
     {
         XElaDialog dialog("射线源未开启，是否先开启射线源？", XElaDialogType::ASK);
         if (xGlobal.getBool("SYSTEM", "AUTO_START_XRAY_ON_ACQ") || dialog.showCentered() == QDialog::Accepted)
         {
-            bool bRet = IXS120BP120P366::Instance().setVoltage(ui.spinBox_targetVoltage->value());
-            bRet = IXS120BP120P366::Instance().setCurrent(ui.spinBox_targetCurrent->value());
-            bRet = IXS120BP120P366::Instance().startXRay();
-            int ptst = IXS120BP120P366::Instance().getPTST();
-            QThread::msleep(1000 + ptst * 1000);
-            return bRet;
-        }
-        else
-        {
-            return true;
+            // 由采集任务开启射线，电压 / 电流读数稳定后再启动探测器
+            autoXRayRequested = true;
         }
     }
 
@@ -132,6 +134,9 @@ AcqCondition CommonConfigUI::getAcqCondition()
     acqCond.frameRate = ui.comboBox_frameRate->currentText().toInt();
     acqCond.frameRate = acqCond.frameRate > 0 ? acqCond.frameRate : 1;
     acqCond.stackedFrame = ui.comboBox_stakcedNum->currentText().toInt();
+    acqCond.voltage = ui.spinBox_targetVoltage->value();
+    acqCond.current = ui.spinBox_targetCurrent->value();
+    acqCond.autoXRay = autoXRayRequested;
     return acqCond;
 }
 
@@ -231,27 +236,13 @@ void CommonConfigUI::initUIConnect()
     if (auto* currentLineEdit = ui.spinBox_targetCurrent->findChild<QLineEdit*>())
     {
         connect(currentLineEdit, &QLineEdit::returnPressed, this,
-                [this]()
-                {
-                    auto future = QtConcurrent::run(
-                        [this]() { IXS120BP120P366::Instance().setCurrent(ui.spinBox_targetCurrent->value()); });
-                    auto* watcher = new QFutureWatcher<void>(this);
-                    connect(watcher, &QFutureWatcher<void>::finished, this,
-                            [this, watcher]() { watcher->deleteLater(); });
-                });
+                [this]() { IXS120BP120P366::Instance().setCurrentAsync(ui.spinBox_targetCurrent->value()); });
     }
 
     if (auto* voltageLineEdit = ui.spinBox_targetVoltage->findChild<QLineEdit*>())
     {
         connect(voltageLineEdit, &QLineEdit::returnPressed, this,
-                [this]()
-                {
-                    auto future = QtConcurrent::run(
-                        [this]() { IXS120BP120P366::Instance().setVoltage(ui.spinBox_targetVoltage->value()); });
-                    auto* watcher = new QFutureWatcher<void>(this);
-                    connect(watcher, &QFutureWatcher<void>::finished, this,
-                            [this, watcher]() { watcher->deleteLater(); });
-                });
+                [this]() { IXS120BP120P366::Instance().setVoltageAsync(ui.spinBox_targetVoltage->value()); });
     }
 
     connect(&IXS120BP120P366::Instance(), &IXS120BP120P366::statusUpdated, this,
@@ -297,9 +288,9 @@ void CommonConfigUI::initUIConnect()
             {
                 if (IXS120BP120P366::Instance().isConnected())
                 {
-                    IXS120BP120P366::Instance().setVoltage(ui.spinBox_targetVoltage->value());
-                    IXS120BP120P366::Instance().setCurrent(ui.spinBox_targetCurrent->value());
-                    IXS120BP120P366::Instance().startXRay();
+                    IXS120BP120P366::Instance().setVoltageAsync(ui.spinBox_targetVoltage->value());
+                    IXS120BP120P366::Instance().setCurrentAsync(ui.spinBox_targetCurrent->value());
+                    IXS120BP120P366::Instance().startXRayAsync();
                 }
                 else
                 {
@@ -307,7 +298,8 @@ void CommonConfigUI::initUIConnect()
                 }
             });
 
-    connect(ui.pushButton_stopXRay, &QPushButton::clicked, this, [this]() { IXS120BP120P366::Instance().stopXRay(); });
+    connect(ui.pushButton_stopXRay, &QPushButton::clicked, this,
+            [this]() { IXS120BP120P366::Instance().stopXRayAsync(); });
 
     connect(ui.pushButton_clearErr, &QPushButton::clicked, this, [this]() { IXS120BP120P366::Instance().clearErr(); });
 
@@ -334,6 +326,19 @@ void CommonConfigUI::initUIConnect()
 
     connect(ui.pushButton_stopPreheat, &QPushButton::clicked, this, &CommonConfigUI::stopPreheat);
 
+    connect(warmupSequencer, &XRayWarmupSequencer::stepChanged, this,
+            [](int index, int count, int voltage, int current)
+            {
+                emit xSignaHelper.signalUpdateStatusInfo(
+                    QString("训管中: 第 %1/%2 步 %3kV %4uA").arg(index + 1).arg(count).arg(voltage).arg(current));
+            });
+    connect(warmupSequencer, &XRayWarmupSequencer::stateChanged, this,
+            [this](XRayWarmupSequencer::State state)
+            {
+                ui.pushButton_startPreheat->setText(state == XRayWarmupSequencer::State::Paused ? "继续" : "暂停");
+            });
+    connect(warmupSequencer, &XRayWarmupSequencer::finished, this, &CommonConfigUI::onPreheatFinished);
+
     connect(
         blinkTimer, &QTimer::timeout, this,
         [this]()
@@ -462,68 +467,54 @@ void CommonConfigUI::updateUIFromMode(std::string mode)
 
 void CommonConfigUI::startPreheat()
 {
+    // 训管进行中时该按钮用作暂停 / 继续
+    if (warmupSequencer->isRunning())
+    {
+        if (warmupSequencer->state() == XRayWarmupSequencer::State::Paused)
+        {
+            warmupSequencer->resume();
+        }
+        else
+        {
+            warmupSequencer->pause();
+        }
+        return;
+    }
+
     if (!IXS120BP120P366::Instance().isConnected())
     {
         emit xSignaHelper.signalShowErrorMessageBar("射线源未连接，请检查网络连接并重启本程序");
         return;
     }
 
-    ui.pushButton_startPreheat->setEnabled(false);
+    ui.pushButton_startPreheat->setText("暂停");
     ui.pushButton_startXRay->setEnabled(false);
     ui.pushButton_stopXRay->setEnabled(false);
-    int waitTime{3};
-    std::vector<int> voltages = {30, 40, 50, 60, 70, 80, 90, 100, 110, 120};
-    std::vector<float> currents = {0.2000, 0.2889, 0.3778, 0.4667, 0.5556, 0.6444, 0.7333, 0.8222, 0.9111, 1.0000};
-    if (ui.comboBox_preheat->currentIndex() == 0)
-    {
-        waitTime = 3;
-    }
-    else if (ui.comboBox_preheat->currentIndex() == 1)
-    {
-        waitTime = 6;
-    }
-    else
-    {
-        waitTime = 30;
-    }
-
-    auto future = QtConcurrent::run(
-        [this, waitTime, voltages, currents]()
-        {
-            IXS120BP120P366::Instance().setIsPreheat(true);
-            IXS120BP120P366::Instance().setVoltage(voltages.at(0));
-            IXS120BP120P366::Instance().setCurrent(currents.at(0) * 1000);
-            IXS120BP120P366::Instance().startXRay();
-            int ptst = IXS120BP120P366::Instance().getPTST();
-            qDebug() << "ptst: " << ptst;
-            QThread::msleep(waitTime * 1000 + ptst * 1000);
-            for (int i(1); i < voltages.size(); i++)
-            {
-                IXS120BP120P366::Instance().setVoltage(voltages.at(i));
-                IXS120BP120P366::Instance().setCurrent(currents.at(i) * 1000);
-                QThread::msleep(waitTime * 1000);
-            }
-            IXS120BP120P366::Instance().stopXRay();
-        });
+    ui.comboBox_preheat->setEnabled(false);
 
-    auto* watcher = new QFutureWatcher<void>(this);
-    connect(watcher, &QFutureWatcher<void>::finished, this,
-            [this, watcher]()
-            {
-                ui.pushButton_startPreheat->setEnabled(true);
-                ui.pushButton_startXRay->setEnabled(true);
-                ui.pushButton_stopXRay->setEnabled(true);
-                IXS120BP120P366::Instance().setIsPreheat(false);
-                emit xSignaHelper.signalShowSuccessMessageBar("训管结束");
-            });
-    watcher->setFuture(future);
+    warmupSequencer->start(XRayWarmupSequencer::loadSteps(),
+                           XRayWarmupSequencer::holdSecondsForLevel(ui.comboBox_preheat->currentIndex()));
 }
 
 void CommonConfigUI::stopPreheat()
 {
-    IXS120BP120P366::Instance().getPTST();
-    IXS120BP120P366::Instance().stopXRay();
-    ui.pushButton_startPreheat->setEnabled(true);
+    warmupSequencer->abort();
+}
+
+void CommonConfigUI::onPreheatFinished(bool success, const QString& message)
+{
+    ui.pushButton_startPreheat->setText("执行");
+    ui.pushButton_startPreheat->setEnabled(IXS120BP120P366::Instance().isConnected());
     ui.pushButton_startXRay->setEnabled(true);
     ui.pushButton_stopXRay->setEnabled(true);
+    ui.comboBox_preheat->setEnabled(true);
+    emit xSignaHelper.signalUpdateStatusInfo(message);
+    if (success)
+    {
+        emit xSignaHelper.signalShowSuccessMessageBar(message);
+    }
+    else
+    {
+        emit xSignaHelper.signalShowErrorMessageBar(message);
+    }
 }
@@ -5,6 +5,8 @@
 
 #include "Components/XGlobal.h"
 
+class XRayWarmupSequencer;
+
 class CommonConfigUI : public QWidget
 {
     Q_OBJECT
@@ -13,6 +15,7 @@ public:
     CommonConfigUI(QWidget* parent = nullptr);
     ~CommonConfigUI();
 
+    // 射线未开启且需要开启时，由随后 getAcqCondition() 返回的条件交给采集任务出束
     bool checkInputValid();
     AcqCondition getAcqCondition();
 
@@ -26,12 +29,15 @@ private:
     void updateUIFromMode(std::string mode);
     void startPreheat();
     void stopPreheat();
+    void onPreheatFinished(bool success, const QString& message);
 
 private:
     Ui::CommonConfigUIClass ui;
 
     QTimer* blinkTimer{nullptr};
+    XRayWarmupSequencer* warmupSequencer{nullptr};  // 运行于射线源工作线程
     bool isIndicatorBright;  // 闪烁状态标志
 
     AcqCondition acqCondition;
+    bool autoXRayRequested{false};
 };
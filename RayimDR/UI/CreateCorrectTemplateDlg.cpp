@@ -4,10 +4,13 @@
 #include <qgraphicsitem.h>
 #include <QtConcurrent/QtConcurrent>
 #include <QFutureWatcher>
+#include <qelapsedtimer.h>
 
 #include "IRayDetector/NDT1717MA.h"
 #include "VJXRAY/IXS120BP120P366.h"
 #include "ImageRender/XImageHelper.h"
+#include "Components/XExposureController.h"
+#include "Components/XGlobal.h"
 
 CreateCorrectTemplateDlg::CreateCorrectTemplateDlg(QWidget* parent) : ElaDialog(parent)
 {
@@ -200,27 +203,74 @@ void CreateCorrectTemplateDlg::stopXRaySource()
     emit signalTipsChanged("射线源已关闭");
 }
 
-void CreateCorrectTemplateDlg::adjustCurrentUntilTargetGray(int& currentValue, int targetGray, int ptst)
+int CreateCorrectTemplateDlg::waitForFreshGray(int transaction, bool& timedOut)
 {
-    constexpr int MAX_CURRENT = 1000;
-    constexpr int CURRENT_STEP = 100;
-    constexpr int ADJUSTMENT_DELAY = 3000;  // milliseconds
-
-    while (nCurrentGray < targetGray)
+    // 丢弃电流变化前已在曝光中的帧，只取之后的稳定帧
+    const int settleFrames = std::max(1, xGlobal.getInt("EXPOSURE", "EXPOSURE_SETTLE_FRAMES", 2));
+    const int timeoutMs = xGlobal.getInt("EXPOSURE", "EXPOSURE_FRAME_TIMEOUT_MS", 5000);
+    const int settleMs = xGlobal.getInt("EXPOSURE", "EXPOSURE_SETTLE_MS", 300);
+    const int retries = std::max(0, xGlobal.getInt("EXPOSURE", "EXPOSURE_MEASURE_RETRIES", 2));
+
+    timedOut = false;
+    QThread::msleep(settleMs);
+    for (int attempt = 0; attempt <= retries; ++attempt)
     {
-        if (currentValue >= MAX_CURRENT)
+        const int startCount = nGrayFrameCount.load();
+        QElapsedTimer timer;
+        timer.start();
+        while (nGrayFrameCount.load() - startCount < settleFrames)
         {
-            qDebug() << "[X-Ray] Maximum current reached:" << MAX_CURRENT << "uA";
-            break;
+            if (DET.CurrentTransaction() != transaction)
+            {
+                qDebug() << "[Adjustment] Calibration aborted by user";
+                return -1;
+            }
+            if (timer.elapsed() > timeoutMs)
+            {
+                break;
+            }
+            QThread::msleep(20);
         }
+        if (nGrayFrameCount.load() - startCount >= settleFrames)
+        {
+            return nCurrentGray.load();
+        }
+        qWarning() << "[Adjustment] No fresh frame within" << timeoutMs << "ms, attempt" << attempt + 1 << "/"
+                   << retries + 1;
+    }
+    timedOut = true;
+    return -1;
+}
 
-        currentValue += CURRENT_STEP;
-        qDebug() << "[Adjustment] Target gray:" << targetGray << "Current gray:" << nCurrentGray
-                 << "New current:" << currentValue << "uA";
-
-        IXS120BP120P366::Instance().setCurrent(currentValue);
-        QThread::msleep(ptst * 1000 + ADJUSTMENT_DELAY);
+bool CreateCorrectTemplateDlg::adjustCurrentUntilTargetGray(int voltage, int& currentValue, int targetGray,
+                                                            int transaction)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    bool timedOut = false;
+    XExposureController controller;
+    XExposureController::Result result = controller.search(
+        currentValue, targetGray,
+        [this, voltage, transaction](int uA)
+        {
+            if (transaction == 1)
+                emit signalGainVoltageCurrentChanged(voltage, uA);
+            else
+                emit signalDefectVoltageCurrentChanged(voltage, uA);
+            return IXS120BP120P366::Instance().setCurrent(uA);
+        },
+        [this, transaction, &timedOut]() { return waitForFreshGray(transaction, timedOut); });
+
+    qDebug() << "[Adjustment] Target gray:" << targetGray << result << "Elapsed:" << timer.elapsed() << "ms";
+    currentValue = result.current;
+    if (result.aborted && timedOut)
+    {
+        // 与原先逐级爬坡一致：测量失败不终止校正，保持已下发的电流继续采集
+        qWarning() << "[Adjustment] Gray measurement timed out, continuing with" << result.current << "uA";
+        return true;
     }
+    return !result.aborted;
 }
 
 // ============================================================================
@@ -296,7 +346,7 @@ void CreateCorrectTemplateDlg::Gain()
     auto future = QtConcurrent::run(
         [this]()
         {
-            nCurrentGray = 0;
+            nCurrentGray.store(0);
 
             // Step 1: Initialize
             qDebug() << "[Gain] Step 1: Initializing";
@@ -336,33 +386,11 @@ void CreateCorrectTemplateDlg::Gain()
                 return false;
             }
 
-            // Wait for first data
-            QThread::msleep(2000);
-            emit signalGainVoltageCurrentChanged(voltage, current);
-
             // Step 4: Adjust current until target gray value
             qDebug() << "[Gain] Step 4: Adjusting current to reach target gray value";
-            while (nCurrentGray < DET.nGainExpectedGray)
+            if (!adjustCurrentUntilTargetGray(voltage, current, DET.nGainExpectedGray, 1))
             {
-                if (DET.CurrentTransaction() != 1)
-                {
-                    qDebug() << "[Gain] Calibration aborted by user";
-                    return false;
-                }
-
-                qDebug() << "[Gain] Gray level - Current:" << nCurrentGray << "Target:" << DET.nGainExpectedGray
-                         << "Current:" << current << "uA";
-
-                if (current >= 1000)
-                {
-                    qDebug() << "[Gain] Maximum current reached: 1000 uA";
-                    break;
-                }
-
-                current += 100;
-                emit signalGainVoltageCurrentChanged(voltage, current);
-                IXS120BP120P366::Instance().setCurrent(current);
-                QThread::msleep(ptst * 1000 + 3000);
+                return false;
             }
 
             // Step 5: Select images
@@ -447,7 +475,7 @@ void CreateCorrectTemplateDlg::Defect()
     auto future = QtConcurrent::run(
         [this]()
         {
-            nCurrentGray = 0;
+            nCurrentGray.store(0);
 
             // Step 1: Initialize
             qDebug() << "[Defect] Step 1: Initializing";
@@ -496,33 +524,11 @@ void CreateCorrectTemplateDlg::Defect()
                     return false;
                 }
 
-                // Wait for first data
-                QThread::msleep(2000);
-
                 // Step 4: Adjust current until target gray value
                 qDebug() << "[Defect] Group" << (groupIdx + 1) << "- Adjusting current to reach target gray";
-
-                while (nCurrentGray < targetGray)
+                if (!adjustCurrentUntilTargetGray(voltage, current, targetGray, 2))
                 {
-                    if (DET.CurrentTransaction() != 2)
-                    {
-                        qDebug() << "[Defect] Calibration aborted by user";
-                        return false;
-                    }
-
-                    qDebug() << "[Defect] Group" << (groupIdx + 1) << "- Gray level - Current:" << nCurrentGray
-                             << "Target:" << targetGray << "Current:" << current << "uA";
-
-                    if (current >= 1000)
-                    {
-                        qDebug() << "[Defect] Maximum current reached: 1000 uA";
-                        break;
-                    }
-
-                    current += 100;
-                    emit signalDefectVoltageCurrentChanged(voltage, current);
-                    IXS120BP120P366::Instance().setCurrent(current);
-                    QThread::msleep(2000);
+                    return false;
                 }
 
                 if (DET.CurrentTransaction() != 2)
@@ -704,7 +710,8 @@ void CreateCorrectTemplateDlg::onGainAcqImageReceived(QImage image, int idx, int
 {
     // Update gray value display immediately (lightweight operation)
     ui.lineEdit_GainCenterValue->setText(QString::number(grayValue));
-    nCurrentGray = grayValue;
+    nCurrentGray.store(grayValue);
+    nGrayFrameCount.fetch_add(1);
 
     // Process image in background thread to avoid UI blocking
     const int viewWidth = ui.graphicsView_GainImageView->width() - 5;
@@ -752,7 +759,8 @@ void CreateCorrectTemplateDlg::onDefectAcqImageReceived(QImage image, int idx, i
 {
     // Update gray value display immediately (lightweight operation)
     ui.lineEdit_DefectCurrentGray->setText(QString::number(grayValue));
-    nCurrentGray = grayValue;
+    nCurrentGray.store(grayValue);
+    nGrayFrameCount.fetch_add(1);
 
     // Process image in background thread to avoid UI blocking
     const int viewWidth = ui.graphicsView_DefectImageView->width() - 5;
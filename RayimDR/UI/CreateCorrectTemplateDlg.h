@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "ElaDialog.h"
 #include "ui_CreateCorrectTemplateDlg.h"
 
@@ -34,7 +36,8 @@ private:
     // X-ray source control helpers
     void startXRaySource(int voltage, int current);
     void stopXRaySource();
-    void adjustCurrentUntilTargetGray(int& currentValue, int targetGray, int ptst);
+    bool adjustCurrentUntilTargetGray(int voltage, int& currentValue, int targetGray, int transaction);
+    int waitForFreshGray(int transaction, bool& timedOut);
 
 private:
     void onOffsetImageSelected(int nTotal, int nValid);
@@ -52,7 +55,8 @@ signals:
 
 private:
     Ui::CreateCorrectTemplateDlgClass ui;
-    int nCurrentGray{0};
+    std::atomic_int nCurrentGray{0};
+    std::atomic_int nGrayFrameCount{0};
     class QGraphicsPixmapItem* gainPixmapItem{nullptr};
     class QGraphicsPixmapItem* defectPixmapItem{nullptr};
 };
@@ -14,6 +14,9 @@
 #include <qurl.h>
 #include <qdir.h>
 #include <qfile.h>
+#include <qfiledialog.h>
+#include <qinputdialog.h>
+#include <qactiongroup.h>
 
 #include "ElaContentDialog.h"
 #include "ElaTheme.h"
@@ -36,6 +39,12 @@
 #include "ImageRender/XGraphicsView.h"
 #include "ImageRender/XImageAdjustTool.h"
 #include "ImageRender/XImageHelper.h"
+#include "ImageRender/XFlatFieldCorrector.h"
+#include "ImageRender/XFdkReconstructor.h"
+#include "ImageRender/XHdrFusion.h"
+#include "ImageRender/XTomosynthesis.h"
+#include "ImageRender/XImageStacker.h"
+#include "ImageRender/XImageStitcher.h"
 
 #include "UI/XElaDialog.h"
 #include "UI/CommonConfigUI.h"
@@ -47,6 +56,39 @@
 #include "IRayDetector/IRayDetectorWidget.h"
 
 #include "VJXRAY/IXS120BP120P366.h"
+#include "VJXRAY/XRaySourceEmulator.h"
+#include "VJXRAY/XRaySourceBenchmark.h"
+
+namespace
+{
+// 按文件名排序返回文件夹内的 RAW/TIFF 文件
+QFileInfoList listImageFiles(const QString& folderPath)
+{
+    return QDir(folderPath).entryInfoList({"*.raw", "*.tif", "*.tiff"}, QDir::Files, QDir::Name);
+}
+
+bool containsRawFile(const QFileInfoList& files)
+{
+    return std::any_of(files.begin(), files.end(),
+                       [](const QFileInfo& info) { return info.suffix().compare("raw", Qt::CaseInsensitive) == 0; });
+}
+
+QList<QImage> loadImageFiles(const QFileInfoList& files, int w, int h)
+{
+    QList<QImage> images;
+    for (const QFileInfo& info : files)
+    {
+        QImage image = XImageHelper::openImageFile(info.absoluteFilePath(), w, h);
+        if (image.isNull())
+        {
+            qWarning() << "[MainWindow] Skip unreadable image:" << info.absoluteFilePath();
+            continue;
+        }
+        images.append(std::move(image));
+    }
+    return images;
+}
+}  // namespace
 
 // ============================================================================
 // Constructor / Destructor
@@ -78,6 +120,7 @@ MainWindow::MainWindow(QWidget* parent) : ElaWindow(parent)
 MainWindow::~MainWindow()
 {
     qDebug() << "[MainWindow] Destroying main window";
+    delete _xraySourceEmulator;
 }
 
 // ============================================================================
@@ -141,6 +184,9 @@ void MainWindow::createUIComponents()
     _statusText = new ElaText(QDateTime::currentDateTime().toString(), statusBar);
     _statusText->setTextPixelSize(15);
     statusBar->addWidget(_statusText, 1);
+    _frameRateText = new ElaText("", statusBar);
+    _frameRateText->setTextPixelSize(15);
+    statusBar->addPermanentWidget(_frameRateText);
     setStatusBar(statusBar);
 }
 
@@ -192,6 +238,18 @@ void MainWindow::setupConnections()
     connect(_XImageAdjustTool, &XImageAdjustTool::signalSetROIEnable, _XGraphicsView, &XGraphicsView::setROIEnable);
     connect(_XImageAdjustTool, &XImageAdjustTool::signalAutoWL, _XGraphicsView, &XGraphicsView::setAutoWLEnable);
     connect(_XImageAdjustTool, &XImageAdjustTool::signalImageIdxChanged, _XGraphicsView, &XGraphicsView::showImage);
+    connect(_XImageAdjustTool, &XImageAdjustTool::signalImageIdxChanged, this,
+            [this](int idx)
+            {
+                // 浏览断层合成结果时显示焦平面高度
+                const QList<QImage>& images = _XGraphicsView->getSrcU16ImageList();
+                if (idx < 0 || idx >= images.size())
+                    return;
+                const QString height = images.at(idx).text(XTomosynthesis::PLANE_HEIGHT_KEY);
+                if (!height.isEmpty())
+                    updateStatusText(
+                        QString("断层合成焦平面 %1/%2，距探测器 %3 mm").arg(idx + 1).arg(images.size()).arg(height));
+            });
 
     connect(_XGraphicsView, &XGraphicsView::signalSrcU16ImageListSizeChanged, _XImageAdjustTool,
             &XImageAdjustTool::updateIdxRange);
@@ -210,6 +268,8 @@ void MainWindow::setupConnections()
     connect(&AcqTaskManager::Instance(), &AcqTaskManager::signalAcqErr, this, &MainWindow::onAcqErr);
     connect(&AcqTaskManager::Instance(), &AcqTaskManager::signalAcqProgressChanged, this,
             &MainWindow::onAcqProgressChanged);
+    connect(&AcqTaskManager::Instance(), &AcqTaskManager::signalFrameRateChanged, this,
+            [this](const QString& msg) { _frameRateText->setText(msg); });
 
     // Image helper connections
     connect(&XImageHelper::Instance(), &XImageHelper::signalOpenImageFolderProgressChanged, this,
@@ -309,7 +369,9 @@ void MainWindow::enableAcq(bool enable)
 {
     toolButtonDR->setEnabled(enable);
     toolButtonDRMulti->setEnabled(enable);
+    toolButtonHDR->setEnabled(enable);
     toolButtonRealTimeDR->setEnabled(enable);
+    toolButtonCT->setEnabled(enable);
 }
 
 // ============================================================================
@@ -476,6 +538,410 @@ void MainWindow::onMenuOpenHelpFile()
     }
 }
 
+bool MainWindow::askRawImageSize(int& width, int& height)
+{
+    bool ok = false;
+    width = QInputDialog::getInt(this, "输入图像宽度", "请输入 RAW 图像宽度（像素）:",
+                                 xGlobal.getInt("DET", "DET_WIDTH_1X1"), 1, 65536, 1, &ok);
+    if (!ok)
+        return false;
+
+    height = QInputDialog::getInt(this, "输入图像高度", "请输入 RAW 图像高度（像素）:",
+                                  xGlobal.getInt("DET", "DET_HEIGHT_1X1"), 1, 65536, 1, &ok);
+    return ok;
+}
+
+void MainWindow::onMenuSoftCorrectionToggled(bool checked)
+{
+    qDebug() << "[MainWindow] Menu: Soft correction" << (checked ? "enabled" : "disabled");
+    xGlobal.setBool("CORRECTION", "SOFT_CORRECTION_ENABLE", checked);
+}
+
+void MainWindow::onMenuSoftCorrectionTemplate()
+{
+    qDebug() << "[MainWindow] Menu: Generate soft correction templates";
+
+    const QString darkFolder = QFileDialog::getExistingDirectory(this, "选择暗场图像文件夹", QDir::homePath());
+    if (darkFolder.isEmpty())
+        return;
+
+    // 亮场可选，取消时仅生成本底模板
+    const QString flatFolder = QFileDialog::getExistingDirectory(this, "选择亮场图像文件夹（取消则仅生成本底模板）",
+                                                                 QFileInfo(darkFolder).absolutePath());
+
+    const QFileInfoList darkFiles = listImageFiles(darkFolder);
+    const QFileInfoList flatFiles = flatFolder.isEmpty() ? QFileInfoList() : listImageFiles(flatFolder);
+    if (darkFiles.isEmpty())
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("暗场文件夹中没有找到图像文件（支持 .raw / .tif / .tiff）");
+        return;
+    }
+
+    int width = 0;
+    int height = 0;
+    if ((containsRawFile(darkFiles) || containsRawFile(flatFiles)) && !askRawImageSize(width, height))
+        return;
+
+    updateStatusText("正在生成软件校正模板...");
+    auto future = QtConcurrent::run(
+        [darkFiles, flatFiles, width, height]() -> QString
+        {
+            auto& corrector = XFlatFieldCorrector::Instance();
+            if (!corrector.buildOffset(loadImageFiles(darkFiles, width, height)))
+                return "本底模板生成失败";
+            if (!flatFiles.isEmpty() && !corrector.buildGain(loadImageFiles(flatFiles, width, height)))
+                return "增益模板生成失败";
+            if (!corrector.saveTemplates(XFlatFieldCorrector::templateDir()))
+                return "校正模板保存失败";
+            return QString();
+        });
+
+    auto* watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this,
+            [this, watcher]()
+            {
+                const QString err = watcher->result();
+                watcher->deleteLater();
+                if (!err.isEmpty())
+                {
+                    updateStatusText(err);
+                    emit xSignaHelper.signalShowErrorMessageBar(err);
+                    return;
+                }
+
+                const QSize size = XFlatFieldCorrector::Instance().templateSize();
+                updateStatusText(QString("软件校正模板已生成, 尺寸: %1x%2, %3")
+                                     .arg(size.width())
+                                     .arg(size.height())
+                                     .arg(XFlatFieldCorrector::Instance().defectSummary()));
+                emit xSignaHelper.signalShowSuccessMessageBar("软件校正模板已生成");
+            });
+    watcher->setFuture(future);
+}
+
+void MainWindow::onMenuSoftCorrectCurrentImage()
+{
+    qDebug() << "[MainWindow] Menu: Soft correct current image";
+
+    QImage image = _XGraphicsView->getSrcU16Image();
+    if (image.isNull())
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("当前没有正在显示的图像");
+        return;
+    }
+
+    auto& corrector = XFlatFieldCorrector::Instance();
+    if (!corrector.hasOffset() && !corrector.loadTemplates(XFlatFieldCorrector::templateDir()))
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("未找到软件校正模板，请先生成模板");
+        return;
+    }
+
+    if (!corrector.apply(image))
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("图像校正失败，请检查图像尺寸是否与模板一致");
+        return;
+    }
+
+    _XGraphicsView->updateImage(image);
+    updateStatusText("当前图像已完成软件校正");
+}
+
+void MainWindow::onMenuSoftCorrectFolder()
+{
+    qDebug() << "[MainWindow] Menu: Soft correct image folder";
+
+    const QString inFolder = QFileDialog::getExistingDirectory(this, "选择待校正图像文件夹", QDir::homePath());
+    if (inFolder.isEmpty())
+        return;
+
+    const QFileInfoList files = listImageFiles(inFolder);
+    if (files.isEmpty())
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("文件夹中没有找到图像文件（支持 .raw / .tif / .tiff）");
+        return;
+    }
+
+    const QString outFolder = QFileDialog::getExistingDirectory(this, "选择校正结果保存文件夹", inFolder);
+    if (outFolder.isEmpty())
+        return;
+    if (QDir(outFolder) == QDir(inFolder))
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("保存文件夹不能与输入文件夹相同");
+        return;
+    }
+
+    auto& corrector = XFlatFieldCorrector::Instance();
+    if (!corrector.hasOffset() && !corrector.loadTemplates(XFlatFieldCorrector::templateDir()))
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("未找到软件校正模板，请先生成模板");
+        return;
+    }
+
+    int width = 0;
+    int height = 0;
+    if (containsRawFile(files) && !askRawImageSize(width, height))
+        return;
+
+    updateStatusText(QString("正在批量校正 %1 个文件...").arg(files.size()));
+    auto future = QtConcurrent::run(
+        [files, outFolder, width, height]() -> int
+        {
+            int succeeded = 0;
+            for (const QFileInfo& info : files)
+            {
+                const QString outPath = QDir(outFolder).filePath(info.fileName());
+                if (XFlatFieldCorrector::Instance().correctFile(info.absoluteFilePath(), outPath, width, height))
+                    ++succeeded;
+            }
+            return succeeded;
+        });
+
+    auto* watcher = new QFutureWatcher<int>(this);
+    connect(watcher, &QFutureWatcher<int>::finished, this,
+            [this, watcher, total = files.size()]()
+            {
+                const int succeeded = watcher->result();
+                watcher->deleteLater();
+                updateStatusText(QString("批量校正完成: %1/%2").arg(succeeded).arg(total));
+                if (succeeded == total)
+                    emit xSignaHelper.signalShowSuccessMessageBar("批量校正完成");
+                else
+                    emit xSignaHelper.signalShowErrorMessageBar(
+                        QString("批量校正有 %1 个文件失败，详见日志").arg(total - succeeded));
+            });
+    watcher->setFuture(future);
+}
+
+void MainWindow::onMenuXRayBenchmark()
+{
+    qDebug() << "[MainWindow] Menu: X-ray source benchmark";
+
+    if (!xRaySource.isConnected())
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("射线源未连接，无法进行通信测试");
+        return;
+    }
+
+    updateStatusText("正在进行射线源通信测试...");
+    XRaySourceEmulator* emulator = _xraySourceEmulator;
+    auto future = QtConcurrent::run([emulator]() { return XRaySourceBenchmark::run(emulator); });
+
+    auto* watcher = new QFutureWatcher<XRaySourceBenchmark::Result>(this);
+    connect(watcher, &QFutureWatcher<XRaySourceBenchmark::Result>::finished, this,
+            [this, watcher]()
+            {
+                const XRaySourceBenchmark::Result result = watcher->result();
+                watcher->deleteLater();
+                updateStatusText(result.summary().replace('\n', "; "));
+                if (result.ok)
+                    emit xSignaHelper.signalShowSuccessMessageBar("射线源通信测试完成，结果已写入日志");
+                else
+                    emit xSignaHelper.signalShowErrorMessageBar(result.summary());
+            });
+    watcher->setFuture(future);
+}
+
+void MainWindow::onMenuCtReconstruct()
+{
+    qDebug() << "[MainWindow] Menu: CT reconstruction";
+
+    const QString projectionPath = QFileDialog::getOpenFileName(
+        this, "选择投影文件", xGlobal.getString("CT", "CT_SAVE_PATH", QDir::homePath()), "投影文件 (*.xprj)");
+    if (projectionPath.isEmpty())
+    {
+        return;
+    }
+    const QString outputDir =
+        QFileDialog::getExistingDirectory(this, "选择体数据保存文件夹", QFileInfo(projectionPath).absolutePath());
+    if (outputDir.isEmpty())
+    {
+        return;
+    }
+
+    updateStatusText("正在进行CT重建...");
+    const XFdkReconstructor::Geometry geometry = XFdkReconstructor::Geometry::fromConfig();
+    const XFdkReconstructor::Options options = XFdkReconstructor::Options::fromConfig();
+    auto future = QtConcurrent::run(
+        [projectionPath, outputDir, geometry, options]()
+        {
+            return XFdkReconstructor::reconstruct(projectionPath, outputDir, geometry, options,
+                                                  [](int percent, const QString& stage)
+                                                  {
+                                                      emit xSignaHelper.signalUpdateStatusInfo(
+                                                          QString("CT重建 %1% - %2").arg(percent).arg(stage));
+                                                      return true;
+                                                  });
+        });
+
+    auto* watcher = new QFutureWatcher<XFdkReconstructor::Result>(this);
+    connect(watcher, &QFutureWatcher<XFdkReconstructor::Result>::finished, this,
+            [this, watcher]()
+            {
+                const XFdkReconstructor::Result result = watcher->result();
+                watcher->deleteLater();
+                updateStatusText(result.summary());
+                if (result.ok)
+                    emit xSignaHelper.signalShowSuccessMessageBar(
+                        QString("CT重建完成: %1").arg(QFileInfo(result.volumePath).fileName()));
+                else
+                    emit xSignaHelper.signalShowErrorMessageBar(result.summary());
+            });
+    watcher->setFuture(future);
+}
+
+void MainWindow::onMenuReconBenchmark()
+{
+    qDebug() << "[MainWindow] Menu: reconstruction benchmark";
+
+    updateStatusText("正在进行重建性能测试...");
+    auto future = QtConcurrent::run([]() { return XFdkReconstructor::benchmark(); });
+
+    auto* watcher = new QFutureWatcher<XFdkReconstructor::Result>(this);
+    connect(watcher, &QFutureWatcher<XFdkReconstructor::Result>::finished, this,
+            [this, watcher]()
+            {
+                const XFdkReconstructor::Result result = watcher->result();
+                watcher->deleteLater();
+                updateStatusText(result.summary());
+                if (result.ok)
+                    emit xSignaHelper.signalShowSuccessMessageBar("重建性能测试完成，结果已写入日志");
+                else
+                    emit xSignaHelper.signalShowErrorMessageBar(result.summary());
+            });
+    watcher->setFuture(future);
+}
+
+void MainWindow::onMenuTomosynthesis()
+{
+    qDebug() << "[MainWindow] Menu: Tomosynthesis";
+
+    // 以当前图像列表（多帧 DR 采集结果或打开的图像文件夹）作为各摆角位置的投影
+    const QList<QImage> frames = _XGraphicsView->getSrcU16ImageList();
+    if (frames.size() < 2)
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("请先进行多帧DR采集或打开图像文件夹，至少需要 2 帧");
+        return;
+    }
+
+    updateStatusText(QString("正在进行断层合成重建，共 %1 帧...").arg(frames.size()));
+    const XTomosynthesis::Options options = XTomosynthesis::Options::fromConfig();
+    auto future = QtConcurrent::run([frames, options]() { return XTomosynthesis::reconstruct(frames, options); });
+
+    auto* watcher = new QFutureWatcher<XTomosynthesis::Result>(this);
+    connect(watcher, &QFutureWatcher<XTomosynthesis::Result>::finished, this,
+            [this, watcher]()
+            {
+                const XTomosynthesis::Result result = watcher->result();
+                watcher->deleteLater();
+                updateStatusText(result.summary());
+                if (result.ok)
+                {
+                    _XGraphicsView->clearROIRect();
+                    _XGraphicsView->setImageList(result.planes);
+                    emit xSignaHelper.signalShowSuccessMessageBar("断层合成完成，可拖动图像索引浏览各焦平面");
+                }
+                else
+                {
+                    emit xSignaHelper.signalShowErrorMessageBar(result.summary());
+                }
+            });
+    watcher->setFuture(future);
+}
+
+void MainWindow::onMenuStitchImages()
+{
+    qDebug() << "[MainWindow] Menu: Stitch images";
+
+    const QString inputFolder =
+        QFileDialog::getExistingDirectory(this, "选择拼接图像文件夹（按文件名顺序为拍摄顺序）", QDir::homePath());
+    if (inputFolder.isEmpty())
+        return;
+
+    const QFileInfoList files = listImageFiles(inputFolder);
+    if (files.size() < 2)
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("拼接至少需要 2 张图像（支持 .raw / .tif / .tiff）");
+        return;
+    }
+    const QString outputDir =
+        QFileDialog::getExistingDirectory(this, "选择拼接结果保存文件夹", QFileInfo(inputFolder).absolutePath());
+    if (outputDir.isEmpty())
+        return;
+
+    XImageStitcher::Options options = XImageStitcher::Options::fromConfig();
+    if (containsRawFile(files) && !askRawImageSize(options.rawWidth, options.rawHeight))
+        return;
+
+    QStringList paths;
+    for (const QFileInfo& info : files)
+        paths.append(info.absoluteFilePath());
+
+    updateStatusText(QString("正在拼接 %1 张图像...").arg(paths.size()));
+    auto future = QtConcurrent::run(
+        [paths, outputDir, options]()
+        {
+            return XImageStitcher::stitch(paths, outputDir, options,
+                                          [](int percent, const QString& stage)
+                                          {
+                                              emit xSignaHelper.signalUpdateStatusInfo(
+                                                  QString("图像拼接 %1% - %2").arg(percent).arg(stage));
+                                              return true;
+                                          });
+        });
+
+    auto* watcher = new QFutureWatcher<XImageStitcher::Result>(this);
+    connect(watcher, &QFutureWatcher<XImageStitcher::Result>::finished, this,
+            [this, watcher]()
+            {
+                const XImageStitcher::Result result = watcher->result();
+                watcher->deleteLater();
+                updateStatusText(result.summary());
+                if (result.ok)
+                {
+                    // 完整拼接图只写入文件，界面显示抽点预览
+                    _XGraphicsView->clearROIRect();
+                    _XGraphicsView->setImageList({result.preview});
+                    emit xSignaHelper.signalShowSuccessMessageBar(
+                        QString("拼接完成: %1").arg(QFileInfo(result.mosaicPath).fileName()));
+                }
+                else
+                {
+                    emit xSignaHelper.signalShowErrorMessageBar(result.summary());
+                }
+            });
+    watcher->setFuture(future);
+}
+
+void MainWindow::onMenuStackBenchmark()
+{
+    qDebug() << "[MainWindow] Menu: Stacking benchmark";
+
+    updateStatusText("正在进行叠加性能测试...");
+    auto future = QtConcurrent::run([]() { return XImageStacker::benchmark(); });
+
+    auto* watcher = new QFutureWatcher<QVector<XImageStacker::BenchmarkRow>>(this);
+    connect(watcher, &QFutureWatcher<QVector<XImageStacker::BenchmarkRow>>::finished, this,
+            [this, watcher]()
+            {
+                const QVector<XImageStacker::BenchmarkRow> rows = watcher->result();
+                watcher->deleteLater();
+                if (rows.isEmpty())
+                {
+                    emit xSignaHelper.signalShowErrorMessageBar("叠加性能测试失败");
+                    return;
+                }
+                const XImageStacker::BenchmarkRow& last = rows.last();
+                updateStatusText(QString("叠加性能测试 N=%1: 平均 %2 ms, 中值 %3 ms, 裁剪平均 %4 ms")
+                                     .arg(last.frames)
+                                     .arg(last.meanMs, 0, 'f', 1)
+                                     .arg(last.medianMs, 0, 'f', 1)
+                                     .arg(last.sigmaClipMs, 0, 'f', 1));
+                emit xSignaHelper.signalShowSuccessMessageBar("叠加性能测试完成，结果已写入日志");
+            });
+    watcher->setFuture(future);
+}
+
 // ============================================================================
 // Menu and Toolbar Initialization
 // ============================================================================
@@ -492,6 +958,7 @@ void MainWindow::initMenuBar()
     connect(fileMenu->addAction("打开图像文件"), &QAction::triggered, this, &MainWindow::onMenuFileOpen);
     connect(fileMenu->addAction("打开图像文件夹"), &QAction::triggered, this, &MainWindow::onMenuFileOpenFolder);
     connect(fileMenu->addAction("保存图像"), &QAction::triggered, this, &MainWindow::onMenuFileSave);
+    connect(fileMenu->addAction("多图拼接..."), &QAction::triggered, this, &MainWindow::onMenuStitchImages);
     fileMenu->addSeparator();
     connect(fileMenu->addAction("退出程序"), &QAction::triggered, this, &MainWindow::onMenuFileExit);
 
@@ -503,6 +970,69 @@ void MainWindow::initMenuBar()
         connect(configMenu->addAction("探测器设置"), &QAction::triggered, this, &MainWindow::onMenuDetectorConfig);
     }
     connect(configMenu->addAction("探测器校正"), &QAction::triggered, this, &MainWindow::onMenuDetectorCalibration);
+    if (xGlobal.getBool("TEST", "XRAY_EMULATOR_ENABLE"))
+    {
+        connect(configMenu->addAction("射线源通信测试"), &QAction::triggered, this, &MainWindow::onMenuXRayBenchmark);
+    }
+
+    ElaMenu* stackMenu = configMenu->addMenu("叠加方式");
+    QActionGroup* stackMethodGroup = new QActionGroup(this);
+    const XImageStacker::Method currentMethod = XImageStacker::Options::fromConfig().method;
+    const QList<QPair<XImageStacker::Method, QString>> stackMethods = {
+        {XImageStacker::Method::Mean, "mean"},
+        {XImageStacker::Method::Median, "median"},
+        {XImageStacker::Method::SigmaClip, "sigma"}};
+    for (const auto& entry : stackMethods)
+    {
+        QAction* action = stackMenu->addAction(XImageStacker::methodName(entry.first));
+        action->setCheckable(true);
+        action->setChecked(entry.first == currentMethod);
+        stackMethodGroup->addAction(action);
+        const QString key = entry.second;
+        connect(action, &QAction::triggered, this, [key]() { xGlobal.setString("SYSTEM", "STACK_METHOD", key); });
+    }
+    stackMenu->addSeparator();
+    connect(stackMenu->addAction("叠加性能测试"), &QAction::triggered, this, &MainWindow::onMenuStackBenchmark);
+    QAction* adaptiveStackAction = configMenu->addAction("按信噪比自适应叠加");
+    adaptiveStackAction->setCheckable(true);
+    adaptiveStackAction->setChecked(xGlobal.getBool("SYSTEM", "STACK_ADAPTIVE"));
+    connect(adaptiveStackAction, &QAction::toggled, this,
+            [](bool checked) { xGlobal.setBool("SYSTEM", "STACK_ADAPTIVE", checked); });
+    QAction* registrationAction = configMenu->addAction("叠加前配准");
+    registrationAction->setCheckable(true);
+    registrationAction->setChecked(xGlobal.getBool("SYSTEM", "STACK_REGISTRATION"));
+    connect(registrationAction, &QAction::toggled, this,
+            [](bool checked) { xGlobal.setBool("SYSTEM", "STACK_REGISTRATION", checked); });
+
+    // 下次开始采集时生效
+    QAction* shmAction = configMenu->addAction("共享内存发布叠加帧");
+    shmAction->setCheckable(true);
+    shmAction->setChecked(xGlobal.getBool("SHM", "SHM_ENABLE"));
+    connect(shmAction, &QAction::toggled, this, [](bool checked) { xGlobal.setBool("SHM", "SHM_ENABLE", checked); });
+
+    ElaMenu* softCorrectionMenu = configMenu->addMenu("软件校正");
+    QAction* softCorrectionAction = softCorrectionMenu->addAction("实时采集启用软件校正");
+    softCorrectionAction->setCheckable(true);
+    softCorrectionAction->setChecked(xGlobal.getBool("CORRECTION", "SOFT_CORRECTION_ENABLE"));
+    connect(softCorrectionAction, &QAction::toggled, this, &MainWindow::onMenuSoftCorrectionToggled);
+    QAction* defectCorrectionAction = softCorrectionMenu->addAction("实时采集启用坏点修复");
+    defectCorrectionAction->setCheckable(true);
+    defectCorrectionAction->setChecked(xGlobal.getBool("CORRECTION", "DEFECT_CORRECTION_ENABLE"));
+    connect(defectCorrectionAction, &QAction::toggled, this,
+            [](bool checked) { xGlobal.setBool("CORRECTION", "DEFECT_CORRECTION_ENABLE", checked); });
+    softCorrectionMenu->addSeparator();
+    connect(softCorrectionMenu->addAction("生成校正模板"), &QAction::triggered, this,
+            &MainWindow::onMenuSoftCorrectionTemplate);
+    connect(softCorrectionMenu->addAction("校正当前图像"), &QAction::triggered, this,
+            &MainWindow::onMenuSoftCorrectCurrentImage);
+    connect(softCorrectionMenu->addAction("批量校正图像文件夹"), &QAction::triggered, this,
+            &MainWindow::onMenuSoftCorrectFolder);
+
+    ElaMenu* ctMenu = menuBar->addMenu("CT");
+    connect(ctMenu->addAction("CT重建..."), &QAction::triggered, this, &MainWindow::onMenuCtReconstruct);
+    connect(ctMenu->addAction("重建性能测试"), &QAction::triggered, this, &MainWindow::onMenuReconBenchmark);
+    ctMenu->addSeparator();
+    connect(ctMenu->addAction("断层合成重建"), &QAction::triggered, this, &MainWindow::onMenuTomosynthesis);
 
     ElaMenu* helpMenu = menuBar->addMenu("帮助");
     connect(helpMenu->addAction("清理日志"), &QAction::triggered, this, &MainWindow::onMenuCleanupLogs);
@@ -576,6 +1106,16 @@ void MainWindow::initToolBar()
     toolButtonDRMulti->setToolTip("多张采集");
     toolBar->addWidget(toolButtonDRMulti);
 
+    toolButtonHDR = new ElaToolButton(this);
+    toolButtonHDR->setElaIcon(ElaIconType::CircleHalfStroke);
+    toolButtonHDR->setToolTip("HDR多能量采集");
+    toolBar->addWidget(toolButtonHDR);
+
+    toolButtonCT = new ElaToolButton(this);
+    toolButtonCT->setElaIcon(ElaIconType::Rotate);
+    toolButtonCT->setToolTip("CT扫描");
+    toolBar->addWidget(toolButtonCT);
+
     toolButtonStopDR = new ElaToolButton(this);
     toolButtonStopDR->setElaIcon(ElaIconType::Pause);
     toolButtonStopDR->setToolTip("停止");
@@ -592,7 +1132,9 @@ void MainWindow::initToolBar()
 
     connect(toolButtonDR, &ElaToolButton::clicked, this, &MainWindow::onDROnceTimeBtnClicked);
     connect(toolButtonDRMulti, &ElaToolButton::clicked, this, &MainWindow::onDRMutliBtnClicked);
+    connect(toolButtonHDR, &ElaToolButton::clicked, this, &MainWindow::onDRHdrBtnClicked);
     connect(toolButtonRealTimeDR, &ElaToolButton::clicked, this, &MainWindow::onDRRealTimeBtnClicked);
+    connect(toolButtonCT, &ElaToolButton::clicked, this, &MainWindow::onCTBtnClicked);
     connect(toolButtonStopDR, &ElaToolButton::clicked, this, &MainWindow::onDRStopBtnClicked);
 
     addToolBar(Qt::TopToolBarArea, toolBar);
@@ -616,16 +1158,18 @@ void MainWindow::onAcqStarted(const AcqCondition& acqCond)
     // Disable acquisition buttons
     toolButtonDR->setEnabled(false);
     toolButtonDRMulti->setEnabled(false);
+    toolButtonHDR->setEnabled(false);
     toolButtonRealTimeDR->setEnabled(false);
+    toolButtonCT->setEnabled(false);
 
     // Clear previous data
     _XGraphicsView->clearROIRect();
     _XGraphicsView->clearCurrentImageList();
 
     // Configure image index slider based on acquisition type
-    if (acqCond.frame == 1 || acqCond.frame == INT_MAX)
+    if (acqCond.frame == 1 || acqCond.frame == INT_MAX || acqCond.acqType == AcqType::CT)
     {
-        // Single frame or continuous acquisition: disable index slider
+        // Single frame, continuous or CT acquisition: disable index slider
         _XImageAdjustTool->updateIdxRange(0);
     }
     else
@@ -634,6 +1178,7 @@ void MainWindow::onAcqStarted(const AcqCondition& acqCond)
         _XImageAdjustTool->updateIdxRange(acqCond.frame);
     }
 
+    _frameRateText->setText("");
     updateStatusText("开始采集");
 }
 
@@ -649,7 +1194,9 @@ void MainWindow::onAcqStopped()
     // Re-enable acquisition buttons
     toolButtonDR->setEnabled(true);
     toolButtonDRMulti->setEnabled(true);
+    toolButtonHDR->setEnabled(true);
     toolButtonRealTimeDR->setEnabled(true);
+    toolButtonCT->setEnabled(true);
 
     // Check if X-ray source should be turned off
     onXRayStopRequested();
@@ -674,7 +1221,11 @@ void MainWindow::onAacqTaskFrameStacked(AcqCondition condition, int frameIdx, QI
     {
         _XGraphicsView->updateImage(stackedImage);
 
-        if (condition.frame == 1)
+        if (condition.hdr)
+        {
+            updateStatusText("HDR融合完成");
+        }
+        else if (condition.frame == 1)
         {
             updateStatusText("单张采集结束");
         }
@@ -688,6 +1239,15 @@ void MainWindow::onAacqTaskFrameStacked(AcqCondition condition, int frameIdx, QI
             updateStatusText(QString("多张DR采集，当前接收帧数：%1，共 %2 帧").arg(frameIdx + 1).arg(condition.frame));
         }
     }
+    else if (condition.acqType == AcqType::CT)
+    {
+        // CT 投影直接写入投影文件，这里只做抽样预览
+        _XGraphicsView->updateImage(stackedImage);
+        updateStatusText(QString("CT扫描，当前投影：%1，共 %2 张，角度 %3°")
+                             .arg(frameIdx + 1)
+                             .arg(condition.frame)
+                             .arg(condition.startAngle + frameIdx * condition.angleStep, 0, 'f', 2));
+    }
 }
 
 void MainWindow::onDROnceTimeBtnClicked()
@@ -718,6 +1278,12 @@ void MainWindow::onDRMutliBtnClicked()
         return;
     }
 
+    if (!_CommonConfigUI->checkInputValid())
+    {
+        qDebug() << "[MainWindow] Input validation failed";
+        return;
+    }
+
     AcqCondition acqCond = _CommonConfigUI->getAcqCondition();
     acqCond.acqType = AcqType::DR;
 
@@ -727,12 +1293,35 @@ void MainWindow::onDRMutliBtnClicked()
         qDebug() << "[MainWindow] Failed to get multi-frame config:" << acqCond;
         return;
     }
+    AcqTaskManager::Instance().updateAcqCond(acqCond);
+    AcqTaskManager::Instance().startAcq();
+    onAcqStarted(acqCond);
+}
+
+void MainWindow::onDRHdrBtnClicked()
+{
+    qDebug() << "[MainWindow] DR HDR acquisition requested";
+
+    const XHdrFusion::Options hdrOptions = XHdrFusion::Options::fromConfig();
+    if (hdrOptions.bracket.size() < 2)
+    {
+        emit xSignaHelper.signalShowErrorMessageBar("请在配置文件 [HDR] HDR_BRACKET 中设置至少两档 kV:uA");
+        return;
+    }
 
     if (!_CommonConfigUI->checkInputValid())
     {
         qDebug() << "[MainWindow] Input validation failed";
         return;
     }
+
+    // 电压 / 电流由档位决定，射线由采集流程逐档开启
+    AcqCondition acqCond = _CommonConfigUI->getAcqCondition();
+    acqCond.acqType = AcqType::DR;
+    acqCond.frame = 1;
+    acqCond.hdr = true;
+    acqCond.autoXRay = true;
+    qDebug() << "[MainWindow] HDR bracket:" << XHdrFusion::formatBracket(hdrOptions.bracket);
     AcqTaskManager::Instance().updateAcqCond(acqCond);
     AcqTaskManager::Instance().startAcq();
     onAcqStarted(acqCond);
@@ -756,6 +1345,43 @@ void MainWindow::onDRRealTimeBtnClicked()
     onAcqStarted(acqCond);
 }
 
+void MainWindow::onCTBtnClicked()
+{
+    qDebug() << "[MainWindow] CT scan requested";
+
+    bool ok = false;
+    const int projections = QInputDialog::getInt(this, "CT扫描", "请输入投影数量:",
+                                                 xGlobal.getInt("CT", "CT_PROJECTIONS", 360), 2, 10000, 1, &ok);
+    if (!ok)
+        return;
+
+    const QString savePath = QFileDialog::getExistingDirectory(
+        this, "选择投影文件保存文件夹", xGlobal.getString("CT", "CT_SAVE_PATH", QDir::homePath()));
+    if (savePath.isEmpty())
+        return;
+
+    if (!_CommonConfigUI->checkInputValid())
+    {
+        qDebug() << "[MainWindow] Input validation failed";
+        return;
+    }
+
+    xGlobal.setInt("CT", "CT_PROJECTIONS", projections);
+    xGlobal.setString("CT", "CT_SAVE_PATH", savePath);
+
+    AcqCondition acqCond = _CommonConfigUI->getAcqCondition();
+    acqCond.acqType = AcqType::CT;
+    acqCond.frame = projections;
+    acqCond.saveToFiles = true;
+    acqCond.savePath = savePath;
+    acqCond.saveType = ".XPRJ";
+    acqCond.startAngle = xGlobal.getDouble("CT", "CT_START_ANGLE", 0.0);
+    acqCond.angleStep = xGlobal.getDouble("CT", "CT_SCAN_RANGE", 360.0) / projections;
+    AcqTaskManager::Instance().updateAcqCond(acqCond);
+    AcqTaskManager::Instance().startAcq();
+    onAcqStarted(acqCond);
+}
+
 void MainWindow::onDRStopBtnClicked()
 {
     qDebug() << "[MainWindow] DR stop requested";
@@ -778,8 +1404,25 @@ void MainWindow::connectToXRay()
     qDebug() << "[MainWindow] Connecting to X-ray source";
     emit xSignaHelper.signalUpdateStatusInfo("开始连接射线源");
 
-    bool connected = xRaySource.connectToSource(xGlobal.getString("XRAY", "XRAY_DEVICE_IP"),
-                                                xGlobal.getInt("XRAY", "XRAY_DEVICE_PORT"));
+    QString host = xGlobal.getString("XRAY", "XRAY_DEVICE_IP");
+    quint16 port = xGlobal.getInt("XRAY", "XRAY_DEVICE_PORT");
+
+    // 测试模式：连接本地模拟器代替真实射线源
+    if (xGlobal.getBool("TEST", "XRAY_EMULATOR_ENABLE"))
+    {
+        if (!_xraySourceEmulator)
+        {
+            _xraySourceEmulator = new XRaySourceEmulator();
+        }
+        if (_xraySourceEmulator->start(xGlobal.getInt("TEST", "XRAY_EMULATOR_PORT", 0)))
+        {
+            host = "127.0.0.1";
+            port = _xraySourceEmulator->port();
+            qDebug() << "[MainWindow] Using X-ray source emulator on port" << port;
+        }
+    }
+
+    bool connected = xRaySource.connectToSource(host, port);
     if (connected)
     {
         emit xSignaHelper.signalShowSuccessMessageBar("射线源已连接!");
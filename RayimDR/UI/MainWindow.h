@@ -14,6 +14,7 @@ class CommonConfigUI;
 
 class XGraphicsView;
 class XImageAdjustTool;
+class XRaySourceEmulator;
 
 class MainWindow : public ElaWindow
 {
@@ -31,7 +32,9 @@ public:
 
     void onDROnceTimeBtnClicked();
     void onDRMutliBtnClicked();
+    void onDRHdrBtnClicked();
     void onDRRealTimeBtnClicked();
+    void onCTBtnClicked();
     void onDRStopBtnClicked();
 
 private:
@@ -59,6 +62,17 @@ private:
     void onMenuOpenLogDir();
     void onMenuOpenCfg();
     void onMenuOpenHelpFile();
+    void onMenuSoftCorrectionToggled(bool checked);
+    void onMenuSoftCorrectionTemplate();
+    void onMenuSoftCorrectCurrentImage();
+    void onMenuSoftCorrectFolder();
+    bool askRawImageSize(int& width, int& height);
+    void onMenuXRayBenchmark();
+    void onMenuCtReconstruct();
+    void onMenuReconBenchmark();
+    void onMenuTomosynthesis();
+    void onMenuStackBenchmark();
+    void onMenuStitchImages();
 
     // Close event handlers
     void onCloseButtonClicked();
@@ -77,12 +91,15 @@ private:
 private:
     ElaContentDialog* _closeDialog{nullptr};
     ElaText* _statusText{nullptr};
+    ElaText* _frameRateText{nullptr};
 
     CommonConfigUI* _CommonConfigUI{nullptr};
 
     XGraphicsView* _XGraphicsView{nullptr};
     XImageAdjustTool* _XImageAdjustTool{nullptr};
 
+    XRaySourceEmulator* _xraySourceEmulator{nullptr};
+
     ElaToolButton* toolButtonImport{nullptr};
     ElaToolButton* toolButtonOpenFolder{nullptr};
     ElaToolButton* toolButtonSaveFile{nullptr};
@@ -94,6 +111,8 @@ private:
     ElaToolButton* toolButtonDR{nullptr};
     ElaToolButton* toolButtonRealTimeDR{nullptr};
     ElaToolButton* toolButtonDRMulti{nullptr};
+    ElaToolButton* toolButtonHDR{nullptr};
+    ElaToolButton* toolButtonCT{nullptr};
     ElaToolButton* toolButtonStopDR{nullptr};
     bool _detectorDisconnectDialogShown{false};
 };
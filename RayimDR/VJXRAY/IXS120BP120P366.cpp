@@ -1,8 +1,12 @@
 #include "IXS120BP120P366.h"
 #include <QDebug>
 #include <QMetaObject>
+#include <QPromise>
+
+#include <cmath>
 
 #include "TcpClient.h"
+#include "XRayCommandChannel.h"
 #include "../Components/XGlobal.h"
 
 #pragma warning(disable : 4996)  // disable deprecated function warning
@@ -34,6 +38,16 @@ const std::string CMD_STAT = "STAT";        // X-ray is on or off
 // Protocol parameters
 constexpr int DEFAULT_TIMEOUT = 3000;       // milliseconds
 constexpr int STATUS_QUERY_TIMEOUT = 3000;  // milliseconds
+
+template <typename T>
+QFuture<T> readyFuture(const T& value)
+{
+    QPromise<T> promise;
+    promise.start();
+    promise.addResult(value);
+    promise.finish();
+    return promise.future();
+}
 }  // namespace
 
 // ============================================================================
@@ -41,12 +55,10 @@ constexpr int STATUS_QUERY_TIMEOUT = 3000;  // milliseconds
 // ============================================================================
 
 IXS120BP120P366::IXS120BP120P366(QObject* parent)
-    : QObject(parent),
-      m_tcpClient(nullptr),
-      m_connected(false),
-      m_statusQueryTimer(nullptr),
-      m_statusQueryEnabled(false)
+    : QObject(parent), m_tcpClient(nullptr), m_connected(false), m_statusQueryTimer(nullptr)
 {
+    m_clock.start();
+
     qDebug() << "[IXS120BP120P366] Initializing - Main thread:" << QThread::currentThread();
 
     // Start worker thread
@@ -66,6 +78,9 @@ IXS120BP120P366::IXS120BP120P366(QObject* parent)
             // Create TCP client and status query timer
             m_tcpClient = new TcpClient();
             m_statusQueryTimer = new QTimer();
+            m_statusQueryTimer->setSingleShot(true);
+            m_channel = new XRayCommandChannel(m_tcpClient, this);
+            m_channel->setPipelineDepth(xGlobal.getInt("XRAY", "XRAY_PIPELINE_DEPTH", 4));
 
             // Connect signals (same thread, no connection type needed)
             connect(m_tcpClient, &TcpClient::connected, this, &IXS120BP120P366::onTcpConnected);
@@ -96,6 +111,11 @@ IXS120BP120P366::~IXS120BP120P366()
             }
             m_statusQueryEnabled = false;
 
+            if (m_channel)
+            {
+                m_channel->cancelAll();
+            }
+
             // Disconnect from host
             if (m_tcpClient && m_tcpClient->isConnected())
             {
@@ -178,6 +198,42 @@ bool IXS120BP120P366::isConnected() const
 }
 
 bool IXS120BP120P366::setVoltage(int kV)
+{
+    return waitResult(setVoltageAsync(kV), false);
+}
+
+bool IXS120BP120P366::setCurrent(int uA)
+{
+    return waitResult(setCurrentAsync(uA), false);
+}
+
+bool IXS120BP120P366::startXRay()
+{
+    return waitResult(startXRayAsync(), false);
+}
+
+bool IXS120BP120P366::stopXRay()
+{
+    return waitResult(stopXRayAsync(), false);
+}
+
+void IXS120BP120P366::clearErr()
+{
+    // 结果只记录日志，无需等待
+    clearErrAsync();
+}
+
+bool IXS120BP120P366::xRayIsOn()
+{
+    return waitResult(xRayIsOnAsync(), false);
+}
+
+int IXS120BP120P366::getPTST()
+{
+    return waitResult(getPTSTAsync(), 0);
+}
+
+QFuture<bool> IXS120BP120P366::setVoltageAsync(int kV)
 {
     // Validate voltage range: 30.0 - 120.0 kV
     if (kV < xGlobal.getInt("XRAY", "XRAY_MIN_VOLTAGE") || kV > xGlobal.getInt("XRAY", "XRAY_MAX_VOLTAGE"))
@@ -185,45 +241,37 @@ bool IXS120BP120P366::setVoltage(int kV)
         qDebug() << "[SetVoltage] Invalid voltage:" << kV
                  << "kV (valid range:" << xGlobal.getInt("XRAY", "XRAY_MIN_VOLTAGE") << "-"
                  << xGlobal.getInt("XRAY", "XRAY_MAX_VOLTAGE") << "kV)";
-        return false;
+        return readyFuture(false);
     }
 
-    bool result = false;
-    QMetaObject::invokeMethod(
-        this,
-        [this, kV, &result]()
-        {
-            // Format: "xxxx" representing xxx.x kV (e.g., "0300" = 30.0 kV)
-            char voltageStr[5];
-            snprintf(voltageStr, sizeof(voltageStr), "%03d%1d", kV, 0);
-            std::string paramStr(voltageStr);
-
-            // Build command: STX + VP + parameter + CR
-            std::string cmd = CMD_PREFIX + CMD_SET_VOLTAGE + paramStr + CMD_SUFFIX;
-            QByteArray cmdData = QByteArray::fromStdString(cmd);
+    // Format: "xxxx" representing xxx.x kV (e.g., "0300" = 30.0 kV)
+    char voltageStr[5];
+    snprintf(voltageStr, sizeof(voltageStr), "%03d%1d", kV, 0);
+    std::string paramStr(voltageStr);
 
-            qDebug() << "[SetVoltage] Setting to" << kV << "kV - Command:" << cmdData;
-
-            QByteArray response =
-                m_tcpClient->sendDataSyncWithEndMarker(cmdData, QByteArray::fromStdString(CMD_SUFFIX), DEFAULT_TIMEOUT);
-
-            if (!response.isEmpty())
-            {
-                qDebug() << "[SetVoltage] Success - Voltage set to" << kV << "kV";
-                result = true;
-            }
-            else
-            {
-                qDebug() << "[SetVoltage] Failed - No response from X-ray source";
-                result = false;
-            }
-        },
-        Qt::BlockingQueuedConnection);
+    // Build command: STX + VP + parameter + CR
+    std::string cmd = CMD_PREFIX + CMD_SET_VOLTAGE + paramStr + CMD_SUFFIX;
+    QByteArray cmdData = QByteArray::fromStdString(cmd);
 
-    return result;
+    qDebug() << "[SetVoltage] Setting to" << kV << "kV - Command:" << cmdData;
+    m_targetVoltage = kV;
+    requestFastPoll();
+
+    return m_channel->submit(cmdData, XRayCommandChannel::Priority::Control, DEFAULT_TIMEOUT)
+        .then(this,
+              [kV](const QByteArray& response)
+              {
+                  if (response.isEmpty())
+                  {
+                      qDebug() << "[SetVoltage] Failed - No response from X-ray source";
+                      return false;
+                  }
+                  qDebug() << "[SetVoltage] Success - Voltage set to" << kV << "kV";
+                  return true;
+              });
 }
 
-bool IXS120BP120P366::setCurrent(int uA)
+QFuture<bool> IXS120BP120P366::setCurrentAsync(int uA)
 {
     // Validate current range: 0.2000 - 1.0000 mA (200 - 1000 uA)
     if (uA < xGlobal.getInt("XRAY", "XRAY_MIN_CURRENT") || uA > xGlobal.getInt("XRAY", "XRAY_MAX_CURRENT"))
@@ -231,181 +279,160 @@ bool IXS120BP120P366::setCurrent(int uA)
         qDebug() << "[SetCurrent] Invalid current:" << uA
                  << "uA (valid range:" << xGlobal.getInt("XRAY", "XRAY_MIN_CURRENT") << "-"
                  << xGlobal.getInt("XRAY", "XRAY_MAX_CURRENT") << "uA)";
-        return false;
+        return readyFuture(false);
     }
 
-    bool result = false;
-    QMetaObject::invokeMethod(
-        this,
-        [this, uA, &result]()
-        {
-            // Format: "xxxxx" representing x.xxxx mA (e.g., "02000" = 0.2000 mA = 200 uA)
-            char currentStr[6];
-            snprintf(currentStr, sizeof(currentStr), "%05d", uA * 10);
-            std::string paramStr(currentStr);
-
-            // Build command: STX + CP + parameter + CR
-            std::string cmd = CMD_PREFIX + CMD_SET_CURRENT + paramStr + CMD_SUFFIX;
-            QByteArray cmdData = QByteArray::fromStdString(cmd);
+    // Format: "xxxxx" representing x.xxxx mA (e.g., "02000" = 0.2000 mA = 200 uA)
+    char currentStr[6];
+    snprintf(currentStr, sizeof(currentStr), "%05d", uA * 10);
+    std::string paramStr(currentStr);
 
-            qDebug() << "[SetCurrent] Setting to" << uA << "uA - Command:" << cmdData;
-
-            QByteArray response =
-                m_tcpClient->sendDataSyncWithEndMarker(cmdData, QByteArray::fromStdString(CMD_SUFFIX), DEFAULT_TIMEOUT);
-
-            if (!response.isEmpty())
-            {
-                qDebug() << "[SetCurrent] Success - Current set to" << uA << "uA";
-                result = true;
-            }
-            else
-            {
-                qDebug() << "[SetCurrent] Failed - No response from X-ray source";
-                result = false;
-            }
-        },
-        Qt::BlockingQueuedConnection);
+    // Build command: STX + CP + parameter + CR
+    std::string cmd = CMD_PREFIX + CMD_SET_CURRENT + paramStr + CMD_SUFFIX;
+    QByteArray cmdData = QByteArray::fromStdString(cmd);
 
-    return result;
+    qDebug() << "[SetCurrent] Setting to" << uA << "uA - Command:" << cmdData;
+    m_targetCurrent = uA;
+    requestFastPoll();
+
+    return m_channel->submit(cmdData, XRayCommandChannel::Priority::Control, DEFAULT_TIMEOUT)
+        .then(this,
+              [uA](const QByteArray& response)
+              {
+                  if (response.isEmpty())
+                  {
+                      qDebug() << "[SetCurrent] Failed - No response from X-ray source";
+                      return false;
+                  }
+                  qDebug() << "[SetCurrent] Success - Current set to" << uA << "uA";
+                  return true;
+              });
 }
 
-bool IXS120BP120P366::startXRay()
+QFuture<bool> IXS120BP120P366::startXRayAsync()
 {
     qDebug() << "[StartXRay] Enabling X-ray emission";
 
-    bool result = false;
-    QMetaObject::invokeMethod(
-        this,
-        [this, &result]()
-        {
-            // Build command: STX + ENBL1 + CR
-            std::string cmd = CMD_PREFIX + CMD_STARTXRAY + CMD_SUFFIX;
-            QByteArray cmdData = QByteArray::fromStdString(cmd);
-
-            QByteArray response =
-                m_tcpClient->sendDataSyncWithEndMarker(cmdData, QByteArray::fromStdString(CMD_SUFFIX), DEFAULT_TIMEOUT);
-
-            if (!response.isEmpty())
-            {
-                qDebug() << "[StartXRay] Success - X-ray emission enabled";
-                result = true;
-            }
-            else
-            {
-                qDebug() << "[StartXRay] Failed - No response from X-ray source";
-                result = false;
-            }
-            if (result)
-            {
-                emit xrayStarted();
-            }
-        },
-        Qt::BlockingQueuedConnection);
-
-    return result;
+    // Build command: STX + ENBL1 + CR
+    std::string cmd = CMD_PREFIX + CMD_STARTXRAY + CMD_SUFFIX;
+    QByteArray cmdData = QByteArray::fromStdString(cmd);
+    requestFastPoll();
+
+    return m_channel->submit(cmdData, XRayCommandChannel::Priority::Control, DEFAULT_TIMEOUT)
+        .then(this,
+              [this](const QByteArray& response)
+              {
+                  if (response.isEmpty())
+                  {
+                      qDebug() << "[StartXRay] Failed - No response from X-ray source";
+                      return false;
+                  }
+                  qDebug() << "[StartXRay] Success - X-ray emission enabled";
+                  m_emitting = true;
+                  emit xrayStarted();
+                  return true;
+              });
 }
 
-bool IXS120BP120P366::stopXRay()
+QFuture<bool> IXS120BP120P366::stopXRayAsync()
 {
     qDebug() << "[StopXRay] Disabling X-ray emission";
 
-    bool result = false;
-    QMetaObject::invokeMethod(
-        this,
-        [this, &result]()
-        {
-            // Build command: STX + ENBL0 + CR
-            std::string cmd = CMD_PREFIX + CMD_STOPXRAY + CMD_SUFFIX;
-            QByteArray cmdData = QByteArray::fromStdString(cmd);
-
-            QByteArray response =
-                m_tcpClient->sendDataSyncWithEndMarker(cmdData, QByteArray::fromStdString(CMD_SUFFIX), DEFAULT_TIMEOUT);
-
-            if (!response.isEmpty())
-            {
-                qDebug() << "[StopXRay] Success - X-ray emission disabled";
-                result = true;
-            }
-            else
-            {
-                qDebug() << "[StopXRay] Failed - No response from X-ray source";
-                result = false;
-            }
-            if (result)
-            {
-                emit xrayStopped();
-            }
-        },
-        Qt::BlockingQueuedConnection);
-
-    return result;
+    // Build command: STX + ENBL0 + CR
+    std::string cmd = CMD_PREFIX + CMD_STOPXRAY + CMD_SUFFIX;
+    QByteArray cmdData = QByteArray::fromStdString(cmd);
+    requestFastPoll();
+
+    return m_channel->submit(cmdData, XRayCommandChannel::Priority::Control, DEFAULT_TIMEOUT)
+        .then(this,
+              [this](const QByteArray& response)
+              {
+                  if (response.isEmpty())
+                  {
+                      qDebug() << "[StopXRay] Failed - No response from X-ray source";
+                      return false;
+                  }
+                  qDebug() << "[StopXRay] Success - X-ray emission disabled";
+                  m_emitting = false;
+                  emit xrayStopped();
+                  return true;
+              });
 }
 
-void IXS120BP120P366::clearErr()
+QFuture<bool> IXS120BP120P366::clearErrAsync()
 {
     qDebug() << "[ClearError] Clearing X-ray source error state";
 
-    QMetaObject::invokeMethod(
-        this,
-        [this]()
-        {
-            // Build command: STX + CLR + CR
-            std::string cmd = CMD_PREFIX + CMD_CLR + CMD_SUFFIX;
-            QByteArray cmdData = QByteArray::fromStdString(cmd);
-
-            QByteArray response =
-                m_tcpClient->sendDataSyncWithEndMarker(cmdData, QByteArray::fromStdString(CMD_SUFFIX), DEFAULT_TIMEOUT);
+    // Build command: STX + CLR + CR
+    std::string cmd = CMD_PREFIX + CMD_CLR + CMD_SUFFIX;
+    QByteArray cmdData = QByteArray::fromStdString(cmd);
 
-            if (!response.isEmpty())
-            {
-                qDebug() << "[ClearError] Success - Error state cleared";
-            }
-            else
-            {
-                qDebug() << "[ClearError] Failed - No response from X-ray source";
-            }
-        },
-        Qt::BlockingQueuedConnection);
+    return m_channel->submit(cmdData, XRayCommandChannel::Priority::Control, DEFAULT_TIMEOUT)
+        .then(this,
+              [](const QByteArray& response)
+              {
+                  if (response.isEmpty())
+                  {
+                      qDebug() << "[ClearError] Failed - No response from X-ray source";
+                      return false;
+                  }
+                  qDebug() << "[ClearError] Success - Error state cleared";
+                  return true;
+              });
 }
 
-bool IXS120BP120P366::xRayIsOn()
+QFuture<bool> IXS120BP120P366::xRayIsOnAsync()
 {
     qDebug() << "Querying STAT";
 
-    QByteArray response;
-    QMetaObject::invokeMethod(
-        this,
-        [this, &response]()
-        {
-            // Build command: STX + STAT + CR
-            std::string cmd = CMD_PREFIX + CMD_STAT + CMD_SUFFIX;
-            QByteArray cmdData = QByteArray::fromStdString(cmd);
+    // Build command: STX + STAT + CR
+    std::string cmd = CMD_PREFIX + CMD_STAT + CMD_SUFFIX;
+    QByteArray cmdData = QByteArray::fromStdString(cmd);
 
-            response =
-                m_tcpClient->sendDataSyncWithEndMarker(cmdData, QByteArray::fromStdString(CMD_SUFFIX), DEFAULT_TIMEOUT);
+    return m_channel->submit(cmdData, XRayCommandChannel::Priority::Control, DEFAULT_TIMEOUT)
+        .then(this,
+              [](const QByteArray& response)
+              {
+                  if (response.size() < 3)
+                  {
+                      qDebug() << "Invalid response format";
+                      return false;
+                  }
+
+                  // Remove STX and CR
+                  QByteArray actualData = response.mid(1, response.size() - 2);
+                  QString responseStr = QString::fromUtf8(actualData);
+                  int on = responseStr.toInt();
+                  return on == 1;
+              });
+}
 
-            if (!response.isEmpty())
-            {
-                qDebug() << "Received response:" << response;
-            }
-            else
-            {
-                qDebug() << "Failed - No response from X-ray source";
-            }
-        },
-        Qt::BlockingQueuedConnection);
+QFuture<int> IXS120BP120P366::getPTSTAsync()
+{
+    qDebug() << "[GetPTST] Querying pre-warmup time";
 
-    if (response.size() < 3)
-    {
-        qDebug() << "Invalid response format";
-        return 0;
-    }
+    // Build command: STX + PTST + CR
+    std::string cmd = CMD_PREFIX + CMD_PTST + CMD_SUFFIX;
+    QByteArray cmdData = QByteArray::fromStdString(cmd);
 
-    // Remove STX and CR
-    QByteArray actualData = response.mid(1, response.size() - 2);
-    QString responseStr = QString::fromUtf8(actualData);
-    int on = responseStr.toInt();
-    return on == 1;
+    return m_channel->submit(cmdData, XRayCommandChannel::Priority::Control, DEFAULT_TIMEOUT)
+        .then(this,
+              [](const QByteArray& response)
+              {
+                  if (response.size() < 3)
+                  {
+                      qDebug() << "[GetPTST] Invalid response format";
+                      return 0;
+                  }
+
+                  // Remove STX and CR
+                  QByteArray actualData = response.mid(1, response.size() - 2);
+                  QString responseStr = QString::fromUtf8(actualData);
+                  int ptst = responseStr.toInt();
+
+                  qDebug() << "[GetPTST] Pre-warmup time:" << ptst << "seconds";
+                  return ptst;
+              });
 }
 
 void IXS120BP120P366::setIsPreheat(bool preheat)
@@ -418,70 +445,44 @@ bool IXS120BP120P366::isPreheat() const
     return m_isPreheat;
 }
 
-int IXS120BP120P366::getPTST()
+QByteArray IXS120BP120P366::sendDataSyncWithEndMarker(const QByteArray& data, const QByteArray& endMarker, int timeout)
 {
-    qDebug() << "[GetPTST] Querying pre-warmup time";
-
-    QByteArray response;
-    QMetaObject::invokeMethod(
-        this,
-        [this, &response]()
-        {
-            // Build command: STX + PTST + CR
-            std::string cmd = CMD_PREFIX + CMD_PTST + CMD_SUFFIX;
-            QByteArray cmdData = QByteArray::fromStdString(cmd);
-
-            response =
-                m_tcpClient->sendDataSyncWithEndMarker(cmdData, QByteArray::fromStdString(CMD_SUFFIX), DEFAULT_TIMEOUT);
-
-            if (!response.isEmpty())
-            {
-                qDebug() << "[GetPTST] Received response:" << response;
-            }
-            else
-            {
-                qDebug() << "[GetPTST] Failed - No response from X-ray source";
-            }
-        },
-        Qt::BlockingQueuedConnection);
-
-    if (response.size() < 3)
+    // 命令通道固定按 CR 分帧
+    if (endMarker != QByteArray::fromStdString(CMD_SUFFIX))
     {
-        qDebug() << "[GetPTST] Invalid response format";
-        return 0;
+        qDebug() << "[SendData] Unsupported end marker:" << endMarker.toHex();
+        return QByteArray();
     }
 
-    // Remove STX and CR
-    QByteArray actualData = response.mid(1, response.size() - 2);
-    QString responseStr = QString::fromUtf8(actualData);
-    int ptst = responseStr.toInt();
-
-    qDebug() << "[GetPTST] Pre-warmup time:" << ptst << "seconds";
-    return ptst;
+    QByteArray response =
+        waitResult(m_channel->submit(data, XRayCommandChannel::Priority::Control, timeout), QByteArray());
+    if (!response.isEmpty())
+    {
+        qDebug() << "[SendData] Received response:" << response;
+    }
+    else
+    {
+        qDebug() << "[SendData] No response received";
+    }
+    return response;
 }
 
-QByteArray IXS120BP120P366::sendDataSyncWithEndMarker(const QByteArray& data, const QByteArray& endMarker, int timeout)
+template <typename T>
+T IXS120BP120P366::waitResult(QFuture<T> future, const T& fallback) const
 {
-    QByteArray response;
-    QMetaObject::invokeMethod(
-        this,
-        [this, data, endMarker, timeout, &response]()
-        {
-            // Forward data to TCP client (caller should have built complete command)
-            response = m_tcpClient->sendDataSyncWithEndMarker(data, endMarker, timeout);
-
-            if (!response.isEmpty())
-            {
-                qDebug() << "[SendData] Received response:" << response;
-            }
-            else
-            {
-                qDebug() << "[SendData] No response received";
-            }
-        },
-        Qt::BlockingQueuedConnection);
+    // 工作线程上等待会阻塞自身的事件循环，应答永远无法处理
+    if (QThread::currentThread() == &m_thread)
+    {
+        qDebug() << "[IXS120BP120P366] Blocking call on worker thread is not allowed, use the async API";
+        return fallback;
+    }
 
-    return response;
+    future.waitForFinished();
+    if (future.isCanceled() || future.resultCount() == 0)
+    {
+        return fallback;
+    }
+    return future.result();
 }
 
 // ============================================================================
@@ -495,7 +496,7 @@ void IXS120BP120P366::onTcpConnected()
     emit connected();
 
     // Start status query in worker thread
-    startStatusQuery(500);
+    startStatusQuery(xGlobal.getInt("XRAY", "XRAY_POLL_IDLE_MS", 1000));
 }
 
 void IXS120BP120P366::onTcpDisconnected()
@@ -505,6 +506,7 @@ void IXS120BP120P366::onTcpDisconnected()
 
     // Stop status query when disconnected
     stopStatusQuery();
+    m_channel->cancelAll();
 
     emit disconnected();
 }
@@ -522,22 +524,32 @@ void IXS120BP120P366::onTcpError(const QString& errorMsg)
 // Status Query Control
 // ============================================================================
 
-void IXS120BP120P366::startStatusQuery(int intervalMs)
+void IXS120BP120P366::startStatusQuery(int idleIntervalMs)
 {
-    qDebug() << "[StatusQuery] Starting with interval:" << intervalMs << "ms";
-
     if (!isConnected())
     {
         qDebug() << "[StatusQuery] Cannot start: not connected";
         return;
     }
 
-    QMutexLocker locker(&m_statusMutex);
+    const int fastMs = xGlobal.getInt("XRAY", "XRAY_POLL_FAST_MS", 100);
+    const int activeMs = xGlobal.getInt("XRAY", "XRAY_POLL_ACTIVE_MS", 250);
+    qDebug() << "[StatusQuery] Starting with interval fast/active/idle:" << fastMs << "/" << activeMs << "/"
+             << idleIntervalMs << "ms";
+
     m_statusQueryEnabled = true;
 
     // Start timer in worker thread
     QMetaObject::invokeMethod(
-        m_statusQueryTimer, [this, intervalMs]() { m_statusQueryTimer->start(intervalMs); }, Qt::QueuedConnection);
+        m_statusQueryTimer,
+        [this, fastMs, activeMs, idleIntervalMs]()
+        {
+            m_pollFastMs = std::max(20, fastMs);
+            m_pollActiveMs = std::max(m_pollFastMs, activeMs);
+            m_pollIdleMs = std::max(m_pollActiveMs, idleIntervalMs);
+            m_statusQueryTimer->start(0);
+        },
+        Qt::QueuedConnection);
 
     qDebug() << "[StatusQuery] Started successfully";
 }
@@ -546,7 +558,6 @@ void IXS120BP120P366::stopStatusQuery()
 {
     qDebug() << "[StatusQuery] Stopping";
 
-    QMutexLocker locker(&m_statusMutex);
     m_statusQueryEnabled = false;
 
     // Stop timer in worker thread
@@ -557,69 +568,133 @@ void IXS120BP120P366::stopStatusQuery()
 
 bool IXS120BP120P366::isStatusQueryRunning() const
 {
-    QMutexLocker locker(&m_statusMutex);
     return m_statusQueryEnabled;
 }
 
 XRaySourceStatus IXS120BP120P366::getCurrentStatus() const
 {
-    QMutexLocker locker(&m_statusMutex);
-    return m_currentStatus;
+    return m_statusSnapshot.load();
 }
 
-void IXS120BP120P366::onQueryStatus()
+int IXS120BP120P366::nextPollInterval() const
 {
-    // qDebug() << "[StatusQuery] Querying status from X-ray source";
-    if (!m_statusQueryEnabled || !isConnected())
+    if (m_clock.elapsed() < m_fastPollUntilMs.load())
     {
-        return;
+        return m_pollFastMs;
     }
 
-    // Query MON (Monitor status)
-    std::string cmd = CMD_PREFIX + CMD_MON + CMD_SUFFIX;
-    QByteArray cmdData = QByteArray::fromStdString(cmd);
-    QByteArray response =
-        m_tcpClient->sendDataSyncWithEndMarker(cmdData, QByteArray::fromStdString(CMD_SUFFIX), STATUS_QUERY_TIMEOUT);
-
-    if (!response.isEmpty())
+    const bool emitting = m_emitting.load() || m_pollStatus.voltage > 1.0;
+    if (!emitting)
     {
-        // Validate response format (STX...CR)
-        if (response.size() >= 2 && response.at(0) == 0x02 && response.at(response.size() - 1) == 0x0D)
-        {
-            // Remove STX and CR
-            QByteArray actualData = response.mid(1, response.size() - 2);
-            QString responseStr = QString::fromUtf8(actualData);
-            parseMONResponse(responseStr);
-        }
-        else
-        {
-            qDebug() << "[StatusQuery] Invalid MON response format:" << response;
-        }
+        return m_pollIdleMs;
     }
 
-    // Query FLT (Fault status)
-    cmd = CMD_PREFIX + CMD_FLT + CMD_SUFFIX;
-    cmdData = QByteArray::fromStdString(cmd);
-    response =
-        m_tcpClient->sendDataSyncWithEndMarker(cmdData, QByteArray::fromStdString(CMD_SUFFIX), STATUS_QUERY_TIMEOUT);
+    // 读数未到达设定值时视为仍在爬升
+    const bool ramping = std::abs(m_pollStatus.voltage - m_targetVoltage.load()) > 0.5 ||
+                         std::abs(m_pollStatus.current * 1000.0 - m_targetCurrent.load()) > 5.0;
+    return ramping ? m_pollFastMs : m_pollActiveMs;
+}
 
-    if (!response.isEmpty())
+void IXS120BP120P366::publishStatus()
+{
+    m_statusSnapshot.store(m_pollStatus);
+    emit statusPolled();
+
+    if (!m_hasEmittedStatus || m_pollStatus != m_lastEmittedStatus)
     {
-        // Validate response format (STX...CR)
-        if (response.size() >= 2 && response.at(0) == 0x02 && response.at(response.size() - 1) == 0x0D)
-        {
-            // Remove STX and CR
-            QByteArray actualData = response.mid(1, response.size() - 2);
-            QString responseStr = QString::fromUtf8(actualData);
-            parseFTLResponse(responseStr);
-        }
-        else
-        {
-            qDebug() << "[StatusQuery] Invalid FLT response format:" << response;
-        }
+        m_lastEmittedStatus = m_pollStatus;
+        m_hasEmittedStatus = true;
+        emit statusUpdated(m_pollStatus);
     }
+}
+
+void IXS120BP120P366::requestFastPoll()
+{
+    m_fastPollUntilMs = m_clock.elapsed() + 2000;
+
+    // 当前排定的下一次轮询较晚时提前
+    QMetaObject::invokeMethod(
+        this,
+        [this]()
+        {
+            if (m_statusQueryEnabled && !m_statusQueryPending && m_statusQueryTimer->isActive() &&
+                m_statusQueryTimer->remainingTime() > m_pollFastMs)
+            {
+                m_statusQueryTimer->start(m_pollFastMs);
+            }
+        },
+        Qt::QueuedConnection);
+}
 
-    emit statusUpdated(m_currentStatus);
+void IXS120BP120P366::onQueryStatus()
+{
+    // qDebug() << "[StatusQuery] Querying status from X-ray source";
+    // 上一轮查询未完成时跳过，避免状态查询在队列中堆积
+    if (!m_statusQueryEnabled || !isConnected() || m_statusQueryPending)
+    {
+        return;
+    }
+    m_statusQueryPending = true;
+
+    // MON 与 FLT 作为一批提交，以较低优先级与控制命令共享通道，合并为一次写入
+    const QList<QByteArray> frames = {QByteArray::fromStdString(CMD_PREFIX + CMD_MON + CMD_SUFFIX),
+                                      QByteArray::fromStdString(CMD_PREFIX + CMD_FLT + CMD_SUFFIX)};
+    const QList<QFuture<QByteArray>> futures =
+        m_channel->submitBatch(frames, XRayCommandChannel::Priority::Status, STATUS_QUERY_TIMEOUT);
+    QFuture<QByteArray> monFuture = futures.at(0);
+    QFuture<QByteArray> fltFuture = futures.at(1);
+
+    monFuture.then(this,
+                   [this](const QByteArray& response)
+                   {
+                       if (response.isEmpty())
+                       {
+                           return;
+                       }
+
+                       // Validate response format (STX...CR)
+                       if (response.size() >= 2 && response.at(0) == 0x02 && response.at(response.size() - 1) == 0x0D)
+                       {
+                           // Remove STX and CR
+                           QByteArray actualData = response.mid(1, response.size() - 2);
+                           QString responseStr = QString::fromUtf8(actualData);
+                           parseMONResponse(responseStr);
+                       }
+                       else
+                       {
+                           qDebug() << "[StatusQuery] Invalid MON response format:" << response;
+                       }
+                   });
+
+    // 同优先级命令按提交顺序完成，FLT 完成时 MON 已解析
+    fltFuture.then(this,
+                   [this](const QByteArray& response)
+                   {
+                       m_statusQueryPending = false;
+
+                       if (!response.isEmpty())
+                       {
+                           // Validate response format (STX...CR)
+                           if (response.size() >= 2 && response.at(0) == 0x02 &&
+                               response.at(response.size() - 1) == 0x0D)
+                           {
+                               // Remove STX and CR
+                               QByteArray actualData = response.mid(1, response.size() - 2);
+                               QString responseStr = QString::fromUtf8(actualData);
+                               parseFTLResponse(responseStr);
+                           }
+                           else
+                           {
+                               qDebug() << "[StatusQuery] Invalid FLT response format:" << response;
+                           }
+                       }
+
+                       publishStatus();
+                       if (m_statusQueryEnabled)
+                       {
+                           m_statusQueryTimer->start(nextPollInterval());
+                       }
+                   });
 }
 
 // ============================================================================
@@ -648,38 +723,38 @@ void IXS120BP120P366::parseMONResponse(const QString& response)
     int voltageRaw = parts[0].toInt(&ok);
     if (ok)
     {
-        m_currentStatus.voltage = voltageRaw / 10.0;
+        m_pollStatus.voltage = voltageRaw / 10.0;
     }
     else
     {
         qDebug() << "[ParseMON] Failed to parse voltage:" << parts[0];
-        m_currentStatus.voltage = 0.0;
+        m_pollStatus.voltage = 0.0;
     }
 
     // Parse current (mA) - format: ccccc, divide by 10000 to get c.cccc
     int currentRaw = parts[1].toInt(&ok);
     if (ok)
     {
-        m_currentStatus.current = currentRaw / 10000.0;
+        m_pollStatus.current = currentRaw / 10000.0;
     }
     else
     {
         qDebug() << "[ParseMON] Failed to parse current:" << parts[1];
-        m_currentStatus.current = 0.0;
+        m_pollStatus.current = 0.0;
     }
 
     // Parse temperature (°C) - format: tttt, divide by 10 to get ttt.t
     int tempRaw = parts[2].toInt(&ok);
     if (ok)
     {
-        m_currentStatus.temperature = tempRaw / 10.0;
+        m_pollStatus.temperature = tempRaw / 10.0;
     }
 
     // Parse filament current (A) - format: ffff, divide by 1000 to get f.fff
     int filamentRaw = parts[3].toInt(&ok);
     if (ok)
     {
-        m_currentStatus.filamentCurrent = filamentRaw / 1000.0;
+        m_pollStatus.filamentCurrent = filamentRaw / 1000.0;
     }
 
     // Parse bias voltage (VDC) - format: bbbb, divide by 100 to get bb.bb
@@ -689,7 +764,7 @@ void IXS120BP120P366::parseMONResponse(const QString& response)
     {
         vdc = vdcRaw / 100.0;
     }
-    m_currentStatus.vdc = vdc;
+    m_pollStatus.vdc = vdc;
 }
 
 void IXS120BP120P366::parseFTLResponse(const QString& response)
@@ -711,7 +786,7 @@ void IXS120BP120P366::parseFTLResponse(const QString& response)
     bool stateChanged = false;
 
     // 解析当前的故障位
-    std::vector<int> currentFaultBits(11, 0);
+    std::array<int, 11> currentFaultBits{};
     for (int i = 0; i < 11; ++i)
     {
         int bit = parts[i].toInt(&ok);
@@ -728,35 +803,26 @@ void IXS120BP120P366::parseFTLResponse(const QString& response)
     }
 
     // 比较当前状态与上一次状态是否一致
-    if (m_currentStatus.faultBits.size() == currentFaultBits.size())
+    if (m_hasFaultBits)
     {
-        for (size_t i = 0; i < currentFaultBits.size(); ++i)
-        {
-            if (m_currentStatus.faultBits[i] != currentFaultBits[i])
-            {
-                stateChanged = true;
-                break;
-            }
-        }
+        stateChanged = m_pollStatus.faultBits != currentFaultBits;
     }
     else
     {
-        // 首次初始化或大小不匹配，视为状态变化
+        // 首次初始化，视为状态变化
         stateChanged = true;
     }
+    m_hasFaultBits = true;
 
     // 只有在状态发生变化且存在错误时才触发 anyFault
     bool anyFault = stateChanged && hasError;
 
     // 更新当前状态
-    m_currentStatus.faultBits = currentFaultBits;
+    m_pollStatus.faultBits = currentFaultBits;
 
     // Update specific status fields based on fault bits
     // Note: Bit 8 is assumed to be interlock status (verify with device manual)
-    if (currentFaultBits.size() > 8)
-    {
-        m_currentStatus.interlock = currentFaultBits[8];
-    }
+    m_pollStatus.interlock = currentFaultBits[8];
 
     // Log detailed fault information for debugging (only when fault state changes and has errors)
     if (anyFault)
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+
 #include <QObject>
 #include <QString>
 #include <QThread>
@@ -7,19 +10,32 @@
 #include <QWaitCondition>
 #include <QEventLoop>
 #include <QTimer>
+#include <QFuture>
+#include <QElapsedTimer>
+
+#include "../Components/XSeqLock.h"
 
 class TcpClient;
+class XRayCommandChannel;
 
 // X-ray source status structure
 struct XRaySourceStatus
 {
-    double voltage;          // Current voltage in kV
-    double current;          // Current in uA
-    double temperature;      // Temperature in Celsius
-    double filamentCurrent;  // Filament current in A
-    double vdc;              // kVoltage in VDC
-    std::vector<int> faultBits;
-    int interlock;  // Interlock status
+    double voltage{0.0};          // Current voltage in kV
+    double current{0.0};          // Current in mA
+    double temperature{0.0};      // Temperature in Celsius
+    double filamentCurrent{0.0};  // Filament current in A
+    double vdc{0.0};              // kVoltage in VDC
+    std::array<int, 11> faultBits{};
+    int interlock{0};  // Interlock status
+
+    bool operator==(const XRaySourceStatus& other) const
+    {
+        return voltage == other.voltage && current == other.current && temperature == other.temperature &&
+               filamentCurrent == other.filamentCurrent && vdc == other.vdc && faultBits == other.faultBits &&
+               interlock == other.interlock;
+    }
+    bool operator!=(const XRaySourceStatus& other) const { return !(*this == other); }
 };
 
 #define xRaySource IXS120BP120P366::Instance()
@@ -43,6 +59,7 @@ public:
     void disconnectFromSource();
     bool isConnected() const;
 
+    // 同步接口：等待应答后返回，不能在射线源工作线程中调用
     bool setVoltage(int kV);
     bool setCurrent(int uA);
     bool startXRay();
@@ -54,12 +71,23 @@ public:
 
     int getPTST();
 
+    // 异步接口：立即返回，命令经通道排队流水线发送，结果在射线源工作线程中完成
+    QFuture<bool> setVoltageAsync(int kV);
+    QFuture<bool> setCurrentAsync(int uA);
+    QFuture<bool> startXRayAsync();
+    QFuture<bool> stopXRayAsync();
+    QFuture<bool> clearErrAsync();
+    QFuture<bool> xRayIsOnAsync();
+    QFuture<int> getPTSTAsync();
+
     QByteArray sendDataSyncWithEndMarker(const QByteArray& data, const QByteArray& endMarker, int timeout = 5000);
 
     // Status query control
-    void startStatusQuery(int intervalMs = 1000);
+    // 自适应轮询：爬升中或刚下发控制命令时按快速间隔，出束稳定时按中等间隔，空闲时按 idleIntervalMs
+    void startStatusQuery(int idleIntervalMs = 1000);
     void stopStatusQuery();
     bool isStatusQueryRunning() const;
+    // 无锁读取最近一次轮询得到的状态，可在任意线程调用
     XRaySourceStatus getCurrentStatus() const;
 
 signals:
@@ -67,7 +95,10 @@ signals:
     void disconnected();
     void xrayError(const QString& errorMsg);
     void xrayErrorCleared();  // 错误已清除信号
+    // 仅在状态发生变化时发出
     void statusUpdated(const XRaySourceStatus& status);
+    // 每次轮询完成时发出（无论状态是否变化）
+    void statusPolled();
     void xrayStarted();
     void xrayStopped();
 
@@ -81,14 +112,37 @@ private:
     void parseMONResponse(const QString& response);
     void parseFTLResponse(const QString& response);
 
+    template <typename T>
+    T waitResult(QFuture<T> future, const T& fallback) const;
+
+    int nextPollInterval() const;
+    void publishStatus();
+    // 控制命令下发后短时间内加快轮询，尽快反映爬升过程
+    void requestFastPoll();
+
 private:
     TcpClient* m_tcpClient{nullptr};
+    XRayCommandChannel* m_channel{nullptr};
     bool m_connected;
     QThread m_thread;
     // Status query
     QTimer* m_statusQueryTimer{nullptr};
-    XRaySourceStatus m_currentStatus;
-    mutable QMutex m_statusMutex;
-    bool m_statusQueryEnabled{false};
+    std::atomic_bool m_statusQueryEnabled{false};
+    bool m_statusQueryPending{false};
+    int m_pollFastMs{100};
+    int m_pollActiveMs{250};
+    int m_pollIdleMs{1000};
+    QElapsedTimer m_clock;
+    std::atomic<qint64> m_fastPollUntilMs{0};
+    std::atomic_int m_targetVoltage{0};  // kV
+    std::atomic_int m_targetCurrent{0};  // uA
+    std::atomic_bool m_emitting{false};
+
+    // 轮询工作副本仅在工作线程访问，解析完成后发布到无锁快照
+    XRaySourceStatus m_pollStatus;
+    XRaySourceStatus m_lastEmittedStatus;
+    bool m_hasEmittedStatus{false};
+    bool m_hasFaultBits{false};
+    XSeqLock<XRaySourceStatus> m_statusSnapshot;
     bool m_isPreheat{false};
 };
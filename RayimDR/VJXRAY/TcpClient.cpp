@@ -4,6 +4,8 @@
 #include <QTcpSocket>
 #include <QThread>
 
+#include "XFrameParser.h"
+
 TcpClient::TcpClient(QObject* parent) : QObject(parent), m_socket(nullptr)
 {
     qDebug() << "Initializing TcpClient in thread:" << QThread::currentThread();
@@ -14,6 +16,7 @@ TcpClient::TcpClient(QObject* parent) : QObject(parent), m_socket(nullptr)
     connect(m_socket, &QTcpSocket::connected, this, &TcpClient::onConnected);
     connect(m_socket, &QTcpSocket::disconnected, this, &TcpClient::onDisconnected);
     connect(m_socket, &QTcpSocket::errorOccurred, this, &TcpClient::onError);
+    connect(m_socket, &QTcpSocket::readyRead, this, &TcpClient::onReadyRead);
 
     qDebug() << "TcpClient initialized, socket thread:" << m_socket->thread();
 }
@@ -72,6 +75,12 @@ QByteArray TcpClient::sendDataSync(const QByteArray& data, int timeout)
         return QByteArray();
     }
 
+    if (m_asyncMode)
+    {
+        qDebug() << "Cannot send data synchronously in async mode";
+        return QByteArray();
+    }
+
     // 清空接收缓冲区
     m_socket->readAll();
 
@@ -148,6 +157,12 @@ QByteArray TcpClient::sendDataSyncWithLength(const QByteArray& data, int expecte
         return QByteArray();
     }
 
+    if (m_asyncMode)
+    {
+        qDebug() << "Cannot send data synchronously in async mode";
+        return QByteArray();
+    }
+
     // 清空接收缓冲区
     m_socket->readAll();
 
@@ -207,6 +222,12 @@ QByteArray TcpClient::sendDataSyncWithEndMarker(const QByteArray& data, const QB
         return QByteArray();
     }
 
+    if (m_asyncMode)
+    {
+        qDebug() << "Cannot send data synchronously in async mode";
+        return QByteArray();
+    }
+
     // 清空接收缓冲区
     m_socket->readAll();
 
@@ -256,6 +277,48 @@ QByteArray TcpClient::sendDataSyncWithEndMarker(const QByteArray& data, const QB
     return response;
 }
 
+void TcpClient::setAsyncMode(bool enable)
+{
+    m_asyncMode = enable;
+}
+
+bool TcpClient::isAsyncMode() const
+{
+    return m_asyncMode;
+}
+
+void TcpClient::enableFraming(char startByte, char endByte, int maxFrameSize)
+{
+    m_frameParser = std::make_unique<XFrameParser>(startByte, endByte, 4096, maxFrameSize);
+}
+
+void TcpClient::clearReceiveBuffer()
+{
+    if (m_frameParser)
+    {
+        m_frameParser->reset();
+    }
+}
+
+bool TcpClient::sendData(const QByteArray& data)
+{
+    if (!isConnected())
+    {
+        qDebug() << "Cannot send data: not connected";
+        return false;
+    }
+
+    qint64 written = m_socket->write(data);
+    if (written == -1)
+    {
+        qDebug() << "Failed to write data";
+        return false;
+    }
+
+    m_socket->flush();
+    return true;
+}
+
 void TcpClient::onConnected()
 {
     qDebug() << "Connected to host";
@@ -274,3 +337,44 @@ void TcpClient::onError()
     qDebug() << "Error occurred:" << errorMsg;
     emit error(errorMsg);
 }
+
+void TcpClient::onReadyRead()
+{
+    if (!m_asyncMode)
+    {
+        // 同步接口通过 waitForReadyRead 自行读取
+        return;
+    }
+
+    if (!m_frameParser)
+    {
+        emit dataReceived(m_socket->readAll());
+        return;
+    }
+
+    while (m_socket->bytesAvailable() > 0)
+    {
+        qsizetype available = 0;
+        char* buffer = m_frameParser->writePointer(available);
+        if (!buffer)
+        {
+            // 缓冲区被无帧尾的数据占满，丢弃后重新同步
+            qDebug() << "Frame buffer overflow, discarding" << m_frameParser->bufferedBytes() << "bytes";
+            m_frameParser->reset();
+            continue;
+        }
+
+        qint64 read = m_socket->read(buffer, available);
+        if (read <= 0)
+        {
+            break;
+        }
+        m_frameParser->commit(read);
+
+        QByteArrayView frame;
+        while (m_frameParser->next(frame))
+        {
+            emit frameReceived(frame);
+        }
+    }
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <memory>
+
 #include <QObject>
+#include <QByteArrayView>
 
 class QTcpSocket;
+class XFrameParser;
 
 class TcpClient : public QObject
 {
@@ -32,16 +36,34 @@ public:
     // timeout: 等待响应的超时时间(毫秒)
     QByteArray sendDataSyncWithEndMarker(const QByteArray& data, const QByteArray& endMarker, int timeout = 5000);
 
+    // 异步模式：收到数据即通过 dataReceived 发出，由上层自行分帧；此模式下同步接口不可用
+    void setAsyncMode(bool enable);
+    bool isAsyncMode() const;
+
+    // 异步模式下启用 startByte ... endByte 分帧，数据直接读入环形缓冲区，完整帧通过 frameReceived 发出
+    void enableFraming(char startByte, char endByte, int maxFrameSize = 256);
+    // 丢弃已接收但未成帧的数据
+    void clearReceiveBuffer();
+
+    // 仅发送，不等待响应
+    bool sendData(const QByteArray& data);
+
 signals:
     void connected();
     void disconnected();
     void error(const QString& errorMsg);
+    void dataReceived(const QByteArray& data);
+    // frame 指向内部缓冲区，仅在槽函数执行期间有效，只能以直接连接方式接收
+    void frameReceived(QByteArrayView frame);
 
 private slots:
     void onConnected();
     void onDisconnected();
     void onError();
+    void onReadyRead();
 
 private:
     QTcpSocket* m_socket;
+    bool m_asyncMode{false};
+    std::unique_ptr<XFrameParser> m_frameParser;
 };
@@ -0,0 +1,130 @@
+#include "XFrameParser.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <QtMath>
+
+XFrameParser::XFrameParser(char startByte, char endByte, int capacity, int maxFrameSize)
+    : m_startByte(startByte), m_endByte(endByte), m_maxFrameSize(std::max(2, maxFrameSize))
+{
+    const qsizetype ringSize = qNextPowerOfTwo(quint32(std::max<qsizetype>(capacity, m_maxFrameSize * 2) - 1));
+    m_ring.resize(ringSize);
+    m_scratch.resize(m_maxFrameSize);
+    m_mask = ringSize - 1;
+}
+
+char* XFrameParser::writePointer(qsizetype& available)
+{
+    const qsizetype capacity = static_cast<qsizetype>(m_ring.size());
+    if (m_size >= capacity)
+    {
+        available = 0;
+        return nullptr;
+    }
+
+    const qsizetype tail = (m_head + m_size) & m_mask;
+    // 尾部之后到环尾或到头部之间的连续空闲区
+    available = tail >= m_head ? capacity - tail : m_head - tail;
+    return m_ring.data() + tail;
+}
+
+void XFrameParser::commit(qsizetype written)
+{
+    m_size = std::min<qsizetype>(m_size + written, static_cast<qsizetype>(m_ring.size()));
+}
+
+bool XFrameParser::next(QByteArrayView& frame)
+{
+    while (m_scanned < m_size)
+    {
+        const char c = at(m_scanned);
+
+        if (!m_inFrame)
+        {
+            if (c == m_startByte)
+            {
+                // 丢弃帧头之前的残留字节
+                m_droppedBytes += m_scanned;
+                discard(m_scanned);
+                m_inFrame = true;
+                m_scanned = 1;
+            }
+            else
+            {
+                ++m_scanned;
+            }
+            continue;
+        }
+
+        if (c == m_endByte)
+        {
+            const qsizetype length = m_scanned + 1;
+            frame = frameView(length);
+            discard(length);
+            m_inFrame = false;
+            m_scanned = 0;
+            return true;
+        }
+
+        if (c == m_startByte)
+        {
+            // 上一帧未结束又出现帧头，按截断帧丢弃
+            m_droppedBytes += m_scanned;
+            discard(m_scanned);
+            m_scanned = 1;
+            continue;
+        }
+
+        ++m_scanned;
+        if (m_scanned >= m_maxFrameSize)
+        {
+            m_droppedBytes += m_scanned;
+            discard(m_scanned);
+            m_inFrame = false;
+            m_scanned = 0;
+        }
+    }
+
+    // 没有帧头的数据不再需要保留
+    if (!m_inFrame && m_scanned > 0)
+    {
+        m_droppedBytes += m_scanned;
+        discard(m_scanned);
+        m_scanned = 0;
+    }
+    return false;
+}
+
+void XFrameParser::reset()
+{
+    m_head = 0;
+    m_size = 0;
+    m_scanned = 0;
+    m_inFrame = false;
+}
+
+void XFrameParser::discard(qsizetype count)
+{
+    m_head = (m_head + count) & m_mask;
+    m_size -= count;
+    if (m_size == 0)
+    {
+        // 缓冲区为空时回到起点，尽量让后续帧保持连续
+        m_head = 0;
+    }
+}
+
+QByteArrayView XFrameParser::frameView(qsizetype length)
+{
+    const qsizetype capacity = static_cast<qsizetype>(m_ring.size());
+    if (m_head + length <= capacity)
+    {
+        return QByteArrayView(m_ring.data() + m_head, length);
+    }
+
+    const qsizetype first = capacity - m_head;
+    std::memcpy(m_scratch.data(), m_ring.data() + m_head, first);
+    std::memcpy(m_scratch.data() + first, m_ring.data(), length - first);
+    return QByteArrayView(m_scratch.data(), length);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include <QByteArrayView>
+
+/**
+ * @brief 基于环形缓冲区的增量帧解析器（STX ... END）
+ *
+ * 套接字数据直接读入环形缓冲区（writePointer/commit），next() 从上次扫描位置继续查找帧尾，
+ * 每个字节只扫描一次。完整帧以 QByteArrayView 返回：帧在缓冲区内连续时直接指向缓冲区，
+ * 跨越环尾时拷贝到预分配的暂存区，整个过程不做堆分配。
+ *
+ * - 帧头之前的字节、超过 maxFrameSize 仍未结束的帧会被丢弃并计入 droppedBytes()
+ * - 返回的 view 在下一次 writePointer()/commit()/reset() 之前有效
+ * - 非线程安全，应与所属套接字在同一线程使用
+ */
+class XFrameParser
+{
+public:
+    // capacity 会向上取整为 2 的幂
+    XFrameParser(char startByte, char endByte, int capacity = 4096, int maxFrameSize = 256);
+
+    // 返回环形缓冲区中可连续写入的区域，available 为其长度；缓冲区已满时返回 nullptr
+    char* writePointer(qsizetype& available);
+    void commit(qsizetype written);
+
+    // 取出下一个完整帧（含帧头帧尾），没有完整帧时返回 false
+    bool next(QByteArrayView& frame);
+
+    void reset();
+
+    qsizetype bufferedBytes() const { return m_size; }
+    quint64 droppedBytes() const { return m_droppedBytes; }
+
+private:
+    char at(qsizetype offset) const { return m_ring[(m_head + offset) & m_mask]; }
+    void discard(qsizetype count);
+    QByteArrayView frameView(qsizetype length);
+
+    const char m_startByte;
+    const char m_endByte;
+    const qsizetype m_maxFrameSize;
+
+    std::vector<char> m_ring;
+    std::vector<char> m_scratch;
+    qsizetype m_mask{0};
+    qsizetype m_head{0};     // 未消费数据的起始位置
+    qsizetype m_size{0};     // 未消费数据的长度
+    qsizetype m_scanned{0};  // 已扫描的长度（相对 m_head）
+    bool m_inFrame{false};   // m_head 处是否为帧头
+    quint64 m_droppedBytes{0};
+};
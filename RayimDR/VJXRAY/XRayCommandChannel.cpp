@@ -0,0 +1,241 @@
+#include "XRayCommandChannel.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <QDebug>
+#include <QMetaObject>
+#include <QTimer>
+
+#include "TcpClient.h"
+
+namespace
+{
+constexpr char FRAME_STX = 0x02;
+constexpr char FRAME_END = 0x0D;
+}  // namespace
+
+XRayCommandChannel::XRayCommandChannel(TcpClient* client, QObject* parent) : QObject(parent), m_client(client)
+{
+    m_timeoutTimer = new QTimer(this);
+    m_timeoutTimer->setSingleShot(true);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &XRayCommandChannel::onTimeout);
+
+    // 帧视图只在发射期间有效，必须直接连接
+    connect(m_client, &TcpClient::frameReceived, this, &XRayCommandChannel::onFrameReceived, Qt::DirectConnection);
+    m_client->setAsyncMode(true);
+    m_client->enableFraming(FRAME_STX, FRAME_END);
+}
+
+XRayCommandChannel::~XRayCommandChannel()
+{
+    cancelAll();
+}
+
+QFuture<QByteArray> XRayCommandChannel::submit(const QByteArray& frame, Priority priority, int timeoutMs)
+{
+    return submitBatch({frame}, priority, timeoutMs).front();
+}
+
+QList<QFuture<QByteArray>> XRayCommandChannel::submitBatch(const QList<QByteArray>& frames, Priority priority,
+                                                           int timeoutMs)
+{
+    QList<QFuture<QByteArray>> futures;
+    futures.reserve(frames.size());
+
+    std::vector<Request> requests;
+    requests.reserve(frames.size());
+    for (const QByteArray& frame : frames)
+    {
+        requests.push_back(makeRequest(frame, timeoutMs));
+        futures.append(requests.back().promise->future());
+    }
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        auto& queue = m_queues[static_cast<int>(priority)];
+        for (auto& request : requests)
+        {
+            queue.push_back(std::move(request));
+        }
+    }
+
+    // 统一在工作线程发送，调用方不阻塞
+    QMetaObject::invokeMethod(this, [this]() { pump(); }, Qt::QueuedConnection);
+    return futures;
+}
+
+XRayCommandChannel::Request XRayCommandChannel::makeRequest(const QByteArray& frame, int timeoutMs)
+{
+    Request request;
+    request.frame = frame;
+    request.timeoutMs = timeoutMs;
+    request.promise = std::make_shared<QPromise<QByteArray>>();
+    request.promise->start();
+    return request;
+}
+
+void XRayCommandChannel::setPipelineDepth(int depth)
+{
+    QMutexLocker locker(&m_queueMutex);
+    m_pipelineDepth = std::max(1, depth);
+}
+
+int XRayCommandChannel::pipelineDepth() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_pipelineDepth;
+}
+
+int XRayCommandChannel::pendingCount() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return static_cast<int>(m_queues[0].size() + m_queues[1].size()) + m_inFlightCount.load();
+}
+
+void XRayCommandChannel::cancelAll()
+{
+    failInFlight();
+
+    std::deque<Request> pending[2];
+    {
+        QMutexLocker locker(&m_queueMutex);
+        pending[0].swap(m_queues[0]);
+        pending[1].swap(m_queues[1]);
+    }
+    for (auto& queue : pending)
+    {
+        for (auto& request : queue)
+        {
+            finish(request, QByteArray());
+        }
+    }
+}
+
+void XRayCommandChannel::pump()
+{
+    if (!m_client->isConnected())
+    {
+        cancelAll();
+        return;
+    }
+
+    // 本轮可发送的命令合并为一次写入
+    QByteArray outgoing;
+    const size_t firstNew = m_inFlight.size();
+
+    while (true)
+    {
+        Request request;
+        {
+            QMutexLocker locker(&m_queueMutex);
+            if (static_cast<int>(m_inFlight.size()) >= m_pipelineDepth)
+            {
+                break;
+            }
+
+            auto& queue = m_queues[0].empty() ? m_queues[1] : m_queues[0];
+            if (queue.empty())
+            {
+                break;
+            }
+            request = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        outgoing.append(request.frame);
+        request.sentTimer.start();
+        m_inFlight.push_back(std::move(request));
+    }
+
+    if (!outgoing.isEmpty() && !m_client->sendData(outgoing))
+    {
+        qDebug() << "[XRayChannel] Failed to send" << (m_inFlight.size() - firstNew) << "command(s)";
+        while (m_inFlight.size() > firstNew)
+        {
+            finish(m_inFlight.back(), QByteArray());
+            m_inFlight.pop_back();
+        }
+    }
+    m_inFlightCount.store(static_cast<int>(m_inFlight.size()));
+
+    armTimeout();
+}
+
+void XRayCommandChannel::onFrameReceived(QByteArrayView frame)
+{
+    if (m_inFlight.empty())
+    {
+        qDebug() << "[XRayChannel] Unexpected response dropped:" << frame.toByteArray();
+        return;
+    }
+
+    Request request = std::move(m_inFlight.front());
+    m_inFlight.pop_front();
+    m_inFlightCount.store(static_cast<int>(m_inFlight.size()));
+    finish(request, frame.toByteArray());
+
+    pump();
+}
+
+void XRayCommandChannel::onTimeout()
+{
+    if (m_inFlight.empty())
+    {
+        return;
+    }
+
+    auto expired = std::find_if(m_inFlight.begin(), m_inFlight.end(), [](const Request& request)
+                                { return request.sentTimer.elapsed() >= request.timeoutMs; });
+    if (expired == m_inFlight.end())
+    {
+        armTimeout();
+        return;
+    }
+
+    // 应答只按顺序匹配，某条命令超时后后续应答的对应关系已不可信
+    qDebug() << "[XRayChannel] Command timed out after" << expired->timeoutMs << "ms:" << expired->frame;
+    emit commandTimedOut(expired->frame);
+
+    failInFlight();
+    m_client->clearReceiveBuffer();
+    pump();
+}
+
+void XRayCommandChannel::finish(Request& request, const QByteArray& response)
+{
+    if (request.promise)
+    {
+        request.promise->addResult(response);
+        request.promise->finish();
+        request.promise.reset();
+    }
+}
+
+void XRayCommandChannel::failInFlight()
+{
+    std::deque<Request> inFlight;
+    inFlight.swap(m_inFlight);
+    m_inFlightCount.store(0);
+    for (auto& request : inFlight)
+    {
+        finish(request, QByteArray());
+    }
+}
+
+void XRayCommandChannel::armTimeout()
+{
+    if (m_inFlight.empty())
+    {
+        m_timeoutTimer->stop();
+        return;
+    }
+
+    qint64 remaining = std::numeric_limits<qint64>::max();
+    for (const auto& request : m_inFlight)
+    {
+        remaining = std::min(remaining, request.timeoutMs - request.sentTimer.elapsed());
+    }
+    m_timeoutTimer->start(static_cast<int>(std::max<qint64>(0, remaining)));
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+
+#include <QObject>
+#include <QByteArray>
+#include <QFuture>
+#include <QPromise>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QList>
+
+class TcpClient;
+class QTimer;
+
+/**
+ * @brief 射线源命令通道：优先级队列 + 流水线发送 + 按 STX/CR 分帧应答
+ *
+ * 射线源协议为一问一答（STX + 命令 + CR），应答按发送顺序返回。通道把调用方提交的命令放入队列，
+ * 在工作线程中最多保持 pipelineDepth 条在途命令，收到一帧应答即完成最早的在途命令并立即发送下一条，
+ * 因此设电压、设电流、开射线可以连续下发，不再逐条等待完整往返。
+ *
+ * - 控制命令优先于状态查询出队，状态轮询不会推迟控制命令
+ * - 同一轮可发送的命令合并为一次套接字写入
+ * - 每条命令单独计时，超时后在途命令的应答顺序已不可信，全部按失败处理
+ * - submit() 可在任意线程调用，返回的 QFuture 以完整应答帧（含 STX/CR）完成，失败时为空
+ */
+class XRayCommandChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Priority
+    {
+        Control = 0,
+        Status = 1,
+    };
+
+    // client 必须与通道位于同一线程
+    explicit XRayCommandChannel(TcpClient* client, QObject* parent = nullptr);
+    ~XRayCommandChannel();
+
+    // frame 为完整命令帧 STX + 命令 + CR
+    QFuture<QByteArray> submit(const QByteArray& frame, Priority priority = Priority::Control, int timeoutMs = 3000);
+    // 一批命令在队列中保持相邻，中间不会插入其他命令
+    QList<QFuture<QByteArray>> submitBatch(const QList<QByteArray>& frames, Priority priority = Priority::Control,
+                                           int timeoutMs = 3000);
+
+    void setPipelineDepth(int depth);
+    int pipelineDepth() const;
+    // 队列中和在途的命令数
+    int pendingCount() const;
+
+    // 以失败结束所有排队和在途的命令，用于断开连接
+    void cancelAll();
+
+signals:
+    void commandTimedOut(const QByteArray& frame);
+
+private slots:
+    void onFrameReceived(QByteArrayView frame);
+    void onTimeout();
+
+private:
+    struct Request
+    {
+        QByteArray frame;
+        int timeoutMs{3000};
+        std::shared_ptr<QPromise<QByteArray>> promise;
+        QElapsedTimer sentTimer;
+    };
+
+    Request makeRequest(const QByteArray& frame, int timeoutMs);
+    void pump();
+    void finish(Request& request, const QByteArray& response);
+    void failInFlight();
+    void armTimeout();
+
+    TcpClient* m_client{nullptr};
+    QTimer* m_timeoutTimer{nullptr};
+
+    // 提交方与工作线程共享
+    mutable QMutex m_queueMutex;
+    std::deque<Request> m_queues[2];
+    int m_pipelineDepth{4};
+
+    // 仅在工作线程访问
+    std::deque<Request> m_inFlight;
+    std::atomic_int m_inFlightCount{0};
+};
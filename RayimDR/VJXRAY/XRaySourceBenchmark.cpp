@@ -0,0 +1,185 @@
+#include "XRaySourceBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QMutex>
+#include <QThread>
+
+#include "IXS120BP120P366.h"
+#include "XRaySourceEmulator.h"
+#include "../Components/XGlobal.h"
+
+namespace
+{
+XRaySourceBenchmark::Stats computeStats(std::vector<double> samples)
+{
+    XRaySourceBenchmark::Stats stats;
+    if (samples.empty())
+    {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    stats.count = static_cast<int>(samples.size());
+    stats.minMs = samples.front();
+    stats.maxMs = samples.back();
+    stats.p95Ms = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+
+    double sum = 0.0;
+    for (double v : samples)
+        sum += v;
+    stats.meanMs = sum / samples.size();
+
+    double var = 0.0;
+    for (double v : samples)
+        var += (v - stats.meanMs) * (v - stats.meanMs);
+    stats.stdDevMs = std::sqrt(var / samples.size());
+    return stats;
+}
+
+QString formatStats(const XRaySourceBenchmark::Stats& stats)
+{
+    return QString("n=%1 min=%2 mean=%3 p95=%4 max=%5 std=%6 ms")
+        .arg(stats.count)
+        .arg(stats.minMs, 0, 'f', 2)
+        .arg(stats.meanMs, 0, 'f', 2)
+        .arg(stats.p95Ms, 0, 'f', 2)
+        .arg(stats.maxMs, 0, 'f', 2)
+        .arg(stats.stdDevMs, 0, 'f', 2);
+}
+}  // namespace
+
+XRaySourceBenchmark::Options XRaySourceBenchmark::Options::fromConfig()
+{
+    Options options;
+    options.iterations = std::max(1, xGlobal.getInt("TEST", "XRAY_BENCHMARK_ITERATIONS", options.iterations));
+    options.pollSeconds = std::max(1, xGlobal.getInt("TEST", "XRAY_BENCHMARK_POLL_SECONDS", options.pollSeconds));
+    return options;
+}
+
+QString XRaySourceBenchmark::Result::summary() const
+{
+    if (!ok)
+    {
+        return QString("射线源通信测试失败: %1").arg(error);
+    }
+
+    QString text = QString("命令往返: %1\n流水线吞吐: %2 条/秒\n状态轮询间隔: %3")
+                       .arg(formatStats(roundTrip))
+                       .arg(pipelinedPerSec, 0, 'f', 1)
+                       .arg(formatStats(pollInterval));
+    if (reconnectMs >= 0.0)
+    {
+        text += QString("\n断线检测: %1 ms, 重连: %2 ms").arg(disconnectDetectMs, 0, 'f', 1).arg(reconnectMs, 0, 'f', 1);
+    }
+    return text;
+}
+
+XRaySourceBenchmark::Result XRaySourceBenchmark::run(XRaySourceEmulator* emulator, const Options& options)
+{
+    Result result;
+    auto& source = IXS120BP120P366::Instance();
+    if (!source.isConnected())
+    {
+        result.error = "射线源未连接";
+        return result;
+    }
+
+    const int minVoltage = xGlobal.getInt("XRAY", "XRAY_MIN_VOLTAGE");
+    const int minCurrent = xGlobal.getInt("XRAY", "XRAY_MIN_CURRENT");
+
+    // 1. 单条命令往返延迟
+    qDebug() << "[Benchmark] Measuring command round-trip," << options.iterations << "iterations";
+    std::vector<double> roundTrips;
+    roundTrips.reserve(options.iterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < options.iterations; ++i)
+    {
+        timer.start();
+        if (!source.setVoltage(minVoltage + (i & 1)))
+        {
+            result.error = QString("第 %1 条命令无应答").arg(i + 1);
+            return result;
+        }
+        roundTrips.push_back(timer.nsecsElapsed() / 1e6);
+    }
+    result.roundTrip = computeStats(std::move(roundTrips));
+
+    // 2. 流水线连续下发
+    qDebug() << "[Benchmark] Measuring pipelined throughput";
+    std::vector<QFuture<bool>> futures;
+    futures.reserve(options.iterations);
+    timer.start();
+    for (int i = 0; i < options.iterations; ++i)
+    {
+        futures.push_back(source.setCurrentAsync(minCurrent + (i & 1) * 10));
+    }
+    int succeeded = 0;
+    for (auto& future : futures)
+    {
+        future.waitForFinished();
+        if (future.resultCount() > 0 && future.result())
+            ++succeeded;
+    }
+    const double elapsedSec = timer.nsecsElapsed() / 1e9;
+    result.pipelinedPerSec = elapsedSec > 0.0 ? succeeded / elapsedSec : 0.0;
+
+    // 3. 状态轮询抖动
+    qDebug() << "[Benchmark] Measuring status poll interval for" << options.pollSeconds << "s";
+    QMutex mutex;
+    std::vector<double> stamps;
+    QElapsedTimer pollClock;
+    pollClock.start();
+    auto connection = QObject::connect(&source, &IXS120BP120P366::statusPolled,
+                                       [&]()
+                                       {
+                                           QMutexLocker locker(&mutex);
+                                           stamps.push_back(pollClock.nsecsElapsed() / 1e6);
+                                       });
+    QThread::msleep(options.pollSeconds * 1000);
+    QObject::disconnect(connection);
+    {
+        QMutexLocker locker(&mutex);
+        std::vector<double> intervals;
+        for (size_t i = 1; i < stamps.size(); ++i)
+        {
+            intervals.push_back(stamps[i] - stamps[i - 1]);
+        }
+        result.pollInterval = computeStats(std::move(intervals));
+    }
+
+    // 4. 断线检测与重连
+    if (emulator && emulator->port() != 0)
+    {
+        qDebug() << "[Benchmark] Measuring disconnect detection and reconnect";
+        timer.start();
+        emulator->dropClients();
+        while (source.isConnected() && timer.elapsed() < 5000)
+        {
+            QThread::msleep(1);
+        }
+        if (source.isConnected())
+        {
+            result.error = "模拟器断开后未检测到断线";
+            return result;
+        }
+        result.disconnectDetectMs = timer.nsecsElapsed() / 1e6;
+
+        timer.start();
+        if (!source.connectToSource("127.0.0.1", emulator->port()))
+        {
+            result.error = "重连模拟器失败";
+            return result;
+        }
+        result.reconnectMs = timer.nsecsElapsed() / 1e6;
+    }
+
+    result.ok = true;
+    qDebug().noquote() << "[Benchmark]" << result.summary();
+    return result;
+}
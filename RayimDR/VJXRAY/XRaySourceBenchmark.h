@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QString>
+
+class XRaySourceEmulator;
+
+/**
+ * @brief 射线源通信基准测试
+ *
+ * 通过 IXS120BP120P366 对模拟器（或真实射线源）测量：
+ * - 单条命令往返延迟（逐条同步发送）
+ * - 流水线连续下发的吞吐量
+ * - 状态轮询间隔抖动
+ * - 断线检测与重连耗时（需要模拟器主动断开）
+ *
+ * run() 会阻塞等待结果，不能在 GUI 线程或射线源工作线程中调用。
+ */
+class XRaySourceBenchmark
+{
+public:
+    struct Options
+    {
+        int iterations{200};
+        int pollSeconds{10};
+
+        static Options fromConfig();
+    };
+
+    struct Stats
+    {
+        int count{0};
+        double minMs{0.0};
+        double meanMs{0.0};
+        double p95Ms{0.0};
+        double maxMs{0.0};
+        double stdDevMs{0.0};
+    };
+
+    struct Result
+    {
+        bool ok{false};
+        QString error;
+        Stats roundTrip;
+        double pipelinedPerSec{0.0};
+        Stats pollInterval;
+        double disconnectDetectMs{-1.0};
+        double reconnectMs{-1.0};
+
+        QString summary() const;
+    };
+
+    // emulator 为空时跳过重连测试
+    static Result run(XRaySourceEmulator* emulator, const Options& options = Options::fromConfig());
+};
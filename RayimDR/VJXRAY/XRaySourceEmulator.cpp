@@ -0,0 +1,355 @@
+#include "XRaySourceEmulator.h"
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QMetaObject>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "XFrameParser.h"
+#include "../Components/XGlobal.h"
+
+namespace
+{
+constexpr char FRAME_STX = 0x02;
+constexpr char FRAME_END = 0x0D;
+
+QByteArray makeFrame(const QByteArray& payload)
+{
+    QByteArray frame;
+    frame.reserve(payload.size() + 2);
+    frame.append(FRAME_STX);
+    frame.append(payload);
+    frame.append(FRAME_END);
+    return frame;
+}
+
+double approach(double value, double target, double maxStep)
+{
+    if (value < target)
+        return std::min(target, value + maxStep);
+    return std::max(target, value - maxStep);
+}
+}  // namespace
+
+XRaySourceEmulator::Config XRaySourceEmulator::Config::fromConfig()
+{
+    Config config;
+    config.responseDelayMs = xGlobal.getInt("TEST", "XRAY_EMULATOR_DELAY_MS", config.responseDelayMs);
+    config.jitterMs = xGlobal.getInt("TEST", "XRAY_EMULATOR_JITTER_MS", config.jitterMs);
+    config.rampKvPerSec = xGlobal.getDouble("TEST", "XRAY_EMULATOR_RAMP_KV_PER_S", config.rampKvPerSec);
+    config.rampUaPerSec = xGlobal.getDouble("TEST", "XRAY_EMULATOR_RAMP_UA_PER_S", config.rampUaPerSec);
+    config.ptst = xGlobal.getInt("TEST", "XRAY_EMULATOR_PTST", config.ptst);
+    config.faultBit = xGlobal.getInt("TEST", "XRAY_EMULATOR_FAULT_BIT", config.faultBit);
+    config.faultAfterMs = xGlobal.getInt("TEST", "XRAY_EMULATOR_FAULT_AFTER_MS", config.faultAfterMs);
+    return config;
+}
+
+XRaySourceEmulator::XRaySourceEmulator(const Config& config, QObject* parent) : QObject(parent), m_config(config)
+{
+    m_thread.setObjectName("XRaySourceEmulator");
+    m_thread.start();
+    moveToThread(&m_thread);
+
+    QMetaObject::invokeMethod(
+        this,
+        [this]()
+        {
+            m_clock.start();
+            m_server = new QTcpServer(this);
+            connect(m_server, &QTcpServer::newConnection, this, &XRaySourceEmulator::onNewConnection);
+        },
+        Qt::BlockingQueuedConnection);
+}
+
+XRaySourceEmulator::~XRaySourceEmulator()
+{
+    stop();
+    QMetaObject::invokeMethod(
+        this,
+        [this]()
+        {
+            delete m_server;
+            m_server = nullptr;
+        },
+        Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool XRaySourceEmulator::start(quint16 port)
+{
+    bool result = false;
+    QMetaObject::invokeMethod(
+        this,
+        [this, port, &result]()
+        {
+            if (m_server->isListening())
+            {
+                result = true;
+                return;
+            }
+
+            result = m_server->listen(QHostAddress::LocalHost, port);
+            if (result)
+            {
+                m_port.store(m_server->serverPort());
+                qDebug() << "[Emulator] Listening on 127.0.0.1:" << m_port.load();
+            }
+            else
+            {
+                qDebug() << "[Emulator] Failed to listen:" << m_server->errorString();
+            }
+        },
+        Qt::BlockingQueuedConnection);
+    return result;
+}
+
+void XRaySourceEmulator::stop()
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this]()
+        {
+            if (m_server && m_server->isListening())
+            {
+                m_server->close();
+            }
+            for (auto& [socket, client] : m_clients)
+            {
+                socket->abort();
+                socket->deleteLater();
+            }
+            m_clients.clear();
+            m_port.store(0);
+        },
+        Qt::BlockingQueuedConnection);
+}
+
+quint16 XRaySourceEmulator::port() const
+{
+    return m_port.load();
+}
+
+void XRaySourceEmulator::injectFault(int bit)
+{
+    QMetaObject::invokeMethod(this, [this, bit]() { setFault(bit); }, Qt::QueuedConnection);
+}
+
+void XRaySourceEmulator::clearFaults()
+{
+    QMetaObject::invokeMethod(this, [this]() { m_faultBits.fill(0); }, Qt::QueuedConnection);
+}
+
+void XRaySourceEmulator::dropClients()
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this]()
+        {
+            qDebug() << "[Emulator] Dropping" << m_clients.size() << "client(s)";
+            for (auto& [socket, client] : m_clients)
+            {
+                socket->abort();
+                socket->deleteLater();
+            }
+            m_clients.clear();
+        },
+        Qt::QueuedConnection);
+}
+
+void XRaySourceEmulator::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection())
+    {
+        qDebug() << "[Emulator] Client connected:" << socket->peerAddress().toString() << socket->peerPort();
+
+        Client client;
+        client.parser = std::make_unique<XFrameParser>(FRAME_STX, FRAME_END);
+        m_clients.emplace(socket, std::move(client));
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onClientReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this,
+                [this, socket]()
+                {
+                    if (m_clients.erase(socket) > 0)
+                    {
+                        socket->deleteLater();
+                    }
+                });
+    }
+}
+
+void XRaySourceEmulator::onClientReadyRead(QTcpSocket* socket)
+{
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end())
+    {
+        return;
+    }
+    Client& client = it->second;
+
+    while (socket->bytesAvailable() > 0)
+    {
+        qsizetype available = 0;
+        char* buffer = client.parser->writePointer(available);
+        if (!buffer)
+        {
+            client.parser->reset();
+            continue;
+        }
+
+        qint64 read = socket->read(buffer, available);
+        if (read <= 0)
+        {
+            break;
+        }
+        client.parser->commit(read);
+
+        QByteArrayView frame;
+        while (client.parser->next(frame))
+        {
+            ++m_commandCount;
+            const QByteArray response = handleCommand(frame.sliced(1, frame.size() - 2));
+
+            // 应答按到期时间顺序发出，抖动不会打乱同一连接内的先后
+            const int jitter =
+                m_config.jitterMs > 0 ? QRandomGenerator::global()->bounded(m_config.jitterMs + 1) : 0;
+            const qint64 now = m_clock.elapsed();
+            const qint64 due = std::max(client.lastDueMs, now + m_config.responseDelayMs + jitter);
+            client.lastDueMs = due;
+
+            if (due <= now)
+            {
+                socket->write(response);
+            }
+            else
+            {
+                QTimer::singleShot(static_cast<int>(due - now), Qt::PreciseTimer, socket,
+                                   [socket, response]() { socket->write(response); });
+            }
+        }
+    }
+}
+
+QByteArray XRaySourceEmulator::handleCommand(QByteArrayView body)
+{
+    updateOutput();
+
+    if (body.startsWith("VP"))
+    {
+        m_targetKv10 = body.sliced(2).toInt();
+        return makeFrame(body.toByteArray());
+    }
+    if (body.startsWith("CP"))
+    {
+        // x.xxxx mA -> uA
+        m_targetUa = body.sliced(2).toInt() / 10;
+        return makeFrame(body.toByteArray());
+    }
+    if (body == "ENBL1")
+    {
+        if (std::none_of(m_faultBits.begin(), m_faultBits.end(), [](int bit) { return bit != 0; }))
+        {
+            m_enabled = true;
+            m_enabledAtMs = m_clock.elapsed();
+        }
+        return makeFrame(body.toByteArray());
+    }
+    if (body == "ENBL0")
+    {
+        m_enabled = false;
+        return makeFrame(body.toByteArray());
+    }
+    if (body == "CLR")
+    {
+        m_faultBits.fill(0);
+        return makeFrame(body.toByteArray());
+    }
+    if (body == "STAT")
+    {
+        return makeFrame(m_enabled ? "1" : "0");
+    }
+    if (body == "PTST")
+    {
+        return makeFrame(QByteArray::number(m_config.ptst));
+    }
+    if (body == "MON")
+    {
+        // vvvv ccccc tttt ffff bbbb
+        const QString mon = QString("%1 %2 %3 %4 %5")
+                                .arg(qRound(m_outputKv * 10), 4, 10, QChar('0'))
+                                .arg(qRound(m_outputUa * 10), 5, 10, QChar('0'))
+                                .arg(qRound(m_temperature * 10), 4, 10, QChar('0'))
+                                .arg(m_enabled ? 2500 : 0, 4, 10, QChar('0'))
+                                .arg(qRound(m_config.vdc * 100), 4, 10, QChar('0'));
+        return makeFrame(mon.toLatin1());
+    }
+    if (body == "FLT")
+    {
+        QByteArray flt;
+        for (size_t i = 0; i < m_faultBits.size(); ++i)
+        {
+            if (i > 0)
+                flt.append(' ');
+            flt.append(char('0' + m_faultBits[i]));
+        }
+        return makeFrame(flt);
+    }
+    if (body == "MNUM")
+    {
+        return makeFrame("IXS120BP120P366");
+    }
+    if (body == "SNUM")
+    {
+        return makeFrame("EMULATOR");
+    }
+
+    qDebug() << "[Emulator] Unknown command:" << body.toByteArray();
+    return makeFrame("ERR");
+}
+
+void XRaySourceEmulator::updateOutput()
+{
+    const qint64 now = m_clock.elapsed();
+    const double dt = (now - m_lastUpdateMs) / 1000.0;
+    m_lastUpdateMs = now;
+
+    if (m_enabled && m_config.faultBit >= 0 && m_config.faultAfterMs > 0 &&
+        now - m_enabledAtMs >= m_config.faultAfterMs)
+    {
+        setFault(m_config.faultBit);
+    }
+
+    if (m_enabled)
+    {
+        m_outputKv = approach(m_outputKv, m_targetKv10 / 10.0, m_config.rampKvPerSec * dt);
+        m_outputUa = approach(m_outputUa, m_targetUa, m_config.rampUaPerSec * dt);
+        m_temperature = std::min(60.0, m_temperature + 0.05 * dt);
+    }
+    else
+    {
+        m_outputKv = 0.0;
+        m_outputUa = 0.0;
+        m_temperature = std::max(25.0, m_temperature - 0.02 * dt);
+    }
+}
+
+void XRaySourceEmulator::setFault(int bit)
+{
+    if (bit < 0 || bit >= static_cast<int>(m_faultBits.size()))
+    {
+        return;
+    }
+
+    qDebug() << "[Emulator] Fault injected, bit" << bit;
+    m_faultBits[bit] = 1;
+    // 真实射线源出现故障时会关闭高压
+    m_enabled = false;
+    m_outputKv = 0.0;
+    m_outputUa = 0.0;
+}
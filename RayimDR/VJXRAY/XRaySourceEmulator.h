@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+
+#include <QObject>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QByteArrayView>
+
+class QTcpServer;
+class QTcpSocket;
+class XFrameParser;
+
+/**
+ * @brief 本地射线源模拟器，实现 STX/CR 命令协议
+ *
+ * 支持 VP、CP、ENBL、CLR、MON、FLT、STAT、PTST、MNUM、SNUM，用于无硬件时验证 IXS120BP120P366
+ * 的协议处理与延迟：
+ * - 每条应答按 responseDelayMs + 随机抖动延迟发出，同一连接内保持顺序
+ * - 开启射线后输出电压 / 电流按设定速率爬升到目标值
+ * - 可在开启后定时或随时注入故障位，故障时关闭射线；可主动断开客户端以测试重连
+ *
+ * 模拟器运行在独立线程中，公有接口均可在任意线程调用。
+ */
+class XRaySourceEmulator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        int responseDelayMs{5};
+        int jitterMs{2};
+        double rampKvPerSec{20.0};
+        double rampUaPerSec{500.0};
+        int ptst{3};          // 预警时间 (s)
+        int faultBit{-1};     // 开启射线 faultAfterMs 后注入的故障位，-1 表示不注入
+        int faultAfterMs{0};
+        double vdc{24.0};
+
+        static Config fromConfig();
+    };
+
+    explicit XRaySourceEmulator(const Config& config = Config::fromConfig(), QObject* parent = nullptr);
+    ~XRaySourceEmulator();
+
+    // 在 127.0.0.1:port 上监听，port 为 0 时自动分配
+    bool start(quint16 port);
+    void stop();
+    quint16 port() const;
+
+    void injectFault(int bit);
+    void clearFaults();
+    // 断开所有客户端连接
+    void dropClients();
+
+    quint64 commandCount() const { return m_commandCount.load(); }
+
+private:
+    struct Client
+    {
+        std::unique_ptr<XFrameParser> parser;
+        qint64 lastDueMs{0};
+    };
+
+    void onNewConnection();
+    void onClientReadyRead(QTcpSocket* socket);
+    QByteArray handleCommand(QByteArrayView body);
+    void updateOutput();
+    void setFault(int bit);
+
+    Config m_config;
+    QThread m_thread;
+    QTcpServer* m_server{nullptr};
+    std::map<QTcpSocket*, Client> m_clients;
+    std::atomic<quint16> m_port{0};
+    std::atomic<quint64> m_commandCount{0};
+
+    // 以下仅在模拟器线程访问
+    QElapsedTimer m_clock;
+    qint64 m_lastUpdateMs{0};
+    qint64 m_enabledAtMs{0};
+    bool m_enabled{false};
+    int m_targetKv10{0};  // 0.1 kV
+    int m_targetUa{0};
+    double m_outputKv{0.0};
+    double m_outputUa{0.0};
+    double m_temperature{25.0};
+    std::array<int, 11> m_faultBits{};
+};
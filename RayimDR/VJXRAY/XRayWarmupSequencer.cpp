@@ -0,0 +1,304 @@
+#include "XRayWarmupSequencer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QDebug>
+#include <QMetaObject>
+#include <QStringList>
+#include <QTimer>
+
+#include "IXS120BP120P366.h"
+#include "../Components/XGlobal.h"
+
+namespace
+{
+const QList<XRayWarmupSequencer::Step> DEFAULT_STEPS = {
+    {30, 200}, {40, 289}, {50, 378}, {60, 467}, {70, 556}, {80, 644}, {90, 733}, {100, 822}, {110, 911}, {120, 1000},
+};
+}  // namespace
+
+QList<XRayWarmupSequencer::Step> XRayWarmupSequencer::loadSteps()
+{
+    const QString text = xGlobal.getString("PREHEAT", "PREHEAT_STEPS");
+    if (text.trimmed().isEmpty())
+    {
+        return DEFAULT_STEPS;
+    }
+
+    QList<Step> steps;
+    for (const QString& item : text.split(',', Qt::SkipEmptyParts))
+    {
+        const QStringList pair = item.trimmed().split(':');
+        bool okV = false;
+        bool okC = false;
+        Step step;
+        if (pair.size() == 2)
+        {
+            step.voltage = pair[0].trimmed().toInt(&okV);
+            step.current = pair[1].trimmed().toInt(&okC);
+        }
+        if (!okV || !okC)
+        {
+            qWarning() << "[Preheat] Invalid PREHEAT_STEPS entry:" << item << ", using built-in table";
+            return DEFAULT_STEPS;
+        }
+        steps.append(step);
+    }
+    return steps.isEmpty() ? DEFAULT_STEPS : steps;
+}
+
+int XRayWarmupSequencer::holdSecondsForLevel(int level)
+{
+    const QStringList holds = xGlobal.getString("PREHEAT", "PREHEAT_HOLD_S", "3,6,30").split(',', Qt::SkipEmptyParts);
+    const int defaults[] = {3, 6, 30};
+    if (level >= 0 && level < holds.size())
+    {
+        bool ok = false;
+        const int seconds = holds[level].trimmed().toInt(&ok);
+        if (ok && seconds >= 0)
+            return seconds;
+    }
+    return defaults[std::clamp(level, 0, 2)];
+}
+
+XRayWarmupSequencer::XRayWarmupSequencer(QObject* parent) : QObject(parent)
+{
+    m_tickTimer = new QTimer(this);
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_tickTimer, &QTimer::timeout, this, &XRayWarmupSequencer::onTick);
+}
+
+XRayWarmupSequencer::~XRayWarmupSequencer() {}
+
+bool XRayWarmupSequencer::isRunning() const
+{
+    const State state = m_state.load();
+    return state == State::Settling || state == State::Holding || state == State::Paused;
+}
+
+void XRayWarmupSequencer::start(const QList<Step>& steps, int holdSeconds)
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this, steps, holdSeconds]()
+        {
+            if (isRunning() || steps.isEmpty())
+            {
+                return;
+            }
+
+            m_steps = steps;
+            m_records.clear();
+            m_holdMs = holdSeconds * 1000;
+            m_voltageTolerance = xGlobal.getDouble("PREHEAT", "PREHEAT_VOLTAGE_TOLERANCE", 1.0);
+            m_currentTolerance = xGlobal.getDouble("PREHEAT", "PREHEAT_CURRENT_TOLERANCE", 10.0);
+            m_settleTimeoutMs = xGlobal.getInt("PREHEAT", "PREHEAT_SETTLE_TIMEOUT_S", 30) * 1000LL;
+            m_clock.start();
+            m_lastTickMs = 0;
+
+            qDebug() << "[Preheat] Starting," << m_steps.size() << "steps, hold" << holdSeconds << "s per step";
+            xRaySource.setIsPreheat(true);
+
+            enterStep(0);
+            xRaySource.startXRayAsync().then(this,
+                                             [this](bool ok)
+                                             {
+                                                 if (!ok && isRunning())
+                                                 {
+                                                     finish(State::Failed, "训管失败：射线源开启失败");
+                                                 }
+                                             });
+            m_tickTimer->start(std::max(10, xGlobal.getInt("PREHEAT", "PREHEAT_TICK_MS", 100)));
+        },
+        Qt::QueuedConnection);
+}
+
+void XRayWarmupSequencer::pause()
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this]()
+        {
+            const State state = m_state.load();
+            if (state == State::Settling || state == State::Holding)
+            {
+                qDebug() << "[Preheat] Paused at step" << m_stepIndex + 1;
+                m_pausedFrom = state;
+                setState(State::Paused);
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+void XRayWarmupSequencer::resume()
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this]()
+        {
+            if (m_state.load() != State::Paused)
+            {
+                return;
+            }
+
+            qDebug() << "[Preheat] Resumed at step" << m_stepIndex + 1;
+            // 暂停期间不计入稳定超时
+            if (m_pausedFrom == State::Settling)
+            {
+                m_settleStartMs = m_clock.elapsed();
+            }
+            m_lastTickMs = m_clock.elapsed();
+            setState(m_pausedFrom);
+        },
+        Qt::QueuedConnection);
+}
+
+void XRayWarmupSequencer::abort()
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this]()
+        {
+            if (isRunning())
+            {
+                finish(State::Aborted, "训管已取消");
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+void XRayWarmupSequencer::onTick()
+{
+    const qint64 now = m_clock.elapsed();
+    const qint64 dt = now - m_lastTickMs;
+    m_lastTickMs = now;
+
+    const State state = m_state.load();
+    if (state == State::Paused || !isRunning())
+    {
+        return;
+    }
+
+    if (!xRaySource.isConnected())
+    {
+        finish(State::Failed, "训管失败：射线源连接断开");
+        return;
+    }
+
+    const XRaySourceStatus status = xRaySource.getCurrentStatus();
+    if (std::any_of(status.faultBits.begin(), status.faultBits.end(), [](int bit) { return bit != 0; }))
+    {
+        finish(State::Failed, "训管失败：射线源报告故障");
+        return;
+    }
+
+    StepRecord& record = m_records[m_stepIndex];
+    const double voltage = status.voltage;
+    const double current = status.current * 1000.0;
+    record.achievedVoltage = voltage;
+    record.achievedCurrent = current;
+
+    if (state == State::Settling)
+    {
+        const bool settled = std::abs(voltage - record.target.voltage) <= m_voltageTolerance &&
+                             std::abs(current - record.target.current) <= m_currentTolerance;
+        if (settled)
+        {
+            record.settledMs = now;
+            m_holdElapsedMs = 0;
+            qDebug() << "[Preheat] Step" << m_stepIndex + 1 << "settled after" << now - record.commandedMs << "ms";
+            setState(State::Holding);
+        }
+        else if (now - m_settleStartMs > m_settleTimeoutMs)
+        {
+            finish(State::Failed, QString("训管失败：第 %1 步 %2kV / %3uA 未能稳定 (实际 %4kV / %5uA)")
+                                      .arg(m_stepIndex + 1)
+                                      .arg(record.target.voltage)
+                                      .arg(record.target.current)
+                                      .arg(voltage, 0, 'f', 1)
+                                      .arg(current, 0, 'f', 0));
+        }
+        return;
+    }
+
+    m_holdElapsedMs += dt;
+    if (m_holdElapsedMs < m_holdMs)
+    {
+        return;
+    }
+
+    record.finishedMs = now;
+    if (m_stepIndex + 1 >= m_steps.size())
+    {
+        finish(State::Finished, "训管结束");
+    }
+    else
+    {
+        enterStep(m_stepIndex + 1);
+    }
+}
+
+void XRayWarmupSequencer::enterStep(int index)
+{
+    m_stepIndex = index;
+    const Step step = m_steps.at(index);
+
+    StepRecord record;
+    record.target = step;
+    record.commandedMs = m_clock.elapsed();
+    m_records.append(record);
+    m_settleStartMs = record.commandedMs;
+
+    qDebug() << "[Preheat] Step" << index + 1 << "/" << m_steps.size() << "-" << step.voltage << "kV," << step.current
+             << "uA";
+
+    auto onCommandDone = [this](bool ok)
+    {
+        if (!ok && isRunning())
+        {
+            finish(State::Failed, "训管失败：设定电压 / 电流无应答");
+        }
+    };
+    xRaySource.setVoltageAsync(step.voltage).then(this, onCommandDone);
+    xRaySource.setCurrentAsync(step.current).then(this, onCommandDone);
+
+    setState(State::Settling);
+    emit stepChanged(index, m_steps.size(), step.voltage, step.current);
+}
+
+void XRayWarmupSequencer::finish(State state, const QString& message)
+{
+    m_tickTimer->stop();
+    xRaySource.stopXRayAsync();
+    xRaySource.setIsPreheat(false);
+
+    setState(state);
+    qDebug() << "[Preheat]" << message << "- elapsed" << m_clock.elapsed() << "ms";
+    logRecords();
+    emit finished(state == State::Finished, message);
+}
+
+void XRayWarmupSequencer::setState(State state)
+{
+    if (m_state.exchange(state) != state)
+    {
+        emit stateChanged(state);
+    }
+}
+
+void XRayWarmupSequencer::logRecords() const
+{
+    for (int i = 0; i < m_records.size(); ++i)
+    {
+        const StepRecord& r = m_records[i];
+        qDebug().noquote() << QString("[Preheat] Step %1: target %2kV/%3uA, achieved %4kV/%5uA, settle %6 ms, total %7 ms")
+                                  .arg(i + 1)
+                                  .arg(r.target.voltage)
+                                  .arg(r.target.current)
+                                  .arg(r.achievedVoltage, 0, 'f', 1)
+                                  .arg(r.achievedCurrent, 0, 'f', 0)
+                                  .arg(r.settledMs >= 0 ? r.settledMs - r.commandedMs : -1)
+                                  .arg(r.finishedMs >= 0 ? r.finishedMs - r.commandedMs : -1);
+    }
+}
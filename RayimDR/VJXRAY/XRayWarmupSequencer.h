@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+
+#include <QObject>
+#include <QList>
+#include <QElapsedTimer>
+
+class QTimer;
+
+/**
+ * @brief 射线管训管（预热）时序控制
+ *
+ * 按配置中的电压 / 电流步骤表逐级升高，由射线源工作线程上的定时器驱动状态机：
+ * 下发设定值 -> 等待 MON 读数进入容差（稳定） -> 保持 holdSeconds -> 下一步，
+ * 保持时间从读数稳定时开始计算，不再用固定延时覆盖爬升与 PTST。
+ *
+ * 可随时暂停（保持当前步骤出束，暂停保持计时）或中止（立即关闭射线），
+ * 每一步的下发、稳定、结束时刻与实际到达的电压 / 电流都会记录下来。
+ *
+ * 对象创建后需移动到射线源工作线程，公有接口可在任意线程调用。
+ */
+class XRayWarmupSequencer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class State
+    {
+        Idle,
+        Settling,
+        Holding,
+        Paused,
+        Finished,
+        Aborted,
+        Failed,
+    };
+    Q_ENUM(State)
+
+    struct Step
+    {
+        int voltage{0};  // kV
+        int current{0};  // uA
+    };
+
+    struct StepRecord
+    {
+        Step target;
+        qint64 commandedMs{-1};  // 相对训管开始
+        qint64 settledMs{-1};
+        qint64 finishedMs{-1};
+        double achievedVoltage{0.0};  // kV
+        double achievedCurrent{0.0};  // uA
+    };
+
+    // 从 [PREHEAT] PREHEAT_STEPS 读取步骤表，格式 "kV:uA,kV:uA,..."，缺省或格式错误时使用内置表
+    static QList<Step> loadSteps();
+    // 训管档位对应的每步保持时间 (s)，来自 PREHEAT_HOLD_S
+    static int holdSecondsForLevel(int level);
+
+    explicit XRayWarmupSequencer(QObject* parent = nullptr);
+    ~XRayWarmupSequencer();
+
+    void start(const QList<Step>& steps, int holdSeconds);
+    void pause();
+    void resume();
+    void abort();
+
+    State state() const { return m_state.load(); }
+    bool isRunning() const;
+    // 仅在结束后读取
+    QList<StepRecord> records() const { return m_records; }
+
+signals:
+    void stateChanged(XRayWarmupSequencer::State state);
+    void stepChanged(int index, int count, int voltage, int current);
+    void finished(bool success, const QString& message);
+
+private:
+    void onTick();
+    void enterStep(int index);
+    void finish(State state, const QString& message);
+    void setState(State state);
+    void logRecords() const;
+
+    QTimer* m_tickTimer{nullptr};
+    std::atomic<State> m_state{State::Idle};
+    State m_pausedFrom{State::Idle};
+
+    // 以下仅在射线源工作线程访问
+    QList<Step> m_steps;
+    QList<StepRecord> m_records;
+    int m_stepIndex{-1};
+    int m_holdMs{0};
+    qint64 m_holdElapsedMs{0};  // 当前步骤已累计的保持时间（不含暂停）
+    qint64 m_lastTickMs{0};
+    qint64 m_settleStartMs{0};  // 稳定超时的计时起点，暂停恢复后重新开始，不改动 commandedMs
+    double m_voltageTolerance{1.0};
+    double m_currentTolerance{10.0};
+    qint64 m_settleTimeoutMs{30000};
+    QElapsedTimer m_clock;
+};
@@ -0,0 +1,394 @@
+#include "XBatchProcessor.h"
+
+#include <qcollator.h>
+#include <qdebug.h>
+#include <qdir.h>
+#include <qdiriterator.h>
+#include <qelapsedtimer.h>
+#include <qfileinfo.h>
+#include <qmap.h>
+#include <qmutex.h>
+#include <qregularexpression.h>
+#include <qthread.h>
+#include <qthreadpool.h>
+
+#include <algorithm>
+
+#include "Components/XGlobal.h"
+#include "ImageRender/XFlatFieldCorrector.h"
+#include "ImageRender/XImageHelper.h"
+#include "IRayDetector/TiffHelper.h"
+
+namespace
+{
+struct Job
+{
+    QStringList files;
+    QString outputBase;  // 不含扩展名的输出路径
+};
+
+struct JobOutcome
+{
+    bool ok{false};
+    bool skipped{false};
+    QString error;
+    int inputFiles{0};
+    int outputFiles{0};
+    qint64 inputBytes{0};
+    qint64 outputBytes{0};
+    qint64 pixels{0};
+};
+
+QString formatSuffix(XBatchProcessor::Format format, int width, int height)
+{
+    switch (format)
+    {
+        case XBatchProcessor::Format::Raw:
+            return QString("_%1x%2.raw").arg(width).arg(height);
+        case XBatchProcessor::Format::Png16:
+            return ".png";
+        case XBatchProcessor::Format::Png8:
+            return "_8bit.png";
+        case XBatchProcessor::Format::Tiff:
+        default:
+            return ".tif";
+    }
+}
+
+// RAW 的输出尺寸在处理前未知，按尺寸通配
+bool outputExists(const QString& outputBase, XBatchProcessor::Format format)
+{
+    if (format != XBatchProcessor::Format::Raw)
+    {
+        return QFileInfo::exists(outputBase + formatSuffix(format, 0, 0));
+    }
+    const QFileInfo info(outputBase);
+    return !info.dir().entryList({info.fileName() + "_*x*.raw"}, QDir::Files).isEmpty();
+}
+
+// 按目录分组、数字序排序后切成作业；不足 stack 个的尾组照常叠加
+QVector<Job> collectJobs(const XBatchProcessor::Options& options)
+{
+    const QDir root(options.inputDir);
+    QMap<QString, QStringList> byDir;
+    QDirIterator it(options.inputDir, {"*.raw", "*.tif", "*.tiff"}, QDir::Files,
+                    options.recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+    while (it.hasNext())
+    {
+        const QString path = it.next();
+        byDir[QFileInfo(path).absolutePath()].append(path);
+    }
+
+    QCollator collator;
+    collator.setNumericMode(true);
+    static const QRegularExpression sizeTag("_\\d+x\\d+$");
+
+    QVector<Job> jobs;
+    const int stack = std::max(1, options.stack);
+    for (const QString& dirPath : byDir.keys())
+    {
+        QStringList files = byDir.value(dirPath);
+        std::sort(files.begin(), files.end(), collator);
+        const QString outDir = QDir(options.outputDir).filePath(root.relativeFilePath(dirPath));
+        for (int i = 0; i < files.size(); i += stack)
+        {
+            Job job;
+            job.files = files.mid(i, stack);
+            // RAW 文件名中的尺寸标记按输出尺寸重新生成
+            QString stem = QFileInfo(job.files.first()).completeBaseName();
+            stem.remove(sizeTag);
+            if (job.files.size() > 1)
+            {
+                stem += QString("_stack%1").arg(job.files.size());
+            }
+            job.outputBase = QDir(outDir).filePath(stem);
+            jobs.append(job);
+        }
+    }
+    return jobs;
+}
+
+JobOutcome processJob(const Job& job, const XBatchProcessor::Options& options, int rawWidth, int rawHeight)
+{
+    JobOutcome outcome;
+
+    if (!options.overwrite && std::all_of(options.formats.begin(), options.formats.end(),
+                                          [&](XBatchProcessor::Format format)
+                                          { return outputExists(job.outputBase, format); }))
+    {
+        outcome.ok = true;
+        outcome.skipped = true;
+        return outcome;
+    }
+
+    QVector<QImage> frames;
+    for (const QString& file : job.files)
+    {
+        QImage frame = XImageHelper::openImageFile(file, rawWidth, rawHeight);
+        if (frame.isNull())
+        {
+            outcome.error = QString("无法读取 %1").arg(file);
+            return outcome;
+        }
+        if (frame.format() != QImage::Format_Grayscale16)
+        {
+            frame = frame.convertToFormat(QImage::Format_Grayscale16);
+        }
+        outcome.inputBytes += QFileInfo(file).size();
+        outcome.pixels += static_cast<qint64>(frame.width()) * frame.height();
+        frames.append(frame);
+    }
+    outcome.inputFiles = frames.size();
+
+    QImage image = frames.first();
+    if (frames.size() > 1)
+    {
+        QVector<const QImage*> pointers;
+        for (const QImage& frame : frames)
+        {
+            if (frame.size() != image.size())
+            {
+                outcome.error = QString("叠加的文件尺寸不一致: %1").arg(job.files.join(", "));
+                return outcome;
+            }
+            pointers.append(&frame);
+        }
+        image = XImageStacker::stack(pointers, options.stackOptions);
+        if (image.isNull())
+        {
+            outcome.error = QString("叠加失败: %1").arg(job.files.first());
+            return outcome;
+        }
+    }
+    frames.clear();
+
+    if (options.correct && !XFlatFieldCorrector::Instance().apply(image))
+    {
+        outcome.error = QString("校正失败, 模板与图像尺寸不一致: %1").arg(job.files.first());
+        return outcome;
+    }
+
+    image = XImageHelper::transformImage(image, options.rotate, options.flipH, options.flipV);
+    if (image.isNull())
+    {
+        outcome.error = QString("旋转翻转失败: %1").arg(job.files.first());
+        return outcome;
+    }
+
+    if (!QDir().mkpath(QFileInfo(job.outputBase).absolutePath()))
+    {
+        outcome.error = QString("无法创建输出目录 %1").arg(QFileInfo(job.outputBase).absolutePath());
+        return outcome;
+    }
+
+    for (XBatchProcessor::Format format : options.formats)
+    {
+        const QString path = job.outputBase + formatSuffix(format, image.width(), image.height());
+        bool written = false;
+        switch (format)
+        {
+            case XBatchProcessor::Format::Tiff:
+                TiffHelper::SaveImage(image, path.toStdString());
+                written = QFileInfo::exists(path);
+                break;
+            case XBatchProcessor::Format::Raw:
+                written = XImageHelper::saveImageU16Raw(image, path);
+                break;
+            case XBatchProcessor::Format::Png16:
+                written = XImageHelper::saveImagePNG(image, path);
+                break;
+            case XBatchProcessor::Format::Png8:
+            {
+                int width = options.window;
+                int level = options.level;
+                if (width <= 0)
+                {
+                    int max = -1;
+                    int min = -1;
+                    XImageHelper::calculateMaxMinValue(image, max, min);
+                    XImageHelper::calculateWLAdvanced(max, min, width, level, options.wlMode);
+                }
+                written = XImageHelper::saveImagePNG(XImageHelper::adjustWL(image, width, level), path);
+                break;
+            }
+        }
+        if (!written)
+        {
+            outcome.error = QString("写入失败 %1").arg(path);
+            return outcome;
+        }
+        outcome.outputBytes += QFileInfo(path).size();
+        ++outcome.outputFiles;
+    }
+
+    outcome.ok = true;
+    return outcome;
+}
+}  // namespace
+
+bool XBatchProcessor::parseFormats(const QString& text, QVector<Format>& formats)
+{
+    formats.clear();
+    for (const QString& item : text.split(',', Qt::SkipEmptyParts))
+    {
+        const QString name = item.trimmed().toLower();
+        Format format;
+        if (name == "tiff" || name == "tif")
+            format = Format::Tiff;
+        else if (name == "raw")
+            format = Format::Raw;
+        else if (name == "png16")
+            format = Format::Png16;
+        else if (name == "png8" || name == "png")
+            format = Format::Png8;
+        else
+            return false;
+        if (!formats.contains(format))
+            formats.append(format);
+    }
+    return !formats.isEmpty();
+}
+
+bool XBatchProcessor::parseStackMethod(const QString& text, XImageStacker::Method& method)
+{
+    const QString name = text.trimmed().toLower();
+    if (name == "mean")
+        method = XImageStacker::Method::Mean;
+    else if (name == "median")
+        method = XImageStacker::Method::Median;
+    else if (name == "sigma")
+        method = XImageStacker::Method::SigmaClip;
+    else
+        return false;
+    return true;
+}
+
+QString XBatchProcessor::Result::summary() const
+{
+    if (!ok)
+    {
+        return QString("批处理失败: %1").arg(error);
+    }
+
+    const double sec = std::max(totalSec, 1e-3);
+    return QString("作业 %1 个: 成功 %2, 跳过 %3, 失败 %4 | 读入 %5 个文件 %6 MB, 写出 %7 个文件 %8 MB | "
+                   "耗时 %9 s, %10 文件/s, %11 MPixels/s, 读 %12 MB/s")
+        .arg(jobs)
+        .arg(succeeded)
+        .arg(skipped)
+        .arg(failed)
+        .arg(inputFiles)
+        .arg(inputBytes / 1048576.0, 0, 'f', 1)
+        .arg(outputFiles)
+        .arg(outputBytes / 1048576.0, 0, 'f', 1)
+        .arg(totalSec, 0, 'f', 1)
+        .arg(inputFiles / sec, 0, 'f', 2)
+        .arg(pixels / sec / 1e6, 0, 'f', 1)
+        .arg(inputBytes / 1048576.0 / sec, 0, 'f', 1);
+}
+
+XBatchProcessor::Result XBatchProcessor::run(const Options& options, const ProgressFn& progress)
+{
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+
+    auto fail = [&](const QString& error)
+    {
+        result.error = error;
+        qCritical() << "[批处理]" << error;
+        return result;
+    };
+
+    if (!QFileInfo(options.inputDir).isDir())
+    {
+        return fail(QString("输入目录不存在: %1").arg(options.inputDir));
+    }
+    if (options.outputDir.isEmpty() || !QDir().mkpath(options.outputDir))
+    {
+        return fail(QString("无法创建输出目录: %1").arg(options.outputDir));
+    }
+    // RAW 输出按尺寸通配判断是否已存在，与输入同目录时会把输入当作输出
+    if (QDir(options.inputDir).absolutePath() == QDir(options.outputDir).absolutePath())
+    {
+        return fail("输出目录不能与输入目录相同");
+    }
+    if (options.formats.isEmpty())
+    {
+        return fail("未指定输出格式");
+    }
+    if (options.rotate % 90 != 0)
+    {
+        return fail(QString("旋转角度须为 90 的整数倍: %1").arg(options.rotate));
+    }
+
+    const int rawWidth = options.rawWidth > 0 ? options.rawWidth : xGlobal.getInt("DET", "DET_WIDTH_1X1");
+    const int rawHeight = options.rawHeight > 0 ? options.rawHeight : xGlobal.getInt("DET", "DET_HEIGHT_1X1");
+
+    if (options.correct)
+    {
+        const QString dir = options.templateDir.isEmpty() ? XFlatFieldCorrector::templateDir() : options.templateDir;
+        if (!XFlatFieldCorrector::Instance().loadTemplates(dir) || !XFlatFieldCorrector::Instance().hasOffset())
+        {
+            return fail(QString("无法加载校正模板: %1").arg(dir));
+        }
+        qInfo() << "[批处理] 校正模板:" << dir << "," << XFlatFieldCorrector::Instance().defectSummary();
+    }
+
+    const QVector<Job> jobs = collectJobs(options);
+    result.jobs = jobs.size();
+    if (jobs.isEmpty())
+    {
+        return fail(QString("输入目录中没有 RAW / TIFF 文件: %1").arg(options.inputDir));
+    }
+
+    const int threads = options.jobs > 0 ? options.jobs : QThread::idealThreadCount();
+    qInfo() << "[批处理]" << jobs.size() << "个作业, 并发" << threads << ", 叠加" << std::max(1, options.stack)
+            << "张 (" << XImageStacker::methodName(options.stackOptions.method) << "), RAW 尺寸" << rawWidth << "x"
+            << rawHeight;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    QMutex mutex;
+    int done = 0;
+    for (const Job& job : jobs)
+    {
+        pool.start(
+            [&, job]()
+            {
+                const JobOutcome outcome = processJob(job, options, rawWidth, rawHeight);
+
+                QMutexLocker locker(&mutex);
+                ++done;
+                result.inputFiles += outcome.inputFiles;
+                result.outputFiles += outcome.outputFiles;
+                result.inputBytes += outcome.inputBytes;
+                result.outputBytes += outcome.outputBytes;
+                result.pixels += outcome.pixels;
+                if (outcome.skipped)
+                {
+                    ++result.skipped;
+                }
+                else if (outcome.ok)
+                {
+                    ++result.succeeded;
+                }
+                else
+                {
+                    ++result.failed;
+                    result.errors.append(outcome.error);
+                    qWarning() << "[批处理]" << outcome.error;
+                }
+                if (progress)
+                {
+                    progress(done, jobs.size(), job.outputBase, outcome.ok);
+                }
+            });
+    }
+    pool.waitForDone();
+
+    result.ok = true;
+    result.totalSec = timer.nsecsElapsed() / 1e9;
+    qInfo() << "[批处理]" << result.summary();
+    return result;
+}
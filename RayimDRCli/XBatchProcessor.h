@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvector.h>
+
+#include "ImageRender/XImageStacker.h"
+
+/**
+ * @brief 归档 RAW / TIFF 数据的离线批处理
+ *
+ * 按目录收集输入文件（数字序自然排序），每 stack 个连续文件为一个作业：
+ * 读入 → 叠加（XImageStacker）→ 平场 / 坏点校正（XFlatFieldCorrector）→ 旋转翻转（XImageHelper::transformImage）
+ * → 按 formats 写出 16 位 TIFF / RAW / PNG 或窗宽窗位后的 8 位 PNG。
+ * 处理顺序与采集流程一致：校正模板为探测器方向，因此先校正再旋转翻转；平场校正是线性运算，叠加后校正一次即可。
+ *
+ * 作业在独立线程池中并发执行，jobs 控制同时处理的作业数；单个作业内的叠加与窗宽窗位仍由 XTileExecutor 按行块并行，
+ * 因此 jobs 不必等于核数，主要用于让文件读写与计算重叠。输出目录保持输入的子目录结构。
+ */
+class XBatchProcessor
+{
+public:
+    enum class Format
+    {
+        Tiff = 0,
+        Raw,
+        Png16,
+        Png8
+    };
+
+    struct Options
+    {
+        QString inputDir;
+        QString outputDir;
+        bool recursive{false};
+        int rawWidth{0};  // RAW 输入尺寸，0 表示取 [DET] DET_WIDTH_1X1 / DET_HEIGHT_1X1
+        int rawHeight{0};
+
+        int stack{1};  // 每个作业叠加的连续文件数，1 表示逐个转换
+        XImageStacker::Options stackOptions;
+
+        bool correct{false};
+        QString templateDir;  // 为空时取 XFlatFieldCorrector::templateDir()
+
+        int rotate{0};  // 顺时针，90 的整数倍
+        bool flipH{false};
+        bool flipV{false};
+
+        QVector<Format> formats{Format::Tiff};
+        int window{0};  // 8 位导出的窗宽 / 窗位，window 为 0 时逐张自动计算
+        int level{0};
+        int wlMode{2};  // 自动窗宽窗位的算法，见 XImageHelper::calculateWLAdvanced
+
+        int jobs{0};  // 0 表示 QThread::idealThreadCount()
+        bool overwrite{false};
+    };
+
+    struct Result
+    {
+        bool ok{false};
+        QString error;
+        int jobs{0};       // 作业总数
+        int succeeded{0};
+        int skipped{0};    // 输出已存在且未指定 overwrite
+        int failed{0};
+        int inputFiles{0};
+        int outputFiles{0};
+        qint64 inputBytes{0};
+        qint64 outputBytes{0};
+        qint64 pixels{0};  // 已处理的输入像素数
+        double totalSec{0.0};
+        QStringList errors;
+
+        QString summary() const;
+    };
+
+    // 每完成一个作业调用一次，可能来自任意工作线程，调用已串行化
+    using ProgressFn = std::function<void(int done, int total, const QString& item, bool ok)>;
+
+    static Result run(const Options& options, const ProgressFn& progress = ProgressFn());
+
+    // 逗号分隔的 tiff / raw / png16 / png8
+    static bool parseFormats(const QString& text, QVector<Format>& formats);
+    static bool parseStackMethod(const QString& text, XImageStacker::Method& method);
+};
@@ -0,0 +1,170 @@
+#include <qcoreapplication.h>
+#include <qcommandlineparser.h>
+#include <qdebug.h>
+#include <qelapsedtimer.h>
+#include <qtextstream.h>
+
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include "Components/XGlobal.h"
+#include "XBatchProcessor.h"
+
+namespace
+{
+bool verboseLog = false;
+
+// 共用的图像代码按 GUI 习惯逐张输出调试日志，命令行默认只保留警告及以上
+void messageHandler(QtMsgType type, const QMessageLogContext&, const QString& msg)
+{
+    if (!verboseLog && (type == QtDebugMsg || type == QtInfoMsg))
+    {
+        return;
+    }
+    std::fprintf(stderr, "%s\n", msg.toUtf8().constData());
+    std::fflush(stderr);
+}
+
+int exitWithUsage(QCommandLineParser& parser, const QString& error)
+{
+    std::fprintf(stderr, "%s\n\n%s", error.toUtf8().constData(), parser.helpText().toUtf8().constData());
+    return 2;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("RayimDRCli");
+    qInstallMessageHandler(messageHandler);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "RayimDR 离线批处理：RAW / TIFF 格式转换、叠加、平场校正、旋转翻转与窗宽窗位导出");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "输入目录");
+    parser.addPositionalArgument("output", "输出目录，保持输入的子目录结构");
+
+    const QCommandLineOption recursiveOption({"r", "recursive"}, "包含子目录");
+    const QCommandLineOption widthOption("width", "RAW 宽度，默认取 [DET] DET_WIDTH_1X1", "px");
+    const QCommandLineOption heightOption("height", "RAW 高度，默认取 [DET] DET_HEIGHT_1X1", "px");
+    const QCommandLineOption stackOption("stack", "每 N 个连续文件叠加为一幅，默认 1", "N", "1");
+    const QCommandLineOption methodOption("stack-method",
+                                          "叠加方式 mean / median / sigma，默认取 [SYSTEM] STACK_METHOD", "method");
+    const QCommandLineOption kappaOption("kappa", "sigma 裁剪阈值，默认取 [SYSTEM] STACK_SIGMA_KAPPA", "k");
+    const QCommandLineOption correctOption("correct", "应用平场 / 坏点校正模板");
+    const QCommandLineOption templateOption("templates", "校正模板目录，默认为程序目录下的模板目录", "dir");
+    const QCommandLineOption rotateOption("rotate", "顺时针旋转 0 / 90 / 180 / 270", "deg", "0");
+    const QCommandLineOption flipHOption("flip-h", "水平翻转");
+    const QCommandLineOption flipVOption("flip-v", "垂直翻转");
+    const QCommandLineOption orientOption("orient-from-config",
+                                          "按 [SYSTEM] IMG_ROTATE / FLIP_HORIZONTAL / FLIP_VERTICAL 旋转翻转");
+    const QCommandLineOption formatOption("format", "输出格式，逗号分隔: tiff, raw, png16, png8，默认 tiff", "list",
+                                          "tiff");
+    const QCommandLineOption windowOption("window", "png8 的窗宽，不指定时逐张自动计算", "W");
+    const QCommandLineOption levelOption("level", "png8 的窗位", "L");
+    const QCommandLineOption wlModeOption("wl-mode", "自动窗宽窗位: 0 全范围, 1 85%, 2 中间 50%（默认）", "mode", "2");
+    const QCommandLineOption jobsOption("jobs", "同时处理的作业数，默认为逻辑核数", "N", "0");
+    const QCommandLineOption overwriteOption("overwrite", "覆盖已存在的输出，默认跳过");
+    const QCommandLineOption verboseOption({"v", "verbose"}, "输出全部调试日志");
+    for (const QCommandLineOption& option :
+         {recursiveOption, widthOption, heightOption, stackOption, methodOption, kappaOption, correctOption,
+          templateOption, rotateOption, flipHOption, flipVOption, orientOption, formatOption, windowOption, levelOption,
+          wlModeOption, jobsOption, overwriteOption, verboseOption})
+    {
+        parser.addOption(option);
+    }
+    parser.process(app);
+    verboseLog = parser.isSet(verboseOption);
+
+    const QStringList positional = parser.positionalArguments();
+    if (positional.size() != 2)
+    {
+        return exitWithUsage(parser, "需要指定输入目录与输出目录");
+    }
+
+    // 配置文件与 GUI 共用，缺失时按内置默认值处理
+    if (!xGlobal.init())
+    {
+        qWarning() << "[批处理] 未能加载程序目录下的 config.ini, 使用默认参数";
+    }
+
+    XBatchProcessor::Options options;
+    options.inputDir = positional[0];
+    options.outputDir = positional[1];
+    options.recursive = parser.isSet(recursiveOption);
+    options.rawWidth = parser.value(widthOption).toInt();
+    options.rawHeight = parser.value(heightOption).toInt();
+    options.stack = parser.value(stackOption).toInt();
+    options.stackOptions = XImageStacker::Options::fromConfig();
+    if (parser.isSet(methodOption) &&
+        !XBatchProcessor::parseStackMethod(parser.value(methodOption), options.stackOptions.method))
+    {
+        return exitWithUsage(parser, QString("未知的叠加方式: %1").arg(parser.value(methodOption)));
+    }
+    if (parser.isSet(kappaOption))
+    {
+        options.stackOptions.kappa = std::clamp(parser.value(kappaOption).toDouble(), 1.0, 10.0);
+    }
+    options.correct = parser.isSet(correctOption) || parser.isSet(templateOption);
+    options.templateDir = parser.value(templateOption);
+
+    if (parser.isSet(orientOption))
+    {
+        options.rotate = xGlobal.getInt("SYSTEM", "IMG_ROTATE");
+        options.flipH = xGlobal.getBool("SYSTEM", "FLIP_HORIZONTAL");
+        options.flipV = xGlobal.getBool("SYSTEM", "FLIP_VERTICAL");
+    }
+    if (parser.isSet(rotateOption))
+    {
+        options.rotate = parser.value(rotateOption).toInt();
+    }
+    options.flipH = options.flipH || parser.isSet(flipHOption);
+    options.flipV = options.flipV || parser.isSet(flipVOption);
+
+    if (!XBatchProcessor::parseFormats(parser.value(formatOption), options.formats))
+    {
+        return exitWithUsage(parser, QString("无法识别的输出格式: %1").arg(parser.value(formatOption)));
+    }
+    options.window = parser.value(windowOption).toInt();
+    options.level = parser.value(levelOption).toInt();
+    options.wlMode = parser.value(wlModeOption).toInt();
+    options.jobs = parser.value(jobsOption).toInt();
+    options.overwrite = parser.isSet(overwriteOption);
+
+    QTextStream out(stdout);
+    QElapsedTimer timer;
+    timer.start();
+    const XBatchProcessor::Result result = XBatchProcessor::run(
+        options,
+        [&](int done, int total, const QString& item, bool ok)
+        {
+            const double sec = (std::max)(timer.nsecsElapsed() / 1e9, 1e-3);
+            out << QString("[%1/%2] %3 %4 (%5 作业/s)")
+                       .arg(done)
+                       .arg(total)
+                       .arg(ok ? "完成" : "失败")
+                       .arg(item)
+                       .arg(done / sec, 0, 'f', 2)
+                << Qt::endl;
+        });
+
+    if (!result.ok)
+    {
+        std::fprintf(stderr, "%s\n", result.summary().toUtf8().constData());
+        return 2;
+    }
+
+    out << result.summary() << Qt::endl;
+    for (const QString& error : result.errors)
+        out << "  " << error << Qt::endl;
+    return result.failed > 0 ? 1 : 0;
+}